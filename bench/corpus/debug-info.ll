@@ -0,0 +1,415 @@
+; Straight-line code with a source location on every instruction.
+
+target datalayout = "e-p:32:32-i64:64-v16:16-v32:32-n16:32:64"
+target triple = "spir-unknown-unknown"
+
+define void @debug_info(i32 addrspace(1)* %out) !dbg !4 {
+entry:
+  %lid = call i32 @get_local_id(i32 0), !dbg !10
+  %a0 = add i32 %lid, 0, !dbg !11
+  call void @llvm.dbg.value(metadata i32 %a0, metadata !75, metadata !DIExpression()), !dbg !11
+  %o0 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a0, !dbg !11
+  store i32 %lid, i32 addrspace(1)* %o0, align 4, !dbg !11
+  %a1 = add i32 %a0, 1, !dbg !12
+  call void @llvm.dbg.value(metadata i32 %a1, metadata !76, metadata !DIExpression()), !dbg !12
+  %o1 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a1, !dbg !12
+  store i32 %a0, i32 addrspace(1)* %o1, align 4, !dbg !12
+  %a2 = add i32 %a1, 2, !dbg !13
+  call void @llvm.dbg.value(metadata i32 %a2, metadata !77, metadata !DIExpression()), !dbg !13
+  %o2 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a2, !dbg !13
+  store i32 %a1, i32 addrspace(1)* %o2, align 4, !dbg !13
+  %a3 = add i32 %a2, 3, !dbg !14
+  call void @llvm.dbg.value(metadata i32 %a3, metadata !78, metadata !DIExpression()), !dbg !14
+  %o3 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a3, !dbg !14
+  store i32 %a2, i32 addrspace(1)* %o3, align 4, !dbg !14
+  %a4 = add i32 %a3, 4, !dbg !15
+  call void @llvm.dbg.value(metadata i32 %a4, metadata !79, metadata !DIExpression()), !dbg !15
+  %o4 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a4, !dbg !15
+  store i32 %a3, i32 addrspace(1)* %o4, align 4, !dbg !15
+  %a5 = add i32 %a4, 5, !dbg !16
+  call void @llvm.dbg.value(metadata i32 %a5, metadata !80, metadata !DIExpression()), !dbg !16
+  %o5 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a5, !dbg !16
+  store i32 %a4, i32 addrspace(1)* %o5, align 4, !dbg !16
+  %a6 = add i32 %a5, 6, !dbg !17
+  call void @llvm.dbg.value(metadata i32 %a6, metadata !81, metadata !DIExpression()), !dbg !17
+  %o6 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a6, !dbg !17
+  store i32 %a5, i32 addrspace(1)* %o6, align 4, !dbg !17
+  %a7 = add i32 %a6, 7, !dbg !18
+  call void @llvm.dbg.value(metadata i32 %a7, metadata !82, metadata !DIExpression()), !dbg !18
+  %o7 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a7, !dbg !18
+  store i32 %a6, i32 addrspace(1)* %o7, align 4, !dbg !18
+  %a8 = add i32 %a7, 8, !dbg !19
+  call void @llvm.dbg.value(metadata i32 %a8, metadata !83, metadata !DIExpression()), !dbg !19
+  %o8 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a8, !dbg !19
+  store i32 %a7, i32 addrspace(1)* %o8, align 4, !dbg !19
+  %a9 = add i32 %a8, 9, !dbg !20
+  call void @llvm.dbg.value(metadata i32 %a9, metadata !84, metadata !DIExpression()), !dbg !20
+  %o9 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a9, !dbg !20
+  store i32 %a8, i32 addrspace(1)* %o9, align 4, !dbg !20
+  %a10 = add i32 %a9, 10, !dbg !21
+  call void @llvm.dbg.value(metadata i32 %a10, metadata !85, metadata !DIExpression()), !dbg !21
+  %o10 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a10, !dbg !21
+  store i32 %a9, i32 addrspace(1)* %o10, align 4, !dbg !21
+  %a11 = add i32 %a10, 11, !dbg !22
+  call void @llvm.dbg.value(metadata i32 %a11, metadata !86, metadata !DIExpression()), !dbg !22
+  %o11 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a11, !dbg !22
+  store i32 %a10, i32 addrspace(1)* %o11, align 4, !dbg !22
+  %a12 = add i32 %a11, 12, !dbg !23
+  call void @llvm.dbg.value(metadata i32 %a12, metadata !87, metadata !DIExpression()), !dbg !23
+  %o12 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a12, !dbg !23
+  store i32 %a11, i32 addrspace(1)* %o12, align 4, !dbg !23
+  %a13 = add i32 %a12, 13, !dbg !24
+  call void @llvm.dbg.value(metadata i32 %a13, metadata !88, metadata !DIExpression()), !dbg !24
+  %o13 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a13, !dbg !24
+  store i32 %a12, i32 addrspace(1)* %o13, align 4, !dbg !24
+  %a14 = add i32 %a13, 14, !dbg !25
+  call void @llvm.dbg.value(metadata i32 %a14, metadata !89, metadata !DIExpression()), !dbg !25
+  %o14 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a14, !dbg !25
+  store i32 %a13, i32 addrspace(1)* %o14, align 4, !dbg !25
+  %a15 = add i32 %a14, 15, !dbg !26
+  call void @llvm.dbg.value(metadata i32 %a15, metadata !90, metadata !DIExpression()), !dbg !26
+  %o15 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a15, !dbg !26
+  store i32 %a14, i32 addrspace(1)* %o15, align 4, !dbg !26
+  %a16 = add i32 %a15, 16, !dbg !27
+  call void @llvm.dbg.value(metadata i32 %a16, metadata !91, metadata !DIExpression()), !dbg !27
+  %o16 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a16, !dbg !27
+  store i32 %a15, i32 addrspace(1)* %o16, align 4, !dbg !27
+  %a17 = add i32 %a16, 17, !dbg !28
+  call void @llvm.dbg.value(metadata i32 %a17, metadata !92, metadata !DIExpression()), !dbg !28
+  %o17 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a17, !dbg !28
+  store i32 %a16, i32 addrspace(1)* %o17, align 4, !dbg !28
+  %a18 = add i32 %a17, 18, !dbg !29
+  call void @llvm.dbg.value(metadata i32 %a18, metadata !93, metadata !DIExpression()), !dbg !29
+  %o18 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a18, !dbg !29
+  store i32 %a17, i32 addrspace(1)* %o18, align 4, !dbg !29
+  %a19 = add i32 %a18, 19, !dbg !30
+  call void @llvm.dbg.value(metadata i32 %a19, metadata !94, metadata !DIExpression()), !dbg !30
+  %o19 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a19, !dbg !30
+  store i32 %a18, i32 addrspace(1)* %o19, align 4, !dbg !30
+  %a20 = add i32 %a19, 20, !dbg !31
+  call void @llvm.dbg.value(metadata i32 %a20, metadata !95, metadata !DIExpression()), !dbg !31
+  %o20 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a20, !dbg !31
+  store i32 %a19, i32 addrspace(1)* %o20, align 4, !dbg !31
+  %a21 = add i32 %a20, 21, !dbg !32
+  call void @llvm.dbg.value(metadata i32 %a21, metadata !96, metadata !DIExpression()), !dbg !32
+  %o21 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a21, !dbg !32
+  store i32 %a20, i32 addrspace(1)* %o21, align 4, !dbg !32
+  %a22 = add i32 %a21, 22, !dbg !33
+  call void @llvm.dbg.value(metadata i32 %a22, metadata !97, metadata !DIExpression()), !dbg !33
+  %o22 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a22, !dbg !33
+  store i32 %a21, i32 addrspace(1)* %o22, align 4, !dbg !33
+  %a23 = add i32 %a22, 23, !dbg !34
+  call void @llvm.dbg.value(metadata i32 %a23, metadata !98, metadata !DIExpression()), !dbg !34
+  %o23 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a23, !dbg !34
+  store i32 %a22, i32 addrspace(1)* %o23, align 4, !dbg !34
+  %a24 = add i32 %a23, 24, !dbg !35
+  call void @llvm.dbg.value(metadata i32 %a24, metadata !99, metadata !DIExpression()), !dbg !35
+  %o24 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a24, !dbg !35
+  store i32 %a23, i32 addrspace(1)* %o24, align 4, !dbg !35
+  %a25 = add i32 %a24, 25, !dbg !36
+  call void @llvm.dbg.value(metadata i32 %a25, metadata !100, metadata !DIExpression()), !dbg !36
+  %o25 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a25, !dbg !36
+  store i32 %a24, i32 addrspace(1)* %o25, align 4, !dbg !36
+  %a26 = add i32 %a25, 26, !dbg !37
+  call void @llvm.dbg.value(metadata i32 %a26, metadata !101, metadata !DIExpression()), !dbg !37
+  %o26 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a26, !dbg !37
+  store i32 %a25, i32 addrspace(1)* %o26, align 4, !dbg !37
+  %a27 = add i32 %a26, 27, !dbg !38
+  call void @llvm.dbg.value(metadata i32 %a27, metadata !102, metadata !DIExpression()), !dbg !38
+  %o27 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a27, !dbg !38
+  store i32 %a26, i32 addrspace(1)* %o27, align 4, !dbg !38
+  %a28 = add i32 %a27, 28, !dbg !39
+  call void @llvm.dbg.value(metadata i32 %a28, metadata !103, metadata !DIExpression()), !dbg !39
+  %o28 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a28, !dbg !39
+  store i32 %a27, i32 addrspace(1)* %o28, align 4, !dbg !39
+  %a29 = add i32 %a28, 29, !dbg !40
+  call void @llvm.dbg.value(metadata i32 %a29, metadata !104, metadata !DIExpression()), !dbg !40
+  %o29 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a29, !dbg !40
+  store i32 %a28, i32 addrspace(1)* %o29, align 4, !dbg !40
+  %a30 = add i32 %a29, 30, !dbg !41
+  call void @llvm.dbg.value(metadata i32 %a30, metadata !105, metadata !DIExpression()), !dbg !41
+  %o30 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a30, !dbg !41
+  store i32 %a29, i32 addrspace(1)* %o30, align 4, !dbg !41
+  %a31 = add i32 %a30, 31, !dbg !42
+  call void @llvm.dbg.value(metadata i32 %a31, metadata !106, metadata !DIExpression()), !dbg !42
+  %o31 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a31, !dbg !42
+  store i32 %a30, i32 addrspace(1)* %o31, align 4, !dbg !42
+  %a32 = add i32 %a31, 32, !dbg !43
+  call void @llvm.dbg.value(metadata i32 %a32, metadata !107, metadata !DIExpression()), !dbg !43
+  %o32 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a32, !dbg !43
+  store i32 %a31, i32 addrspace(1)* %o32, align 4, !dbg !43
+  %a33 = add i32 %a32, 33, !dbg !44
+  call void @llvm.dbg.value(metadata i32 %a33, metadata !108, metadata !DIExpression()), !dbg !44
+  %o33 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a33, !dbg !44
+  store i32 %a32, i32 addrspace(1)* %o33, align 4, !dbg !44
+  %a34 = add i32 %a33, 34, !dbg !45
+  call void @llvm.dbg.value(metadata i32 %a34, metadata !109, metadata !DIExpression()), !dbg !45
+  %o34 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a34, !dbg !45
+  store i32 %a33, i32 addrspace(1)* %o34, align 4, !dbg !45
+  %a35 = add i32 %a34, 35, !dbg !46
+  call void @llvm.dbg.value(metadata i32 %a35, metadata !110, metadata !DIExpression()), !dbg !46
+  %o35 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a35, !dbg !46
+  store i32 %a34, i32 addrspace(1)* %o35, align 4, !dbg !46
+  %a36 = add i32 %a35, 36, !dbg !47
+  call void @llvm.dbg.value(metadata i32 %a36, metadata !111, metadata !DIExpression()), !dbg !47
+  %o36 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a36, !dbg !47
+  store i32 %a35, i32 addrspace(1)* %o36, align 4, !dbg !47
+  %a37 = add i32 %a36, 37, !dbg !48
+  call void @llvm.dbg.value(metadata i32 %a37, metadata !112, metadata !DIExpression()), !dbg !48
+  %o37 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a37, !dbg !48
+  store i32 %a36, i32 addrspace(1)* %o37, align 4, !dbg !48
+  %a38 = add i32 %a37, 38, !dbg !49
+  call void @llvm.dbg.value(metadata i32 %a38, metadata !113, metadata !DIExpression()), !dbg !49
+  %o38 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a38, !dbg !49
+  store i32 %a37, i32 addrspace(1)* %o38, align 4, !dbg !49
+  %a39 = add i32 %a38, 39, !dbg !50
+  call void @llvm.dbg.value(metadata i32 %a39, metadata !114, metadata !DIExpression()), !dbg !50
+  %o39 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a39, !dbg !50
+  store i32 %a38, i32 addrspace(1)* %o39, align 4, !dbg !50
+  %a40 = add i32 %a39, 40, !dbg !51
+  call void @llvm.dbg.value(metadata i32 %a40, metadata !115, metadata !DIExpression()), !dbg !51
+  %o40 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a40, !dbg !51
+  store i32 %a39, i32 addrspace(1)* %o40, align 4, !dbg !51
+  %a41 = add i32 %a40, 41, !dbg !52
+  call void @llvm.dbg.value(metadata i32 %a41, metadata !116, metadata !DIExpression()), !dbg !52
+  %o41 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a41, !dbg !52
+  store i32 %a40, i32 addrspace(1)* %o41, align 4, !dbg !52
+  %a42 = add i32 %a41, 42, !dbg !53
+  call void @llvm.dbg.value(metadata i32 %a42, metadata !117, metadata !DIExpression()), !dbg !53
+  %o42 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a42, !dbg !53
+  store i32 %a41, i32 addrspace(1)* %o42, align 4, !dbg !53
+  %a43 = add i32 %a42, 43, !dbg !54
+  call void @llvm.dbg.value(metadata i32 %a43, metadata !118, metadata !DIExpression()), !dbg !54
+  %o43 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a43, !dbg !54
+  store i32 %a42, i32 addrspace(1)* %o43, align 4, !dbg !54
+  %a44 = add i32 %a43, 44, !dbg !55
+  call void @llvm.dbg.value(metadata i32 %a44, metadata !119, metadata !DIExpression()), !dbg !55
+  %o44 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a44, !dbg !55
+  store i32 %a43, i32 addrspace(1)* %o44, align 4, !dbg !55
+  %a45 = add i32 %a44, 45, !dbg !56
+  call void @llvm.dbg.value(metadata i32 %a45, metadata !120, metadata !DIExpression()), !dbg !56
+  %o45 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a45, !dbg !56
+  store i32 %a44, i32 addrspace(1)* %o45, align 4, !dbg !56
+  %a46 = add i32 %a45, 46, !dbg !57
+  call void @llvm.dbg.value(metadata i32 %a46, metadata !121, metadata !DIExpression()), !dbg !57
+  %o46 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a46, !dbg !57
+  store i32 %a45, i32 addrspace(1)* %o46, align 4, !dbg !57
+  %a47 = add i32 %a46, 47, !dbg !58
+  call void @llvm.dbg.value(metadata i32 %a47, metadata !122, metadata !DIExpression()), !dbg !58
+  %o47 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a47, !dbg !58
+  store i32 %a46, i32 addrspace(1)* %o47, align 4, !dbg !58
+  %a48 = add i32 %a47, 48, !dbg !59
+  call void @llvm.dbg.value(metadata i32 %a48, metadata !123, metadata !DIExpression()), !dbg !59
+  %o48 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a48, !dbg !59
+  store i32 %a47, i32 addrspace(1)* %o48, align 4, !dbg !59
+  %a49 = add i32 %a48, 49, !dbg !60
+  call void @llvm.dbg.value(metadata i32 %a49, metadata !124, metadata !DIExpression()), !dbg !60
+  %o49 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a49, !dbg !60
+  store i32 %a48, i32 addrspace(1)* %o49, align 4, !dbg !60
+  %a50 = add i32 %a49, 50, !dbg !61
+  call void @llvm.dbg.value(metadata i32 %a50, metadata !125, metadata !DIExpression()), !dbg !61
+  %o50 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a50, !dbg !61
+  store i32 %a49, i32 addrspace(1)* %o50, align 4, !dbg !61
+  %a51 = add i32 %a50, 51, !dbg !62
+  call void @llvm.dbg.value(metadata i32 %a51, metadata !126, metadata !DIExpression()), !dbg !62
+  %o51 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a51, !dbg !62
+  store i32 %a50, i32 addrspace(1)* %o51, align 4, !dbg !62
+  %a52 = add i32 %a51, 52, !dbg !63
+  call void @llvm.dbg.value(metadata i32 %a52, metadata !127, metadata !DIExpression()), !dbg !63
+  %o52 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a52, !dbg !63
+  store i32 %a51, i32 addrspace(1)* %o52, align 4, !dbg !63
+  %a53 = add i32 %a52, 53, !dbg !64
+  call void @llvm.dbg.value(metadata i32 %a53, metadata !128, metadata !DIExpression()), !dbg !64
+  %o53 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a53, !dbg !64
+  store i32 %a52, i32 addrspace(1)* %o53, align 4, !dbg !64
+  %a54 = add i32 %a53, 54, !dbg !65
+  call void @llvm.dbg.value(metadata i32 %a54, metadata !129, metadata !DIExpression()), !dbg !65
+  %o54 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a54, !dbg !65
+  store i32 %a53, i32 addrspace(1)* %o54, align 4, !dbg !65
+  %a55 = add i32 %a54, 55, !dbg !66
+  call void @llvm.dbg.value(metadata i32 %a55, metadata !130, metadata !DIExpression()), !dbg !66
+  %o55 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a55, !dbg !66
+  store i32 %a54, i32 addrspace(1)* %o55, align 4, !dbg !66
+  %a56 = add i32 %a55, 56, !dbg !67
+  call void @llvm.dbg.value(metadata i32 %a56, metadata !131, metadata !DIExpression()), !dbg !67
+  %o56 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a56, !dbg !67
+  store i32 %a55, i32 addrspace(1)* %o56, align 4, !dbg !67
+  %a57 = add i32 %a56, 57, !dbg !68
+  call void @llvm.dbg.value(metadata i32 %a57, metadata !132, metadata !DIExpression()), !dbg !68
+  %o57 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a57, !dbg !68
+  store i32 %a56, i32 addrspace(1)* %o57, align 4, !dbg !68
+  %a58 = add i32 %a57, 58, !dbg !69
+  call void @llvm.dbg.value(metadata i32 %a58, metadata !133, metadata !DIExpression()), !dbg !69
+  %o58 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a58, !dbg !69
+  store i32 %a57, i32 addrspace(1)* %o58, align 4, !dbg !69
+  %a59 = add i32 %a58, 59, !dbg !70
+  call void @llvm.dbg.value(metadata i32 %a59, metadata !134, metadata !DIExpression()), !dbg !70
+  %o59 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a59, !dbg !70
+  store i32 %a58, i32 addrspace(1)* %o59, align 4, !dbg !70
+  %a60 = add i32 %a59, 60, !dbg !71
+  call void @llvm.dbg.value(metadata i32 %a60, metadata !135, metadata !DIExpression()), !dbg !71
+  %o60 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a60, !dbg !71
+  store i32 %a59, i32 addrspace(1)* %o60, align 4, !dbg !71
+  %a61 = add i32 %a60, 61, !dbg !72
+  call void @llvm.dbg.value(metadata i32 %a61, metadata !136, metadata !DIExpression()), !dbg !72
+  %o61 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a61, !dbg !72
+  store i32 %a60, i32 addrspace(1)* %o61, align 4, !dbg !72
+  %a62 = add i32 %a61, 62, !dbg !73
+  call void @llvm.dbg.value(metadata i32 %a62, metadata !137, metadata !DIExpression()), !dbg !73
+  %o62 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a62, !dbg !73
+  store i32 %a61, i32 addrspace(1)* %o62, align 4, !dbg !73
+  %a63 = add i32 %a62, 63, !dbg !74
+  call void @llvm.dbg.value(metadata i32 %a63, metadata !138, metadata !DIExpression()), !dbg !74
+  %o63 = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %a63, !dbg !74
+  store i32 %a62, i32 addrspace(1)* %o63, align 4, !dbg !74
+  ret void, !dbg !139
+}
+
+declare i32 @get_local_id(i32)
+
+declare void @llvm.dbg.value(metadata, metadata, metadata)
+
+!llvm.dbg.cu = !{!0}
+!llvm.module.flags = !{!2, !3}
+!opencl.kernels = !{!9}
+
+!0 = distinct !DICompileUnit(language: DW_LANG_C99, file: !1, producer: "clang", isOptimized: false, runtimeVersion: 0, emissionKind: FullDebug)
+!1 = !DIFile(filename: "debug-info.cl", directory: "/tmp")
+!2 = !{i32 2, !"Dwarf Version", i32 4}
+!3 = !{i32 2, !"Debug Info Version", i32 3}
+!4 = distinct !DISubprogram(name: "debug_info", scope: !1, file: !1, line: 1, type: !5, isLocal: false, isDefinition: true, scopeLine: 1, flags: DIFlagPrototyped, isOptimized: false, unit: !0)
+!5 = !DISubroutineType(types: !6)
+!6 = !{null, !7}
+!7 = !DIDerivedType(tag: DW_TAG_pointer_type, baseType: !8, size: 32)
+!8 = !DIBasicType(name: "int", size: 32, encoding: DW_ATE_signed)
+!9 = !{void (i32 addrspace(1)*)* @debug_info}
+!10 = !DILocation(line: 2, column: 13, scope: !4)
+!11 = !DILocation(line: 3, column: 5, scope: !4)
+!12 = !DILocation(line: 4, column: 5, scope: !4)
+!13 = !DILocation(line: 5, column: 5, scope: !4)
+!14 = !DILocation(line: 6, column: 5, scope: !4)
+!15 = !DILocation(line: 7, column: 5, scope: !4)
+!16 = !DILocation(line: 8, column: 5, scope: !4)
+!17 = !DILocation(line: 9, column: 5, scope: !4)
+!18 = !DILocation(line: 10, column: 5, scope: !4)
+!19 = !DILocation(line: 11, column: 5, scope: !4)
+!20 = !DILocation(line: 12, column: 5, scope: !4)
+!21 = !DILocation(line: 13, column: 5, scope: !4)
+!22 = !DILocation(line: 14, column: 5, scope: !4)
+!23 = !DILocation(line: 15, column: 5, scope: !4)
+!24 = !DILocation(line: 16, column: 5, scope: !4)
+!25 = !DILocation(line: 17, column: 5, scope: !4)
+!26 = !DILocation(line: 18, column: 5, scope: !4)
+!27 = !DILocation(line: 19, column: 5, scope: !4)
+!28 = !DILocation(line: 20, column: 5, scope: !4)
+!29 = !DILocation(line: 21, column: 5, scope: !4)
+!30 = !DILocation(line: 22, column: 5, scope: !4)
+!31 = !DILocation(line: 23, column: 5, scope: !4)
+!32 = !DILocation(line: 24, column: 5, scope: !4)
+!33 = !DILocation(line: 25, column: 5, scope: !4)
+!34 = !DILocation(line: 26, column: 5, scope: !4)
+!35 = !DILocation(line: 27, column: 5, scope: !4)
+!36 = !DILocation(line: 28, column: 5, scope: !4)
+!37 = !DILocation(line: 29, column: 5, scope: !4)
+!38 = !DILocation(line: 30, column: 5, scope: !4)
+!39 = !DILocation(line: 31, column: 5, scope: !4)
+!40 = !DILocation(line: 32, column: 5, scope: !4)
+!41 = !DILocation(line: 33, column: 5, scope: !4)
+!42 = !DILocation(line: 34, column: 5, scope: !4)
+!43 = !DILocation(line: 35, column: 5, scope: !4)
+!44 = !DILocation(line: 36, column: 5, scope: !4)
+!45 = !DILocation(line: 37, column: 5, scope: !4)
+!46 = !DILocation(line: 38, column: 5, scope: !4)
+!47 = !DILocation(line: 39, column: 5, scope: !4)
+!48 = !DILocation(line: 40, column: 5, scope: !4)
+!49 = !DILocation(line: 41, column: 5, scope: !4)
+!50 = !DILocation(line: 42, column: 5, scope: !4)
+!51 = !DILocation(line: 43, column: 5, scope: !4)
+!52 = !DILocation(line: 44, column: 5, scope: !4)
+!53 = !DILocation(line: 45, column: 5, scope: !4)
+!54 = !DILocation(line: 46, column: 5, scope: !4)
+!55 = !DILocation(line: 47, column: 5, scope: !4)
+!56 = !DILocation(line: 48, column: 5, scope: !4)
+!57 = !DILocation(line: 49, column: 5, scope: !4)
+!58 = !DILocation(line: 50, column: 5, scope: !4)
+!59 = !DILocation(line: 51, column: 5, scope: !4)
+!60 = !DILocation(line: 52, column: 5, scope: !4)
+!61 = !DILocation(line: 53, column: 5, scope: !4)
+!62 = !DILocation(line: 54, column: 5, scope: !4)
+!63 = !DILocation(line: 55, column: 5, scope: !4)
+!64 = !DILocation(line: 56, column: 5, scope: !4)
+!65 = !DILocation(line: 57, column: 5, scope: !4)
+!66 = !DILocation(line: 58, column: 5, scope: !4)
+!67 = !DILocation(line: 59, column: 5, scope: !4)
+!68 = !DILocation(line: 60, column: 5, scope: !4)
+!69 = !DILocation(line: 61, column: 5, scope: !4)
+!70 = !DILocation(line: 62, column: 5, scope: !4)
+!71 = !DILocation(line: 63, column: 5, scope: !4)
+!72 = !DILocation(line: 64, column: 5, scope: !4)
+!73 = !DILocation(line: 65, column: 5, scope: !4)
+!74 = !DILocation(line: 66, column: 5, scope: !4)
+!75 = !DILocalVariable(name: "a0", scope: !4, file: !1, line: 3, type: !8)
+!76 = !DILocalVariable(name: "a1", scope: !4, file: !1, line: 4, type: !8)
+!77 = !DILocalVariable(name: "a2", scope: !4, file: !1, line: 5, type: !8)
+!78 = !DILocalVariable(name: "a3", scope: !4, file: !1, line: 6, type: !8)
+!79 = !DILocalVariable(name: "a4", scope: !4, file: !1, line: 7, type: !8)
+!80 = !DILocalVariable(name: "a5", scope: !4, file: !1, line: 8, type: !8)
+!81 = !DILocalVariable(name: "a6", scope: !4, file: !1, line: 9, type: !8)
+!82 = !DILocalVariable(name: "a7", scope: !4, file: !1, line: 10, type: !8)
+!83 = !DILocalVariable(name: "a8", scope: !4, file: !1, line: 11, type: !8)
+!84 = !DILocalVariable(name: "a9", scope: !4, file: !1, line: 12, type: !8)
+!85 = !DILocalVariable(name: "a10", scope: !4, file: !1, line: 13, type: !8)
+!86 = !DILocalVariable(name: "a11", scope: !4, file: !1, line: 14, type: !8)
+!87 = !DILocalVariable(name: "a12", scope: !4, file: !1, line: 15, type: !8)
+!88 = !DILocalVariable(name: "a13", scope: !4, file: !1, line: 16, type: !8)
+!89 = !DILocalVariable(name: "a14", scope: !4, file: !1, line: 17, type: !8)
+!90 = !DILocalVariable(name: "a15", scope: !4, file: !1, line: 18, type: !8)
+!91 = !DILocalVariable(name: "a16", scope: !4, file: !1, line: 19, type: !8)
+!92 = !DILocalVariable(name: "a17", scope: !4, file: !1, line: 20, type: !8)
+!93 = !DILocalVariable(name: "a18", scope: !4, file: !1, line: 21, type: !8)
+!94 = !DILocalVariable(name: "a19", scope: !4, file: !1, line: 22, type: !8)
+!95 = !DILocalVariable(name: "a20", scope: !4, file: !1, line: 23, type: !8)
+!96 = !DILocalVariable(name: "a21", scope: !4, file: !1, line: 24, type: !8)
+!97 = !DILocalVariable(name: "a22", scope: !4, file: !1, line: 25, type: !8)
+!98 = !DILocalVariable(name: "a23", scope: !4, file: !1, line: 26, type: !8)
+!99 = !DILocalVariable(name: "a24", scope: !4, file: !1, line: 27, type: !8)
+!100 = !DILocalVariable(name: "a25", scope: !4, file: !1, line: 28, type: !8)
+!101 = !DILocalVariable(name: "a26", scope: !4, file: !1, line: 29, type: !8)
+!102 = !DILocalVariable(name: "a27", scope: !4, file: !1, line: 30, type: !8)
+!103 = !DILocalVariable(name: "a28", scope: !4, file: !1, line: 31, type: !8)
+!104 = !DILocalVariable(name: "a29", scope: !4, file: !1, line: 32, type: !8)
+!105 = !DILocalVariable(name: "a30", scope: !4, file: !1, line: 33, type: !8)
+!106 = !DILocalVariable(name: "a31", scope: !4, file: !1, line: 34, type: !8)
+!107 = !DILocalVariable(name: "a32", scope: !4, file: !1, line: 35, type: !8)
+!108 = !DILocalVariable(name: "a33", scope: !4, file: !1, line: 36, type: !8)
+!109 = !DILocalVariable(name: "a34", scope: !4, file: !1, line: 37, type: !8)
+!110 = !DILocalVariable(name: "a35", scope: !4, file: !1, line: 38, type: !8)
+!111 = !DILocalVariable(name: "a36", scope: !4, file: !1, line: 39, type: !8)
+!112 = !DILocalVariable(name: "a37", scope: !4, file: !1, line: 40, type: !8)
+!113 = !DILocalVariable(name: "a38", scope: !4, file: !1, line: 41, type: !8)
+!114 = !DILocalVariable(name: "a39", scope: !4, file: !1, line: 42, type: !8)
+!115 = !DILocalVariable(name: "a40", scope: !4, file: !1, line: 43, type: !8)
+!116 = !DILocalVariable(name: "a41", scope: !4, file: !1, line: 44, type: !8)
+!117 = !DILocalVariable(name: "a42", scope: !4, file: !1, line: 45, type: !8)
+!118 = !DILocalVariable(name: "a43", scope: !4, file: !1, line: 46, type: !8)
+!119 = !DILocalVariable(name: "a44", scope: !4, file: !1, line: 47, type: !8)
+!120 = !DILocalVariable(name: "a45", scope: !4, file: !1, line: 48, type: !8)
+!121 = !DILocalVariable(name: "a46", scope: !4, file: !1, line: 49, type: !8)
+!122 = !DILocalVariable(name: "a47", scope: !4, file: !1, line: 50, type: !8)
+!123 = !DILocalVariable(name: "a48", scope: !4, file: !1, line: 51, type: !8)
+!124 = !DILocalVariable(name: "a49", scope: !4, file: !1, line: 52, type: !8)
+!125 = !DILocalVariable(name: "a50", scope: !4, file: !1, line: 53, type: !8)
+!126 = !DILocalVariable(name: "a51", scope: !4, file: !1, line: 54, type: !8)
+!127 = !DILocalVariable(name: "a52", scope: !4, file: !1, line: 55, type: !8)
+!128 = !DILocalVariable(name: "a53", scope: !4, file: !1, line: 56, type: !8)
+!129 = !DILocalVariable(name: "a54", scope: !4, file: !1, line: 57, type: !8)
+!130 = !DILocalVariable(name: "a55", scope: !4, file: !1, line: 58, type: !8)
+!131 = !DILocalVariable(name: "a56", scope: !4, file: !1, line: 59, type: !8)
+!132 = !DILocalVariable(name: "a57", scope: !4, file: !1, line: 60, type: !8)
+!133 = !DILocalVariable(name: "a58", scope: !4, file: !1, line: 61, type: !8)
+!134 = !DILocalVariable(name: "a59", scope: !4, file: !1, line: 62, type: !8)
+!135 = !DILocalVariable(name: "a60", scope: !4, file: !1, line: 63, type: !8)
+!136 = !DILocalVariable(name: "a61", scope: !4, file: !1, line: 64, type: !8)
+!137 = !DILocalVariable(name: "a62", scope: !4, file: !1, line: 65, type: !8)
+!138 = !DILocalVariable(name: "a63", scope: !4, file: !1, line: 66, type: !8)
+!139 = !DILocation(line: 67, column: 1, scope: !4)
@@ -0,0 +1,330 @@
+; A switch with many cases, most of which share a successor.
+
+target datalayout = "e-p:32:32-i64:64-v16:16-v32:32-n16:32:64"
+target triple = "spir-unknown-unknown"
+
+define void @large_switch(i32 addrspace(1)* %out, i32 %x) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  switch i32 %x, label %default [
+    i32 0, label %case0
+    i32 1, label %case1
+    i32 2, label %case2
+    i32 3, label %case3
+    i32 4, label %case4
+    i32 5, label %case5
+    i32 6, label %case6
+    i32 7, label %case7
+    i32 8, label %case8
+    i32 9, label %case9
+    i32 10, label %case10
+    i32 11, label %case11
+    i32 12, label %case12
+    i32 13, label %case13
+    i32 14, label %case14
+    i32 15, label %case15
+    i32 16, label %case0
+    i32 17, label %case1
+    i32 18, label %case2
+    i32 19, label %case3
+    i32 20, label %case4
+    i32 21, label %case5
+    i32 22, label %case6
+    i32 23, label %case7
+    i32 24, label %case8
+    i32 25, label %case9
+    i32 26, label %case10
+    i32 27, label %case11
+    i32 28, label %case12
+    i32 29, label %case13
+    i32 30, label %case14
+    i32 31, label %case15
+    i32 32, label %case0
+    i32 33, label %case1
+    i32 34, label %case2
+    i32 35, label %case3
+    i32 36, label %case4
+    i32 37, label %case5
+    i32 38, label %case6
+    i32 39, label %case7
+    i32 40, label %case8
+    i32 41, label %case9
+    i32 42, label %case10
+    i32 43, label %case11
+    i32 44, label %case12
+    i32 45, label %case13
+    i32 46, label %case14
+    i32 47, label %case15
+    i32 48, label %case0
+    i32 49, label %case1
+    i32 50, label %case2
+    i32 51, label %case3
+    i32 52, label %case4
+    i32 53, label %case5
+    i32 54, label %case6
+    i32 55, label %case7
+    i32 56, label %case8
+    i32 57, label %case9
+    i32 58, label %case10
+    i32 59, label %case11
+    i32 60, label %case12
+    i32 61, label %case13
+    i32 62, label %case14
+    i32 63, label %case15
+    i32 64, label %case0
+    i32 65, label %case1
+    i32 66, label %case2
+    i32 67, label %case3
+    i32 68, label %case4
+    i32 69, label %case5
+    i32 70, label %case6
+    i32 71, label %case7
+    i32 72, label %case8
+    i32 73, label %case9
+    i32 74, label %case10
+    i32 75, label %case11
+    i32 76, label %case12
+    i32 77, label %case13
+    i32 78, label %case14
+    i32 79, label %case15
+    i32 80, label %case0
+    i32 81, label %case1
+    i32 82, label %case2
+    i32 83, label %case3
+    i32 84, label %case4
+    i32 85, label %case5
+    i32 86, label %case6
+    i32 87, label %case7
+    i32 88, label %case8
+    i32 89, label %case9
+    i32 90, label %case10
+    i32 91, label %case11
+    i32 92, label %case12
+    i32 93, label %case13
+    i32 94, label %case14
+    i32 95, label %case15
+    i32 96, label %case0
+    i32 97, label %case1
+    i32 98, label %case2
+    i32 99, label %case3
+    i32 100, label %case4
+    i32 101, label %case5
+    i32 102, label %case6
+    i32 103, label %case7
+    i32 104, label %case8
+    i32 105, label %case9
+    i32 106, label %case10
+    i32 107, label %case11
+    i32 108, label %case12
+    i32 109, label %case13
+    i32 110, label %case14
+    i32 111, label %case15
+    i32 112, label %case0
+    i32 113, label %case1
+    i32 114, label %case2
+    i32 115, label %case3
+    i32 116, label %case4
+    i32 117, label %case5
+    i32 118, label %case6
+    i32 119, label %case7
+    i32 120, label %case8
+    i32 121, label %case9
+    i32 122, label %case10
+    i32 123, label %case11
+    i32 124, label %case12
+    i32 125, label %case13
+    i32 126, label %case14
+    i32 127, label %case15
+    i32 128, label %case0
+    i32 129, label %case1
+    i32 130, label %case2
+    i32 131, label %case3
+    i32 132, label %case4
+    i32 133, label %case5
+    i32 134, label %case6
+    i32 135, label %case7
+    i32 136, label %case8
+    i32 137, label %case9
+    i32 138, label %case10
+    i32 139, label %case11
+    i32 140, label %case12
+    i32 141, label %case13
+    i32 142, label %case14
+    i32 143, label %case15
+    i32 144, label %case0
+    i32 145, label %case1
+    i32 146, label %case2
+    i32 147, label %case3
+    i32 148, label %case4
+    i32 149, label %case5
+    i32 150, label %case6
+    i32 151, label %case7
+    i32 152, label %case8
+    i32 153, label %case9
+    i32 154, label %case10
+    i32 155, label %case11
+    i32 156, label %case12
+    i32 157, label %case13
+    i32 158, label %case14
+    i32 159, label %case15
+    i32 160, label %case0
+    i32 161, label %case1
+    i32 162, label %case2
+    i32 163, label %case3
+    i32 164, label %case4
+    i32 165, label %case5
+    i32 166, label %case6
+    i32 167, label %case7
+    i32 168, label %case8
+    i32 169, label %case9
+    i32 170, label %case10
+    i32 171, label %case11
+    i32 172, label %case12
+    i32 173, label %case13
+    i32 174, label %case14
+    i32 175, label %case15
+    i32 176, label %case0
+    i32 177, label %case1
+    i32 178, label %case2
+    i32 179, label %case3
+    i32 180, label %case4
+    i32 181, label %case5
+    i32 182, label %case6
+    i32 183, label %case7
+    i32 184, label %case8
+    i32 185, label %case9
+    i32 186, label %case10
+    i32 187, label %case11
+    i32 188, label %case12
+    i32 189, label %case13
+    i32 190, label %case14
+    i32 191, label %case15
+    i32 192, label %case0
+    i32 193, label %case1
+    i32 194, label %case2
+    i32 195, label %case3
+    i32 196, label %case4
+    i32 197, label %case5
+    i32 198, label %case6
+    i32 199, label %case7
+    i32 200, label %case8
+    i32 201, label %case9
+    i32 202, label %case10
+    i32 203, label %case11
+    i32 204, label %case12
+    i32 205, label %case13
+    i32 206, label %case14
+    i32 207, label %case15
+    i32 208, label %case0
+    i32 209, label %case1
+    i32 210, label %case2
+    i32 211, label %case3
+    i32 212, label %case4
+    i32 213, label %case5
+    i32 214, label %case6
+    i32 215, label %case7
+    i32 216, label %case8
+    i32 217, label %case9
+    i32 218, label %case10
+    i32 219, label %case11
+    i32 220, label %case12
+    i32 221, label %case13
+    i32 222, label %case14
+    i32 223, label %case15
+    i32 224, label %case0
+    i32 225, label %case1
+    i32 226, label %case2
+    i32 227, label %case3
+    i32 228, label %case4
+    i32 229, label %case5
+    i32 230, label %case6
+    i32 231, label %case7
+    i32 232, label %case8
+    i32 233, label %case9
+    i32 234, label %case10
+    i32 235, label %case11
+    i32 236, label %case12
+    i32 237, label %case13
+    i32 238, label %case14
+    i32 239, label %case15
+    i32 240, label %case0
+    i32 241, label %case1
+    i32 242, label %case2
+    i32 243, label %case3
+    i32 244, label %case4
+    i32 245, label %case5
+    i32 246, label %case6
+    i32 247, label %case7
+    i32 248, label %case8
+    i32 249, label %case9
+    i32 250, label %case10
+    i32 251, label %case11
+    i32 252, label %case12
+    i32 253, label %case13
+    i32 254, label %case14
+    i32 255, label %case15
+  ]
+
+case0:
+  br label %exit
+
+case1:
+  br label %exit
+
+case2:
+  br label %exit
+
+case3:
+  br label %exit
+
+case4:
+  br label %exit
+
+case5:
+  br label %exit
+
+case6:
+  br label %exit
+
+case7:
+  br label %exit
+
+case8:
+  br label %exit
+
+case9:
+  br label %exit
+
+case10:
+  br label %exit
+
+case11:
+  br label %exit
+
+case12:
+  br label %exit
+
+case13:
+  br label %exit
+
+case14:
+  br label %exit
+
+case15:
+  br label %exit
+
+default:
+  br label %exit
+
+exit:
+  %r = phi i32 [ 0, %case0 ], [ 3, %case1 ], [ 6, %case2 ], [ 9, %case3 ], [ 12, %case4 ], [ 15, %case5 ], [ 18, %case6 ], [ 21, %case7 ], [ 24, %case8 ], [ 27, %case9 ], [ 30, %case10 ], [ 33, %case11 ], [ 36, %case12 ], [ 39, %case13 ], [ 42, %case14 ], [ 45, %case15 ], [ -1, %default ]
+  %o = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %lid
+  store i32 %r, i32 addrspace(1)* %o, align 4
+  ret void
+}
+
+declare i32 @get_local_id(i32)
+
+!opencl.kernels = !{!0}
+
+!0 = !{void (i32 addrspace(1)*, i32)* @large_switch}
@@ -0,0 +1,179 @@
+; Many __local arrays, each written by every work item.
+
+target datalayout = "e-p:32:32-i64:64-v16:16-v32:32-n16:32:64"
+target triple = "spir-unknown-unknown"
+
+@A0 = internal addrspace(3) global [256 x i32] zeroinitializer, align 4
+@A1 = internal addrspace(3) global [256 x i32] zeroinitializer, align 4
+@A2 = internal addrspace(3) global [256 x i32] zeroinitializer, align 4
+@A3 = internal addrspace(3) global [256 x i32] zeroinitializer, align 4
+@A4 = internal addrspace(3) global [256 x i32] zeroinitializer, align 4
+@A5 = internal addrspace(3) global [256 x i32] zeroinitializer, align 4
+@A6 = internal addrspace(3) global [256 x i32] zeroinitializer, align 4
+@A7 = internal addrspace(3) global [256 x i32] zeroinitializer, align 4
+@A8 = internal addrspace(3) global [256 x i32] zeroinitializer, align 4
+@A9 = internal addrspace(3) global [256 x i32] zeroinitializer, align 4
+@A10 = internal addrspace(3) global [256 x i32] zeroinitializer, align 4
+@A11 = internal addrspace(3) global [256 x i32] zeroinitializer, align 4
+@A12 = internal addrspace(3) global [256 x i32] zeroinitializer, align 4
+@A13 = internal addrspace(3) global [256 x i32] zeroinitializer, align 4
+@A14 = internal addrspace(3) global [256 x i32] zeroinitializer, align 4
+@A15 = internal addrspace(3) global [256 x i32] zeroinitializer, align 4
+@A16 = internal addrspace(3) global [256 x i32] zeroinitializer, align 4
+@A17 = internal addrspace(3) global [256 x i32] zeroinitializer, align 4
+@A18 = internal addrspace(3) global [256 x i32] zeroinitializer, align 4
+@A19 = internal addrspace(3) global [256 x i32] zeroinitializer, align 4
+@A20 = internal addrspace(3) global [256 x i32] zeroinitializer, align 4
+@A21 = internal addrspace(3) global [256 x i32] zeroinitializer, align 4
+@A22 = internal addrspace(3) global [256 x i32] zeroinitializer, align 4
+@A23 = internal addrspace(3) global [256 x i32] zeroinitializer, align 4
+@A24 = internal addrspace(3) global [256 x i32] zeroinitializer, align 4
+@A25 = internal addrspace(3) global [256 x i32] zeroinitializer, align 4
+@A26 = internal addrspace(3) global [256 x i32] zeroinitializer, align 4
+@A27 = internal addrspace(3) global [256 x i32] zeroinitializer, align 4
+@A28 = internal addrspace(3) global [256 x i32] zeroinitializer, align 4
+@A29 = internal addrspace(3) global [256 x i32] zeroinitializer, align 4
+@A30 = internal addrspace(3) global [256 x i32] zeroinitializer, align 4
+@A31 = internal addrspace(3) global [256 x i32] zeroinitializer, align 4
+
+define void @many_globals(i32 addrspace(1)* %out) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %p0 = getelementptr inbounds [256 x i32], [256 x i32] addrspace(3)* @A0, i32 0, i32 %lid
+  store i32 %lid, i32 addrspace(3)* %p0, align 4
+  %v0 = load i32, i32 addrspace(3)* %p0, align 4
+  %s0 = add i32 %v0, 0
+  %p1 = getelementptr inbounds [256 x i32], [256 x i32] addrspace(3)* @A1, i32 0, i32 %lid
+  store i32 %s0, i32 addrspace(3)* %p1, align 4
+  %v1 = load i32, i32 addrspace(3)* %p1, align 4
+  %s1 = add i32 %v1, 1
+  %p2 = getelementptr inbounds [256 x i32], [256 x i32] addrspace(3)* @A2, i32 0, i32 %lid
+  store i32 %s1, i32 addrspace(3)* %p2, align 4
+  %v2 = load i32, i32 addrspace(3)* %p2, align 4
+  %s2 = add i32 %v2, 2
+  %p3 = getelementptr inbounds [256 x i32], [256 x i32] addrspace(3)* @A3, i32 0, i32 %lid
+  store i32 %s2, i32 addrspace(3)* %p3, align 4
+  %v3 = load i32, i32 addrspace(3)* %p3, align 4
+  %s3 = add i32 %v3, 3
+  %p4 = getelementptr inbounds [256 x i32], [256 x i32] addrspace(3)* @A4, i32 0, i32 %lid
+  store i32 %s3, i32 addrspace(3)* %p4, align 4
+  %v4 = load i32, i32 addrspace(3)* %p4, align 4
+  %s4 = add i32 %v4, 4
+  %p5 = getelementptr inbounds [256 x i32], [256 x i32] addrspace(3)* @A5, i32 0, i32 %lid
+  store i32 %s4, i32 addrspace(3)* %p5, align 4
+  %v5 = load i32, i32 addrspace(3)* %p5, align 4
+  %s5 = add i32 %v5, 5
+  %p6 = getelementptr inbounds [256 x i32], [256 x i32] addrspace(3)* @A6, i32 0, i32 %lid
+  store i32 %s5, i32 addrspace(3)* %p6, align 4
+  %v6 = load i32, i32 addrspace(3)* %p6, align 4
+  %s6 = add i32 %v6, 6
+  %p7 = getelementptr inbounds [256 x i32], [256 x i32] addrspace(3)* @A7, i32 0, i32 %lid
+  store i32 %s6, i32 addrspace(3)* %p7, align 4
+  %v7 = load i32, i32 addrspace(3)* %p7, align 4
+  %s7 = add i32 %v7, 7
+  %p8 = getelementptr inbounds [256 x i32], [256 x i32] addrspace(3)* @A8, i32 0, i32 %lid
+  store i32 %s7, i32 addrspace(3)* %p8, align 4
+  %v8 = load i32, i32 addrspace(3)* %p8, align 4
+  %s8 = add i32 %v8, 8
+  %p9 = getelementptr inbounds [256 x i32], [256 x i32] addrspace(3)* @A9, i32 0, i32 %lid
+  store i32 %s8, i32 addrspace(3)* %p9, align 4
+  %v9 = load i32, i32 addrspace(3)* %p9, align 4
+  %s9 = add i32 %v9, 9
+  %p10 = getelementptr inbounds [256 x i32], [256 x i32] addrspace(3)* @A10, i32 0, i32 %lid
+  store i32 %s9, i32 addrspace(3)* %p10, align 4
+  %v10 = load i32, i32 addrspace(3)* %p10, align 4
+  %s10 = add i32 %v10, 10
+  %p11 = getelementptr inbounds [256 x i32], [256 x i32] addrspace(3)* @A11, i32 0, i32 %lid
+  store i32 %s10, i32 addrspace(3)* %p11, align 4
+  %v11 = load i32, i32 addrspace(3)* %p11, align 4
+  %s11 = add i32 %v11, 11
+  %p12 = getelementptr inbounds [256 x i32], [256 x i32] addrspace(3)* @A12, i32 0, i32 %lid
+  store i32 %s11, i32 addrspace(3)* %p12, align 4
+  %v12 = load i32, i32 addrspace(3)* %p12, align 4
+  %s12 = add i32 %v12, 12
+  %p13 = getelementptr inbounds [256 x i32], [256 x i32] addrspace(3)* @A13, i32 0, i32 %lid
+  store i32 %s12, i32 addrspace(3)* %p13, align 4
+  %v13 = load i32, i32 addrspace(3)* %p13, align 4
+  %s13 = add i32 %v13, 13
+  %p14 = getelementptr inbounds [256 x i32], [256 x i32] addrspace(3)* @A14, i32 0, i32 %lid
+  store i32 %s13, i32 addrspace(3)* %p14, align 4
+  %v14 = load i32, i32 addrspace(3)* %p14, align 4
+  %s14 = add i32 %v14, 14
+  %p15 = getelementptr inbounds [256 x i32], [256 x i32] addrspace(3)* @A15, i32 0, i32 %lid
+  store i32 %s14, i32 addrspace(3)* %p15, align 4
+  %v15 = load i32, i32 addrspace(3)* %p15, align 4
+  %s15 = add i32 %v15, 15
+  %p16 = getelementptr inbounds [256 x i32], [256 x i32] addrspace(3)* @A16, i32 0, i32 %lid
+  store i32 %s15, i32 addrspace(3)* %p16, align 4
+  %v16 = load i32, i32 addrspace(3)* %p16, align 4
+  %s16 = add i32 %v16, 16
+  %p17 = getelementptr inbounds [256 x i32], [256 x i32] addrspace(3)* @A17, i32 0, i32 %lid
+  store i32 %s16, i32 addrspace(3)* %p17, align 4
+  %v17 = load i32, i32 addrspace(3)* %p17, align 4
+  %s17 = add i32 %v17, 17
+  %p18 = getelementptr inbounds [256 x i32], [256 x i32] addrspace(3)* @A18, i32 0, i32 %lid
+  store i32 %s17, i32 addrspace(3)* %p18, align 4
+  %v18 = load i32, i32 addrspace(3)* %p18, align 4
+  %s18 = add i32 %v18, 18
+  %p19 = getelementptr inbounds [256 x i32], [256 x i32] addrspace(3)* @A19, i32 0, i32 %lid
+  store i32 %s18, i32 addrspace(3)* %p19, align 4
+  %v19 = load i32, i32 addrspace(3)* %p19, align 4
+  %s19 = add i32 %v19, 19
+  %p20 = getelementptr inbounds [256 x i32], [256 x i32] addrspace(3)* @A20, i32 0, i32 %lid
+  store i32 %s19, i32 addrspace(3)* %p20, align 4
+  %v20 = load i32, i32 addrspace(3)* %p20, align 4
+  %s20 = add i32 %v20, 20
+  %p21 = getelementptr inbounds [256 x i32], [256 x i32] addrspace(3)* @A21, i32 0, i32 %lid
+  store i32 %s20, i32 addrspace(3)* %p21, align 4
+  %v21 = load i32, i32 addrspace(3)* %p21, align 4
+  %s21 = add i32 %v21, 21
+  %p22 = getelementptr inbounds [256 x i32], [256 x i32] addrspace(3)* @A22, i32 0, i32 %lid
+  store i32 %s21, i32 addrspace(3)* %p22, align 4
+  %v22 = load i32, i32 addrspace(3)* %p22, align 4
+  %s22 = add i32 %v22, 22
+  %p23 = getelementptr inbounds [256 x i32], [256 x i32] addrspace(3)* @A23, i32 0, i32 %lid
+  store i32 %s22, i32 addrspace(3)* %p23, align 4
+  %v23 = load i32, i32 addrspace(3)* %p23, align 4
+  %s23 = add i32 %v23, 23
+  %p24 = getelementptr inbounds [256 x i32], [256 x i32] addrspace(3)* @A24, i32 0, i32 %lid
+  store i32 %s23, i32 addrspace(3)* %p24, align 4
+  %v24 = load i32, i32 addrspace(3)* %p24, align 4
+  %s24 = add i32 %v24, 24
+  %p25 = getelementptr inbounds [256 x i32], [256 x i32] addrspace(3)* @A25, i32 0, i32 %lid
+  store i32 %s24, i32 addrspace(3)* %p25, align 4
+  %v25 = load i32, i32 addrspace(3)* %p25, align 4
+  %s25 = add i32 %v25, 25
+  %p26 = getelementptr inbounds [256 x i32], [256 x i32] addrspace(3)* @A26, i32 0, i32 %lid
+  store i32 %s25, i32 addrspace(3)* %p26, align 4
+  %v26 = load i32, i32 addrspace(3)* %p26, align 4
+  %s26 = add i32 %v26, 26
+  %p27 = getelementptr inbounds [256 x i32], [256 x i32] addrspace(3)* @A27, i32 0, i32 %lid
+  store i32 %s26, i32 addrspace(3)* %p27, align 4
+  %v27 = load i32, i32 addrspace(3)* %p27, align 4
+  %s27 = add i32 %v27, 27
+  %p28 = getelementptr inbounds [256 x i32], [256 x i32] addrspace(3)* @A28, i32 0, i32 %lid
+  store i32 %s27, i32 addrspace(3)* %p28, align 4
+  %v28 = load i32, i32 addrspace(3)* %p28, align 4
+  %s28 = add i32 %v28, 28
+  %p29 = getelementptr inbounds [256 x i32], [256 x i32] addrspace(3)* @A29, i32 0, i32 %lid
+  store i32 %s28, i32 addrspace(3)* %p29, align 4
+  %v29 = load i32, i32 addrspace(3)* %p29, align 4
+  %s29 = add i32 %v29, 29
+  %p30 = getelementptr inbounds [256 x i32], [256 x i32] addrspace(3)* @A30, i32 0, i32 %lid
+  store i32 %s29, i32 addrspace(3)* %p30, align 4
+  %v30 = load i32, i32 addrspace(3)* %p30, align 4
+  %s30 = add i32 %v30, 30
+  %p31 = getelementptr inbounds [256 x i32], [256 x i32] addrspace(3)* @A31, i32 0, i32 %lid
+  store i32 %s30, i32 addrspace(3)* %p31, align 4
+  %v31 = load i32, i32 addrspace(3)* %p31, align 4
+  %s31 = add i32 %v31, 31
+  %o = getelementptr inbounds i32, i32 addrspace(1)* %out, i32 %lid
+  store i32 %s31, i32 addrspace(1)* %o, align 4
+  ret void
+}
+
+declare i32 @get_local_id(i32)
+
+!opencl.kernels = !{!0}
+
+!0 = !{void (i32 addrspace(1)*)* @many_globals}
@@ -0,0 +1,551 @@
+; Many kernels sharing a few helper functions.
+
+target datalayout = "e-p:32:32-i64:64-v16:16-v32:32-n16:32:64"
+target triple = "spir-unknown-unknown"
+
+define internal i32 @helper_scale(i32 %x, i32 %k) {
+entry:
+  %m = mul i32 %x, %k
+  %a = add i32 %m, 7
+  ret i32 %a
+}
+
+define internal void @helper_store(i32 addrspace(1)* %p, i32 %i, i32 %v) {
+entry:
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %p, i32 %i
+  store i32 %v, i32 addrspace(1)* %e, align 4
+  ret void
+}
+
+define void @kernel0(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 1)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel1(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 2)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel2(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 3)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel3(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 4)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel4(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 5)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel5(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 6)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel6(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 7)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel7(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 8)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel8(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 9)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel9(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 10)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel10(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 11)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel11(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 12)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel12(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 13)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel13(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 14)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel14(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 15)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel15(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 16)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel16(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 17)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel17(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 18)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel18(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 19)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel19(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 20)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel20(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 21)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel21(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 22)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel22(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 23)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel23(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 24)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel24(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 25)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel25(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 26)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel26(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 27)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel27(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 28)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel28(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 29)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel29(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 30)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel30(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 31)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel31(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 32)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel32(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 33)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel33(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 34)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel34(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 35)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel35(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 36)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel36(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 37)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel37(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 38)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel38(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 39)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel39(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 40)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel40(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 41)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel41(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 42)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel42(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 43)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel43(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 44)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel44(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 45)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel45(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 46)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel46(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 47)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+define void @kernel47(i32 addrspace(1)* %out, i32 addrspace(1)* %in) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %e = getelementptr inbounds i32, i32 addrspace(1)* %in, i32 %lid
+  %v = load i32, i32 addrspace(1)* %e, align 4
+  %r = call i32 @helper_scale(i32 %v, i32 48)
+  call void @helper_store(i32 addrspace(1)* %out, i32 %lid, i32 %r)
+  ret void
+}
+
+declare i32 @get_local_id(i32)
+
+!opencl.kernels = !{!0, !1, !2, !3, !4, !5, !6, !7, !8, !9, !10, !11, !12, !13, !14, !15, !16, !17, !18, !19, !20, !21, !22, !23, !24, !25, !26, !27, !28, !29, !30, !31, !32, !33, !34, !35, !36, !37, !38, !39, !40, !41, !42, !43, !44, !45, !46, !47}
+
+!0 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel0}
+!1 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel1}
+!2 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel2}
+!3 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel3}
+!4 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel4}
+!5 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel5}
+!6 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel6}
+!7 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel7}
+!8 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel8}
+!9 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel9}
+!10 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel10}
+!11 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel11}
+!12 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel12}
+!13 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel13}
+!14 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel14}
+!15 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel15}
+!16 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel16}
+!17 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel17}
+!18 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel18}
+!19 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel19}
+!20 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel20}
+!21 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel21}
+!22 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel22}
+!23 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel23}
+!24 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel24}
+!25 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel25}
+!26 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel26}
+!27 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel27}
+!28 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel28}
+!29 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel29}
+!30 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel30}
+!31 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel31}
+!32 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel32}
+!33 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel33}
+!34 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel34}
+!35 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel35}
+!36 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel36}
+!37 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel37}
+!38 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel38}
+!39 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel39}
+!40 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel40}
+!41 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel41}
+!42 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel42}
+!43 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel43}
+!44 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel44}
+!45 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel45}
+!46 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel46}
+!47 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @kernel47}
@@ -0,0 +1,40 @@
+; memcpy and memset between arrays of structures.
+
+target datalayout = "e-p:32:32-i64:64-v16:16-v32:32-n16:32:64"
+target triple = "spir-unknown-unknown"
+
+%struct.S = type { i32, float, [4 x i16] }
+
+@Src = internal addrspace(3) global [128 x %struct.S] zeroinitializer, align 4
+@Dst = internal addrspace(3) global [128 x %struct.S] zeroinitializer, align 4
+
+define void @memcpy_memset(%struct.S addrspace(1)* %g) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  %d = getelementptr inbounds [128 x %struct.S], [128 x %struct.S] addrspace(3)* @Dst, i32 0, i32 %lid
+  %s = getelementptr inbounds [128 x %struct.S], [128 x %struct.S] addrspace(3)* @Src, i32 0, i32 %lid
+  %g1 = getelementptr inbounds %struct.S, %struct.S addrspace(1)* %g, i32 %lid
+  %d8 = bitcast %struct.S addrspace(3)* %d to i8 addrspace(3)*
+  %s8 = bitcast %struct.S addrspace(3)* %s to i8 addrspace(3)*
+  %g8 = bitcast %struct.S addrspace(1)* %g1 to i8 addrspace(1)*
+  call void @llvm.memset.p3i8.i32(i8 addrspace(3)* align 4 %d8, i8 0, i32 16, i1 false)
+  call void @llvm.memcpy.p3i8.p1i8.i32(i8 addrspace(3)* align 4 %s8, i8 addrspace(1)* align 4 %g8, i32 16, i1 false)
+  call void @llvm.memcpy.p3i8.p3i8.i32(i8 addrspace(3)* align 4 %d8, i8 addrspace(3)* align 4 %s8, i32 16, i1 false)
+  %all = bitcast [128 x %struct.S] addrspace(3)* @Dst to i8 addrspace(3)*
+  call void @llvm.memcpy.p1i8.p3i8.i32(i8 addrspace(1)* align 4 %g8, i8 addrspace(3)* align 4 %all, i32 64, i1 false)
+  ret void
+}
+
+declare i32 @get_local_id(i32)
+
+declare void @llvm.memset.p3i8.i32(i8 addrspace(3)* nocapture writeonly, i8, i32, i1)
+
+declare void @llvm.memcpy.p3i8.p1i8.i32(i8 addrspace(3)* nocapture writeonly, i8 addrspace(1)* nocapture readonly, i32, i1)
+
+declare void @llvm.memcpy.p3i8.p3i8.i32(i8 addrspace(3)* nocapture writeonly, i8 addrspace(3)* nocapture readonly, i32, i1)
+
+declare void @llvm.memcpy.p1i8.p3i8.i32(i8 addrspace(1)* nocapture writeonly, i8 addrspace(3)* nocapture readonly, i32, i1)
+
+!opencl.kernels = !{!0}
+
+!0 = !{void (%struct.S addrspace(1)*)* @memcpy_memset}
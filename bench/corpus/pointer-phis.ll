@@ -0,0 +1,93 @@
+; Pointer phis selecting between several arrays inside a loop, which forces
+; case splits on every access.
+
+target datalayout = "e-p:32:32-i64:64-v16:16-v32:32-n16:32:64"
+target triple = "spir-unknown-unknown"
+
+@B0 = internal addrspace(3) global [64 x i32] zeroinitializer, align 4
+@B1 = internal addrspace(3) global [64 x i32] zeroinitializer, align 4
+@B2 = internal addrspace(3) global [64 x i32] zeroinitializer, align 4
+@B3 = internal addrspace(3) global [64 x i32] zeroinitializer, align 4
+@B4 = internal addrspace(3) global [64 x i32] zeroinitializer, align 4
+@B5 = internal addrspace(3) global [64 x i32] zeroinitializer, align 4
+@B6 = internal addrspace(3) global [64 x i32] zeroinitializer, align 4
+@B7 = internal addrspace(3) global [64 x i32] zeroinitializer, align 4
+
+define void @pointer_phis(i32 %sel, i32 %n) {
+entry:
+  %lid = call i32 @get_local_id(i32 0)
+  switch i32 %sel, label %pick0 [
+    i32 1, label %pick1
+    i32 2, label %pick2
+    i32 3, label %pick3
+    i32 4, label %pick4
+    i32 5, label %pick5
+    i32 6, label %pick6
+    i32 7, label %pick7
+  ]
+
+pick0:
+  %q0 = getelementptr inbounds [64 x i32], [64 x i32] addrspace(3)* @B0, i32 0, i32 0
+  br label %loop
+
+pick1:
+  %q1 = getelementptr inbounds [64 x i32], [64 x i32] addrspace(3)* @B1, i32 0, i32 0
+  br label %loop
+
+pick2:
+  %q2 = getelementptr inbounds [64 x i32], [64 x i32] addrspace(3)* @B2, i32 0, i32 0
+  br label %loop
+
+pick3:
+  %q3 = getelementptr inbounds [64 x i32], [64 x i32] addrspace(3)* @B3, i32 0, i32 0
+  br label %loop
+
+pick4:
+  %q4 = getelementptr inbounds [64 x i32], [64 x i32] addrspace(3)* @B4, i32 0, i32 0
+  br label %loop
+
+pick5:
+  %q5 = getelementptr inbounds [64 x i32], [64 x i32] addrspace(3)* @B5, i32 0, i32 0
+  br label %loop
+
+pick6:
+  %q6 = getelementptr inbounds [64 x i32], [64 x i32] addrspace(3)* @B6, i32 0, i32 0
+  br label %loop
+
+pick7:
+  %q7 = getelementptr inbounds [64 x i32], [64 x i32] addrspace(3)* @B7, i32 0, i32 0
+  br label %loop
+
+loop:
+  %i = phi i32 [ 0, %pick0 ],  [ 0, %pick1 ],  [ 0, %pick2 ],  [ 0, %pick3 ],  [ 0, %pick4 ],  [ 0, %pick5 ],  [ 0, %pick6 ],  [ 0, %pick7 ], [ %i.next, %loop.latch ]
+  %p = phi i32 addrspace(3)* [ %q0, %pick0 ], [ %q1, %pick1 ], [ %q2, %pick2 ], [ %q3, %pick3 ], [ %q4, %pick4 ], [ %q5, %pick5 ], [ %q6, %pick6 ], [ %q7, %pick7 ], [ %p.next, %loop.latch ]
+  %cmp = icmp slt i32 %i, %n
+  br i1 %cmp, label %body, label %exit
+
+body:
+  %e = getelementptr inbounds i32, i32 addrspace(3)* %p, i32 %lid
+  %v = load i32, i32 addrspace(3)* %e, align 4
+  %v1 = add nsw i32 %v, %i
+  store i32 %v1, i32 addrspace(3)* %e, align 4
+  %odd = and i32 %i, 1
+  %isodd = icmp ne i32 %odd, 0
+  br i1 %isodd, label %swap, label %loop.latch
+
+swap:
+  %other = getelementptr inbounds [64 x i32], [64 x i32] addrspace(3)* @B0, i32 0, i32 0
+  br label %loop.latch
+
+loop.latch:
+  %p.next = phi i32 addrspace(3)* [ %p, %body ], [ %other, %swap ]
+  %i.next = add nsw i32 %i, 1
+  br label %loop
+
+exit:
+  ret void
+}
+
+declare i32 @get_local_id(i32)
+
+!opencl.kernels = !{!0}
+
+!0 = !{void (i32, i32)* @pointer_phis}
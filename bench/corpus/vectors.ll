@@ -0,0 +1,94 @@
+; Vector loads, stores, arithmetic and shuffles.
+
+target datalayout = "e-p:32:32-i64:64-v16:16-v32:32-n16:32:64"
+target triple = "spir-unknown-unknown"
+
+define void @vectors(<4 x float> addrspace(1)* %a, <4 x float> addrspace(1)* %b, <4 x float> addrspace(1)* %c) {
+entry:
+  %gid = call i32 @get_group_id(i32 0)
+  %lsz = call i32 @get_local_size(i32 0)
+  %lid = call i32 @get_local_id(i32 0)
+  %m = mul i32 %gid, %lsz
+  %idx = add i32 %m, %lid
+  %pa = getelementptr inbounds <4 x float>, <4 x float> addrspace(1)* %a, i32 %idx
+  %pb = getelementptr inbounds <4 x float>, <4 x float> addrspace(1)* %b, i32 %idx
+  %pc = getelementptr inbounds <4 x float>, <4 x float> addrspace(1)* %c, i32 %idx
+  %va = load <4 x float>, <4 x float> addrspace(1)* %pa, align 16
+  %vb = load <4 x float>, <4 x float> addrspace(1)* %pb, align 16
+  %m0 = fmul <4 x float> %va, %vb
+  %s0 = shufflevector <4 x float> %m0, <4 x float> %vb, <4 x i32> <i32 0, i32 5, i32 2, i32 7>
+  %x0 = extractelement <4 x float> %s0, i32 0
+  %r0 = insertelement <4 x float> %s0, float %x0, i32 1
+  %m1 = fmul <4 x float> %r0, %vb
+  %s1 = shufflevector <4 x float> %m1, <4 x float> %vb, <4 x i32> <i32 1, i32 6, i32 3, i32 4>
+  %x1 = extractelement <4 x float> %s1, i32 1
+  %r1 = insertelement <4 x float> %s1, float %x1, i32 2
+  %m2 = fmul <4 x float> %r1, %vb
+  %s2 = shufflevector <4 x float> %m2, <4 x float> %vb, <4 x i32> <i32 2, i32 7, i32 0, i32 5>
+  %x2 = extractelement <4 x float> %s2, i32 2
+  %r2 = insertelement <4 x float> %s2, float %x2, i32 3
+  %m3 = fmul <4 x float> %r2, %vb
+  %s3 = shufflevector <4 x float> %m3, <4 x float> %vb, <4 x i32> <i32 3, i32 4, i32 1, i32 6>
+  %x3 = extractelement <4 x float> %s3, i32 3
+  %r3 = insertelement <4 x float> %s3, float %x3, i32 0
+  %m4 = fmul <4 x float> %r3, %vb
+  %s4 = shufflevector <4 x float> %m4, <4 x float> %vb, <4 x i32> <i32 0, i32 5, i32 2, i32 7>
+  %x4 = extractelement <4 x float> %s4, i32 0
+  %r4 = insertelement <4 x float> %s4, float %x4, i32 1
+  %m5 = fmul <4 x float> %r4, %vb
+  %s5 = shufflevector <4 x float> %m5, <4 x float> %vb, <4 x i32> <i32 1, i32 6, i32 3, i32 4>
+  %x5 = extractelement <4 x float> %s5, i32 1
+  %r5 = insertelement <4 x float> %s5, float %x5, i32 2
+  %m6 = fmul <4 x float> %r5, %vb
+  %s6 = shufflevector <4 x float> %m6, <4 x float> %vb, <4 x i32> <i32 2, i32 7, i32 0, i32 5>
+  %x6 = extractelement <4 x float> %s6, i32 2
+  %r6 = insertelement <4 x float> %s6, float %x6, i32 3
+  %m7 = fmul <4 x float> %r6, %vb
+  %s7 = shufflevector <4 x float> %m7, <4 x float> %vb, <4 x i32> <i32 3, i32 4, i32 1, i32 6>
+  %x7 = extractelement <4 x float> %s7, i32 3
+  %r7 = insertelement <4 x float> %s7, float %x7, i32 0
+  %m8 = fmul <4 x float> %r7, %vb
+  %s8 = shufflevector <4 x float> %m8, <4 x float> %vb, <4 x i32> <i32 0, i32 5, i32 2, i32 7>
+  %x8 = extractelement <4 x float> %s8, i32 0
+  %r8 = insertelement <4 x float> %s8, float %x8, i32 1
+  %m9 = fmul <4 x float> %r8, %vb
+  %s9 = shufflevector <4 x float> %m9, <4 x float> %vb, <4 x i32> <i32 1, i32 6, i32 3, i32 4>
+  %x9 = extractelement <4 x float> %s9, i32 1
+  %r9 = insertelement <4 x float> %s9, float %x9, i32 2
+  %m10 = fmul <4 x float> %r9, %vb
+  %s10 = shufflevector <4 x float> %m10, <4 x float> %vb, <4 x i32> <i32 2, i32 7, i32 0, i32 5>
+  %x10 = extractelement <4 x float> %s10, i32 2
+  %r10 = insertelement <4 x float> %s10, float %x10, i32 3
+  %m11 = fmul <4 x float> %r10, %vb
+  %s11 = shufflevector <4 x float> %m11, <4 x float> %vb, <4 x i32> <i32 3, i32 4, i32 1, i32 6>
+  %x11 = extractelement <4 x float> %s11, i32 3
+  %r11 = insertelement <4 x float> %s11, float %x11, i32 0
+  %m12 = fmul <4 x float> %r11, %vb
+  %s12 = shufflevector <4 x float> %m12, <4 x float> %vb, <4 x i32> <i32 0, i32 5, i32 2, i32 7>
+  %x12 = extractelement <4 x float> %s12, i32 0
+  %r12 = insertelement <4 x float> %s12, float %x12, i32 1
+  %m13 = fmul <4 x float> %r12, %vb
+  %s13 = shufflevector <4 x float> %m13, <4 x float> %vb, <4 x i32> <i32 1, i32 6, i32 3, i32 4>
+  %x13 = extractelement <4 x float> %s13, i32 1
+  %r13 = insertelement <4 x float> %s13, float %x13, i32 2
+  %m14 = fmul <4 x float> %r13, %vb
+  %s14 = shufflevector <4 x float> %m14, <4 x float> %vb, <4 x i32> <i32 2, i32 7, i32 0, i32 5>
+  %x14 = extractelement <4 x float> %s14, i32 2
+  %r14 = insertelement <4 x float> %s14, float %x14, i32 3
+  %m15 = fmul <4 x float> %r14, %vb
+  %s15 = shufflevector <4 x float> %m15, <4 x float> %vb, <4 x i32> <i32 3, i32 4, i32 1, i32 6>
+  %x15 = extractelement <4 x float> %s15, i32 3
+  %r15 = insertelement <4 x float> %s15, float %x15, i32 0
+  store <4 x float> %r15, <4 x float> addrspace(1)* %pc, align 16
+  ret void
+}
+
+declare i32 @get_group_id(i32)
+
+declare i32 @get_local_size(i32)
+
+declare i32 @get_local_id(i32)
+
+!opencl.kernels = !{!0}
+
+!0 = !{void (<4 x float> addrspace(1)*, <4 x float> addrspace(1)*, <4 x float> addrspace(1)*)* @vectors}
@@ -0,0 +1,21 @@
+#!/bin/sh
+# Measure how translation scales along one dimension of the generated kernels.
+#
+# Usage: scaling.sh <build-dir> <dimension> <value>...
+# where <dimension> is one of the bugle-gen options, for example:
+#   scaling.sh build switch-cases 16 64 256 1024
+# The bugle-bench results for each value are written to scaling-<value>.json.
+
+if [ $# -lt 3 ]; then
+  echo "Usage: $0 <build-dir> <dimension> <value>..." >&2
+  exit 1
+fi
+
+BUILD=$1
+DIM=$2
+shift 2
+
+for VALUE in "$@"; do
+  "$BUILD/bugle-gen" "-$DIM=$VALUE" -o "scaling-$VALUE.bc" || exit 1
+  "$BUILD/bugle-bench" -o "scaling-$VALUE.json" "scaling-$VALUE.bc" || exit 1
+done
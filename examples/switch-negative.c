@@ -0,0 +1,18 @@
+#include <bugle.h>
+
+// Negative scrutinees must reach the default case under both -i bv and
+// -i math.
+int f(int x) {
+  switch (x) {
+  case 0: return 1;
+  case 1: return 2;
+  case 2: return 3;
+  default: return 0;
+  }
+}
+
+void foo(int x) {
+  bugle_requires(x < 0);
+  bugle_assert(f(x) == 0);
+  bugle_assert(f(-1) == 0);
+}
@@ -1,7 +1,9 @@
 #ifndef BUGLE_BPLEXPRWRITER_H
 #define BUGLE_BPLEXPRWRITER_H
 
+#include "bugle/Ref.h"
 #include <string>
+#include <vector>
 
 namespace llvm {
 
@@ -11,7 +13,9 @@ class raw_ostream;
 namespace bugle {
 
 class BPLModuleWriter;
+class BinaryExpr;
 class Expr;
+class Function;
 
 class BPLExprWriter {
   void writeAccessHasOccurredVar(llvm::raw_ostream &OS, bugle::Expr *PtrArr,
@@ -20,9 +24,30 @@ class BPLExprWriter {
   void writeAccessOffsetVar(llvm::raw_ostream &OS, bugle::Expr *PtrArr,
                             std::string accessKind);
 
+  bool isMathOperand(Expr *E, bool Unsigned);
+  bool writeMathComparison(llvm::raw_ostream &OS, BinaryExpr *E,
+                           const char *Op, bool Unsigned);
+  bool writeSplitPointerComparison(llvm::raw_ostream &OS, BinaryExpr *E,
+                                   bool Eq);
+
 protected:
   BPLModuleWriter *MW;
 
+  // Write the variable holding the value of E, if one has been assigned.
+  virtual bool writeSSAVar(llvm::raw_ostream &OS, Expr *E) { return false; }
+  // Write the value of the bitvector E as a mathematical integer.
+  void writeMathExpr(llvm::raw_ostream &OS, Expr *E);
+  // Write the variable holding the given part ("base" or "offset") of the
+  // pointer E, if E is held in split form.
+  virtual bool writeSplitPointerVar(llvm::raw_ostream &OS, Expr *E,
+                                    const char *Part) {
+    return false;
+  }
+  // Write the array id or the offset of the pointer E.
+  void writePointerPart(llvm::raw_ostream &OS, Expr *E, bool Offset);
+  void writeCallArgs(llvm::raw_ostream &OS, Function *Callee,
+                     const std::vector<ref<Expr>> &Args);
+
 public:
   BPLExprWriter(BPLModuleWriter *MW) : MW(MW) {}
   virtual ~BPLExprWriter();
@@ -6,6 +6,7 @@
 #include <functional>
 #include <map>
 #include <set>
+#include <string>
 #include <vector>
 
 namespace llvm {
@@ -28,14 +29,24 @@ class BPLFunctionWriter : BPLExprWriter {
   llvm::raw_ostream &OS;
   bugle::Function *F;
   std::map<Expr *, unsigned> SSAVarIds;
+  // The variable assigned to each expression by coalescing, if enabled.
+  std::map<Expr *, unsigned> SSAVarSlots;
   std::set<GlobalArray *> ModifiesSet;
 
   void maybeWriteCaseSplit(llvm::raw_ostream &OS, Expr *PtrArr,
                            const SourceLocsRef &SLocs,
                            std::function<void(GlobalArray *, unsigned)> F,
                            unsigned indent = 2);
+  bool isSplitPointerVar(Var *V);
+  bool isSplitPointerValue(Expr *E);
   void writeVar(llvm::raw_ostream &OS, Var *V);
-  void writeExpr(llvm::raw_ostream &OS, Expr *E, unsigned Depth = 0) override;
+  bool writeSSAVar(llvm::raw_ostream &OS, Expr *E) override;
+  bool writeSplitPointerVar(llvm::raw_ostream &OS, Expr *E,
+                            const char *Part) override;
+  void writeSSAVarDef(llvm::raw_ostream &OS, Expr *E, unsigned Id);
+  std::string getSSAVarType(Expr *E);
+  void coalesceSSAVars();
+  void writeValue(llvm::raw_ostream &OS, Expr *E, bool Math);
   void writeCallStmt(llvm::raw_ostream &OS, CallStmt *CS);
   void writeStmt(llvm::raw_ostream &OS, Stmt *S);
   void writeBasicBlock(llvm::raw_ostream &OS, BasicBlock *BB);
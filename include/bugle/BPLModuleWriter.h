@@ -4,6 +4,7 @@
 #include "bugle/BPLExprWriter.h"
 #include "bugle/RaceInstrumenter.h"
 #include <functional>
+#include <map>
 #include <set>
 #include <string>
 
@@ -14,6 +15,8 @@ class raw_ostream;
 
 namespace bugle {
 
+class Function;
+class GlobalArray;
 class IntegerRepresentation;
 class Module;
 class SourceLocWriter;
@@ -29,6 +32,24 @@ class BPLModuleWriter : BPLExprWriter {
   bool UsesPointers, UsesFunctionPointers;
   std::string GlobalInitRequires;
   unsigned candidateNumber;
+  bool PruneRaceInstrumentation;
+  bool SplitPointers;
+  bool CoalesceVars;
+
+  // How the written functions use each array. Arrays which are not used are
+  // not declared, and only the race instrumentation for the kinds of access
+  // which occur is declared, if pruning is enabled.
+  enum ArrayUse {
+    AU_Referenced = 1,
+    AU_Read = 2,
+    AU_Write = 4,
+    AU_Atomic = 8,
+    AU_Access = AU_Read | AU_Write | AU_Atomic
+  };
+  std::map<GlobalArray *, unsigned> ArrayUses;
+
+  void addArrayUse(GlobalArray *GA, unsigned Use);
+  unsigned getArrayUse(GlobalArray *GA);
 
   const std::string &getGlobalInitRequires();
   void writeType(llvm::raw_ostream &OS, const bugle::Type &t);
@@ -37,14 +58,19 @@ class BPLModuleWriter : BPLExprWriter {
   unsigned nextCandidateNumber();
   unsigned bitsRequiredForArrayBases();
   unsigned bitsRequiredForFunctionPointers();
+  bool splitsPointerParameters(Function *F);
 
 public:
   BPLModuleWriter(llvm::raw_ostream &OS, bugle::Module *M,
                   bugle::IntegerRepresentation *IntRep,
-                  bugle::RaceInstrumenter RaceInst, bugle::SourceLocWriter *SLW)
+                  bugle::RaceInstrumenter RaceInst, bugle::SourceLocWriter *SLW,
+                  bool PruneRaceInstrumentation = false,
+                  bool SplitPointers = false, bool CoalesceVars = false)
       : BPLExprWriter(this), OS(OS), M(M), IntRep(IntRep), RaceInst(RaceInst),
         SLW(SLW), UsesPointers(false), UsesFunctionPointers(false),
-        candidateNumber(0) {}
+        candidateNumber(0),
+        PruneRaceInstrumentation(PruneRaceInstrumentation),
+        SplitPointers(SplitPointers), CoalesceVars(CoalesceVars) {}
 
   void write();
 
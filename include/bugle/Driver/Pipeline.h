@@ -0,0 +1,86 @@
+#ifndef BUGLE_DRIVER_PIPELINE_H
+#define BUGLE_DRIVER_PIPELINE_H
+
+#include "bugle/Module.h"
+#include "bugle/RaceInstrumenter.h"
+#include "bugle/Translator/FunctionClassifier.h"
+#include "bugle/Translator/TranslateModule.h"
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+
+namespace llvm {
+
+class Module;
+class raw_ostream;
+}
+
+namespace bugle {
+
+class IntegerRepresentation;
+class SourceLocWriter;
+
+// The options which select the stages of the translation pipeline, and how
+// each stage translates the module.
+struct PipelineOptions {
+  TranslateModule::SourceLanguage SL;
+  std::set<std::string> EntryPoints;
+  bool OnlyExplicitEntryPoints;
+  bool Inlining;
+  std::string PreOpt;
+  unsigned UnrollThreshold;
+  unsigned BoundedUnroll;
+
+  TranslateModule::AddressSpaceMap AddressSpaces;
+  RaceInstrumenter RaceInstrumentation;
+  std::map<std::string, ArraySpec> ArraySizes;
+  std::map<std::string, ArgValueSpec> ArgValues;
+  TranslateModule::LaunchConfiguration Launch;
+  bool NarrowBitWidths;
+
+  bool PropagateConstants;
+  bool SimplifyCFG;
+  bool GlobalValueNumbering;
+  bool AffineAccessSummaries;
+
+  bool PruneRaceInstrumentation;
+  bool SplitPointers;
+  bool CoalesceVars;
+
+  PipelineOptions(TranslateModule::SourceLanguage SL,
+                  const TranslateModule::AddressSpaceMap &AS)
+      : SL(SL), OnlyExplicitEntryPoints(false), Inlining(false),
+        UnrollThreshold(0), BoundedUnroll(0), AddressSpaces(AS),
+        RaceInstrumentation(RaceInstrumenter::WatchdogSingle),
+        NarrowBitWidths(false), PropagateConstants(false), SimplifyCFG(false),
+        GlobalValueNumbering(false), AffineAccessSummaries(false),
+        PruneRaceInstrumentation(false), SplitPointers(false),
+        CoalesceVars(false) {}
+};
+
+// Translates an LLVM module to Boogie in the stages run by the bugle driver:
+// the LLVM preprocessing passes, translation to a bugle module, the bugle
+// module transformations, and writing. Each stage is a profiler phase.
+class Pipeline {
+  llvm::Module *M;
+  const PipelineOptions &Opts;
+  FunctionClassifier FC;
+  std::unique_ptr<TranslateModule> TM;
+  std::unique_ptr<bugle::Module> BM;
+
+public:
+  Pipeline(llvm::Module *M, const PipelineOptions &Opts)
+      : M(M), Opts(Opts), FC(M, Opts.SL, Opts.EntryPoints) {}
+
+  void preprocess();
+  void translate();
+  void transform();
+  void write(llvm::raw_ostream &OS, IntegerRepresentation *IntRep,
+             SourceLocWriter *SLW);
+
+  bugle::Module *getModule() { return BM.get(); }
+};
+}
+
+#endif
@@ -3,6 +3,7 @@
 #include "bugle/Var.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/APInt.h"
+#include <functional>
 #include <set>
 #include <vector>
 
@@ -12,6 +13,7 @@
 namespace llvm {
 
 class Value;
+class raw_ostream;
 }
 
 namespace bugle {
@@ -162,6 +164,21 @@ public:
   static Type getArrayCandidateType(const std::set<GlobalArray *> &Globals);
   static Type getPointerRange(ref<Expr> pointer, Type defaultRange);
   bool computeArrayCandidates(std::set<GlobalArray *> &GlobalSet) const;
+  // Append the immediate subexpressions of this expression to Ops.
+  void getOperands(std::vector<Expr *> &Ops) const;
+  // Replace each immediate subexpression E with F(E), which must have the
+  // same type and value as E wherever this expression is evaluated.
+  void replaceOperands(const std::function<ref<Expr>(Expr *)> &F);
+
+  static const char *getKindName(Kind K);
+
+  // When set, ref<Expr> reports every reference count change, from which
+  // per-kind creation and liveness statistics are kept.
+  static bool TrackAllocation;
+  static void noteIncrement(const Expr *E);
+  static void noteDecrement(const Expr *E);
+  static void reportAllocationCounts();
+  static void printAllocationStats(llvm::raw_ostream &OS);
 
 private:
   Type type;
@@ -179,6 +196,7 @@ public:
 };
 
 #define EXPR_KIND(kind)                                                        \
+  friend class Expr;                                                           \
   Kind getKind() const override { return kind; }                               \
   static bool classof(const Expr *E) { return E->getKind() == kind; }          \
   static bool classof(const kind##Expr *) { return true; }
@@ -412,6 +430,7 @@ public:
 };
 
 class UnaryExpr : public Expr {
+  friend class Expr;
   ref<Expr> expr;
 
 protected:
@@ -489,7 +508,6 @@ UNARY_CONV_EXPR(SafePtrToBV)
 UNARY_CONV_EXPR(BVToFuncPtr)
 UNARY_CONV_EXPR(FuncPtrToBV)
 UNARY_CONV_EXPR(BVSExt)
-UNARY_CONV_EXPR(BVZExt)
 UNARY_CONV_EXPR(FPConv)
 UNARY_CONV_EXPR(FPToSI)
 UNARY_CONV_EXPR(FPToUI)
@@ -500,7 +518,23 @@ UNARY_CONV_EXPR(FrexpExp)
 #undef UNARY_EXPR
 #undef UNARY_CONV_EXPR
 
+// A zero extension is marked as non-negative if its operand is known to have
+// a clear sign bit, as is the case for the extensions introduced by bit-width
+// narrowing. The extension then also preserves the signed value.
+class BVZExtExpr : public UnaryExpr {
+  BVZExtExpr(Type type, ref<Expr> expr, bool nonNegative)
+      : UnaryExpr(type, expr), nonNegative(nonNegative) {}
+  bool nonNegative;
+
+public:
+  static ref<Expr> create(unsigned width, ref<Expr> bv,
+                          bool nonNegative = false);
+  EXPR_KIND(BVZExt)
+  bool isNonNegative() const { return nonNegative; }
+};
+
 class BinaryExpr : public Expr {
+  friend class Expr;
   ref<Expr> lhs, rhs;
 
 protected:
@@ -686,7 +720,7 @@ class UninterpretedFunctionExpr : public Expr {
                             const std::vector<ref<Expr>> &args)
       : Expr(returnType), name(name), args(args) {}
   const std::string name;
-  const std::vector<ref<Expr>> args;
+  std::vector<ref<Expr>> args;
 
 public:
   static ref<Expr> create(const std::string &name, Type returnType,
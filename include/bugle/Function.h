@@ -86,6 +86,8 @@ public:
     return blocks.end();
   }
 
+  OwningPtrVector<BasicBlock> &getBlockVector() { return blocks; }
+
   OwningPtrVector<Var>::const_iterator arg_begin() const {
     return args.begin();
   }
@@ -105,6 +107,8 @@ public:
     return locals.end();
   }
 
+  OwningPtrVector<Var> &getLocalVector() { return locals; }
+
   std::set<std::string>::const_iterator attrib_begin() const {
     return attributes.begin();
   }
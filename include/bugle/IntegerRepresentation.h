@@ -2,9 +2,13 @@
 #define BUGLE_INTEGERREPRESENTATION_H
 
 #include "bugle/Expr.h"
+#include "llvm/Support/ErrorHandling.h"
+#include <set>
 
 namespace bugle {
 
+class Module;
+
 class IntegerRepresentation {
 public:
   virtual std::string getType(unsigned bitWidth) = 0;
@@ -28,6 +32,18 @@ public:
   virtual bool abstractsExtract() = 0;
   virtual bool abstractsConcat() = 0;
 
+  // Representations which write some values as mathematical integers report
+  // those values here. The functions declared by getToMath and getFromMath
+  // convert between the two at the boundaries.
+  virtual bool isMathValue(Expr *E) { return false; }
+  virtual bool isMathVar(Var *V) { return false; }
+  virtual std::string getToMath(unsigned Width) {
+    llvm_unreachable("No values are mathematical integers");
+  }
+  virtual std::string getFromMath(unsigned Width) {
+    llvm_unreachable("No values are mathematical integers");
+  }
+
   virtual ~IntegerRepresentation() {}
 };
 
@@ -54,6 +70,23 @@ public:
   bool abstractsConcat() override;
 };
 
+// Writes values as bitvectors, except for the local variables and temporaries
+// which range analysis proves to stay within [0, 2^(w-1)) and which are not
+// used bitwise. These are written as mathematical integers, whose arithmetic
+// is cheaper for the prover and which agree with both the signed and the
+// unsigned readings of the bitvectors they stand for.
+class HybridIntegerRepresentation : public BVIntegerRepresentation {
+  std::set<Expr *> MathExprs;
+  std::set<Var *> MathVars;
+
+public:
+  void analyse(Module *M);
+  bool isMathValue(Expr *E) override;
+  bool isMathVar(Var *V) override;
+  std::string getToMath(unsigned Width) override;
+  std::string getFromMath(unsigned Width) override;
+};
+
 class MathIntegerRepresentation : public IntegerRepresentation {
 public:
   std::string getType(unsigned bitWidth) override;
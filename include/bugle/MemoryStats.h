@@ -0,0 +1,40 @@
+#ifndef BUGLE_MEMORYSTATS_H
+#define BUGLE_MEMORYSTATS_H
+
+#include "bugle/SourceLoc.h"
+#include "llvm/ADT/StringRef.h"
+#include <cstdint>
+#include <set>
+
+namespace llvm {
+
+class raw_ostream;
+}
+
+namespace bugle {
+
+class Module;
+class Stmt;
+
+// An estimate of the heap memory held by the statements, basic blocks and
+// source locations of a module. Source locations are shared between
+// statements, and are counted once.
+class ModuleMemoryStats {
+  uint64_t StmtCount, StmtBytes;
+  uint64_t BlockCount, BlockBytes;
+  uint64_t SourceLocsCount, SourceLocsBytes;
+
+  std::set<const SourceLocs *> SeenLocs;
+
+  void addStmt(Stmt *S);
+  void addSourceLocs(const SourceLocsRef &SLocs);
+
+public:
+  ModuleMemoryStats(Module *M);
+
+  void print(llvm::raw_ostream &OS) const;
+  void reportCounters(llvm::StringRef Prefix) const;
+};
+}
+
+#endif
@@ -1,7 +1,7 @@
 #ifndef BUGLE_PREPROCESSING_ARGUMENTPROMOTIONPASS_H
 #define BUGLE_PREPROCESSING_ARGUMENTPROMOTIONPASS_H
 
-#include "bugle/Translator/TranslateModule.h"
+#include "bugle/Translator/FunctionClassifier.h"
 #include "llvm/Pass.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/IR/CallSite.h"
@@ -19,8 +19,7 @@ namespace bugle {
 class ArgumentPromotionPass : public llvm::ModulePass {
 private:
   llvm::Module *M;
-  TranslateModule::SourceLanguage SL;
-  std::set<std::string> GPUEntryPoints;
+  FunctionClassifier &FC;
 
   bool needsPromotion(llvm::Function *F);
   bool canPromote(llvm::Function *F);
@@ -36,9 +35,8 @@ private:
 public:
   static char ID;
 
-  ArgumentPromotionPass(TranslateModule::SourceLanguage SL,
-                        std::set<std::string> &EP)
-      : ModulePass(ID), M(nullptr), SL(SL), GPUEntryPoints(EP) {}
+  ArgumentPromotionPass(FunctionClassifier &FC)
+      : ModulePass(ID), M(nullptr), FC(FC) {}
 
   llvm::StringRef getPassName() const override { return "Argument promotion"; }
 
@@ -0,0 +1,45 @@
+#ifndef BUGLE_PREPROCESSING_BOUNDEDUNROLLPASS_H
+#define BUGLE_PREPROCESSING_BOUNDEDUNROLLPASS_H
+
+#include "bugle/Translator/FunctionClassifier.h"
+#include "llvm/Pass.h"
+
+namespace llvm {
+
+class BasicBlock;
+class Loop;
+}
+
+namespace bugle {
+
+// Makes a function loop-free for quick bug finding. Each natural loop is
+// unrolled to the given depth, outermost first. The last copy is followed by
+// one more evaluation of the loop header, whose edges back into the loop go
+// to a block which assumes false, so that paths executing more iterations
+// than the bound are cut rather than verified. Loop
+// invariants are removed, as they no longer apply to any loop.
+
+class BoundedUnrollPass : public llvm::FunctionPass {
+private:
+  FunctionClassifier &FC;
+  unsigned Depth;
+
+  bool removeInvariants(llvm::Function &F);
+  llvm::BasicBlock *createCutBlock(llvm::Function &F, llvm::BasicBlock *Header);
+  void unrollLoop(llvm::Function &F, llvm::Loop *L);
+
+public:
+  static char ID;
+
+  BoundedUnrollPass(FunctionClassifier &FC, unsigned Depth)
+      : FunctionPass(ID), FC(FC), Depth(Depth) {}
+
+  llvm::StringRef getPassName() const override {
+    return "Bounded loop unrolling";
+  }
+
+  bool runOnFunction(llvm::Function &F) override;
+};
+}
+
+#endif
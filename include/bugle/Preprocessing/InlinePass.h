@@ -1,30 +1,38 @@
 #ifndef BUGLE_PREPROCESSING_INLINEPASS_H
 #define BUGLE_PREPROCESSING_INLINEPASS_H
 
-#include "bugle/Translator/TranslateModule.h"
+#include "bugle/Translator/FunctionClassifier.h"
 #include "llvm/Pass.h"
 #include "llvm/Analysis/CallGraph.h"
+#include <map>
 #include <set>
 
 namespace bugle {
 
 // This should be a ModulePass as inlining affects multiple functions.
+//
+// Functions reachable from an entry point are processed bottom-up over the
+// strongly connected components of the call graph, so that each callee is
+// fully inlined before it is itself inlined into its callers.
 
 class InlinePass : public llvm::ModulePass {
 private:
   llvm::Module *M;
-  TranslateModule::SourceLanguage SL;
-  std::set<std::string> GPUEntryPoints;
+  FunctionClassifier &FC;
+  std::map<llvm::Function *, unsigned> FunctionSizes;
+  unsigned InlinedCount;
+  std::map<std::string, unsigned> NotInlinedCounts;
 
-  bool doInline(llvm::Instruction *I, llvm::Function *OF);
-  void doInline(llvm::BasicBlock *B, llvm::Function *OF);
+  void checkCalls(llvm::Function *F);
+  const char *getReasonNotInlined(llvm::Function *F, llvm::Function *Callee);
   void doInline(llvm::Function *F);
+  void writeReport(llvm::raw_ostream &OS);
 
 public:
   static char ID;
 
-  InlinePass(TranslateModule::SourceLanguage SL, std::set<std::string> &EP)
-      : ModulePass(ID), M(0), SL(SL), GPUEntryPoints(EP) {}
+  InlinePass(FunctionClassifier &FC)
+      : ModulePass(ID), M(0), FC(FC), InlinedCount(0) {}
 
   llvm::StringRef getPassName() const override { return "Function inlining"; }
 
@@ -0,0 +1,58 @@
+#ifndef BUGLE_PREPROCESSING_LOOPUNROLLPASS_H
+#define BUGLE_PREPROCESSING_LOOPUNROLLPASS_H
+
+#include "bugle/Translator/FunctionClassifier.h"
+#include "llvm/Pass.h"
+#include "llvm/Analysis/AssumptionCache.h"
+#include "llvm/Analysis/LoopInfo.h"
+#include "llvm/Analysis/ScalarEvolution.h"
+#include "llvm/IR/Dominators.h"
+#include "llvm/InitializePasses.h"
+#include "llvm/Transforms/Utils.h"
+
+namespace bugle {
+
+// Fully unrolls innermost loops whose trip count is a constant no larger than
+// the given threshold, so that no invariant needs to be inferred for them.
+// Loops containing barriers, loop invariants, or calls to functions which may
+// themselves contain barriers are left alone.
+
+class LoopUnrollPass : public llvm::FunctionPass {
+private:
+  FunctionClassifier &FC;
+  unsigned Threshold;
+
+  bool isUnrollable(llvm::Loop *L);
+
+public:
+  static char ID;
+
+  LoopUnrollPass(FunctionClassifier &FC, unsigned Threshold)
+      : FunctionPass(ID), FC(FC), Threshold(Threshold) {
+    llvm::PassRegistry &Registry = *llvm::PassRegistry::getPassRegistry();
+    initializeAssumptionCacheTrackerPass(Registry);
+    initializeDominatorTreeWrapperPassPass(Registry);
+    initializeLCSSAWrapperPassPass(Registry);
+    initializeLoopInfoWrapperPassPass(Registry);
+    initializeLoopSimplifyPass(Registry);
+    initializeScalarEvolutionWrapperPassPass(Registry);
+  }
+
+  llvm::StringRef getPassName() const override {
+    return "Full unrolling of constant trip count loops";
+  }
+
+  void getAnalysisUsage(llvm::AnalysisUsage &AU) const override {
+    AU.addRequired<llvm::AssumptionCacheTracker>();
+    AU.addRequired<llvm::DominatorTreeWrapperPass>();
+    AU.addRequired<llvm::LoopInfoWrapperPass>();
+    AU.addRequired<llvm::ScalarEvolutionWrapperPass>();
+    AU.addRequiredID(llvm::LoopSimplifyID);
+    AU.addRequiredID(llvm::LCSSAID);
+  }
+
+  bool runOnFunction(llvm::Function &F) override;
+};
+}
+
+#endif
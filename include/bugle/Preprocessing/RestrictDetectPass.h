@@ -1,6 +1,7 @@
 #ifndef BUGLE_PREPROCESSING_RESTRICTDETECTPASS_H
 #define BUGLE_PREPROCESSING_RESTRICTDETECTPASS_H
 
+#include "bugle/Translator/FunctionClassifier.h"
 #include "bugle/Translator/TranslateModule.h"
 #include "llvm/Pass.h"
 #include "llvm/IR/DebugInfo.h"
@@ -11,8 +12,8 @@ class RestrictDetectPass : public llvm::FunctionPass {
 private:
   llvm::Module *M;
   llvm::DebugInfoFinder DIF;
+  FunctionClassifier &FC;
   TranslateModule::SourceLanguage SL;
-  std::set<std::string> GPUEntryPoints;
   TranslateModule::AddressSpaceMap AddressSpaces;
 
   const llvm::DISubprogram *getDebugInfo(llvm::Function *F);
@@ -23,10 +24,10 @@ private:
 public:
   static char ID;
 
-  RestrictDetectPass(TranslateModule::SourceLanguage SL,
-                     std::set<std::string> &EP,
-                     TranslateModule::AddressSpaceMap &AS)
-      : FunctionPass(ID), M(0), SL(SL), GPUEntryPoints(EP), AddressSpaces(AS) {}
+  RestrictDetectPass(FunctionClassifier &FC,
+                     const TranslateModule::AddressSpaceMap &AS)
+      : FunctionPass(ID), M(0), FC(FC), SL(FC.getSourceLanguage()),
+        AddressSpaces(AS) {}
 
   llvm::StringRef getPassName() const override {
     return "Detect restrict usage on global pointers";
@@ -1,16 +1,14 @@
 #ifndef BUGLE_PREPROCESSING_SIMPLEINTERNALIZEPASS_H
 #define BUGLE_PREPROCESSING_SIMPLEINTERNALIZEPASS_H
 
-#include "bugle/Translator/TranslateModule.h"
+#include "bugle/Translator/FunctionClassifier.h"
 #include "llvm/Pass.h"
 
 namespace bugle {
 
 class SimpleInternalizePass : public llvm::ModulePass {
 private:
-  llvm::Module *M;
-  TranslateModule::SourceLanguage SL;
-  std::set<std::string> GPUEntryPoints;
+  FunctionClassifier &FC;
   bool OnlyExplicitEntryPoints;
 
   bool isEntryPoint(llvm::Function *F);
@@ -19,10 +17,8 @@ private:
 public:
   static char ID;
 
-  SimpleInternalizePass(TranslateModule::SourceLanguage SL,
-                        std::set<std::string> &EP, bool EEP)
-      : ModulePass(ID), M(nullptr), SL(SL), GPUEntryPoints(EP),
-        OnlyExplicitEntryPoints(EEP) {}
+  SimpleInternalizePass(FunctionClassifier &FC, bool EEP)
+      : ModulePass(ID), FC(FC), OnlyExplicitEntryPoints(EEP) {}
 
   llvm::StringRef getPassName() const override {
     return "Internalize all normal functions that are not entry points";
@@ -31,6 +31,13 @@ public:
   virtual ~Stmt() {}
   virtual Kind getKind() const = 0;
   virtual SourceLocsRef &getSourceLocs() { return sourcelocs; }
+  // Append the expressions used by this statement to Ops. The expression of
+  // an EvalStmt names the value of the statement, so its subexpressions are
+  // appended instead.
+  void getOperands(std::vector<Expr *> &Ops) const;
+  // Replace each expression E used by this statement, in the same sense,
+  // with F(E), which must have the same type and value as E.
+  void replaceOperands(const std::function<ref<Expr>(Expr *)> &F);
 
 protected:
   Stmt() {}
@@ -41,6 +48,7 @@ private:
 };
 
 #define STMT_KIND(kind)                                                        \
+  friend class Stmt;                                                           \
   Kind getKind() const override { return kind; }                               \
   static bool classof(const Stmt *S) { return S->getKind() == kind; }          \
   static bool classof(const kind##Stmt *) { return true; }
@@ -124,13 +132,20 @@ public:
 
 class AssumeStmt : public Stmt {
   AssumeStmt(ref<Expr> pred, bool partition)
-      : pred(pred), partition(partition) {}
+      : pred(pred), partition(partition), groupUniform(false),
+        uniform(false) {}
   ref<Expr> pred;
   bool partition;
+  bool groupUniform;
+  bool uniform;
 
 public:
   static AssumeStmt *create(ref<Expr> pred);
-  static AssumeStmt *createPartition(ref<Expr> pred);
+  // A partition is uniform if the branch it stems from is taken the same way
+  // by all threads of the grid, and group uniform if by all threads of each
+  // work-group.
+  static AssumeStmt *createPartition(ref<Expr> pred, bool groupUniform = false,
+                                     bool uniform = false);
 
   SourceLocsRef &getSourceLocs() override {
     llvm_unreachable("No source location");
@@ -139,6 +154,8 @@ public:
   STMT_KIND(Assume)
   ref<Expr> getPredicate() const { return pred; }
   bool isPartition() const { return partition; }
+  bool isGroupUniform() const { return groupUniform; }
+  bool isUniform() const { return uniform; }
 };
 
 class AssertStmt : public Stmt {
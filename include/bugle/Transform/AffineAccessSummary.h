@@ -0,0 +1,14 @@
+#ifndef BUGLE_TRANSFORM_AFFINEACCESSSUMMARY_H
+#define BUGLE_TRANSFORM_AFFINEACCESSSUMMARY_H
+
+namespace bugle {
+
+class Module;
+
+// Attach to each function an affine_access attribute for every distinct
+// affine access function with which it reads, writes or atomically accesses
+// a global or group-shared array.
+void summarizeAffineAccesses(Module *M);
+}
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef BUGLE_TRANSFORM_CONSTANTPROPAGATION_H
+#define BUGLE_TRANSFORM_CONSTANTPROPAGATION_H
+
+namespace bugle {
+
+class Module;
+
+// Propagate constants through the variables assigned by each function, taking
+// only the blocks whose partition assumptions may hold into account. Branches
+// to blocks whose assumptions cannot hold are removed, and the expressions
+// which become constant are folded.
+void propagateConstants(Module *M);
+}
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef BUGLE_TRANSFORM_GLOBALVALUENUMBERING_H
+#define BUGLE_TRANSFORM_GLOBALVALUENUMBERING_H
+
+namespace bugle {
+
+class Module;
+
+// Replace each pure expression evaluated by an EvalStmt with an equivalent
+// expression evaluated by a dominating EvalStmt, if there is one, so that
+// the value is computed once and read from its variable thereafter.
+void numberGlobalValues(Module *M);
+}
+
+#endif
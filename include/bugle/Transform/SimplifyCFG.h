@@ -0,0 +1,14 @@
+#ifndef BUGLE_TRANSFORM_SIMPLIFYCFG_H
+#define BUGLE_TRANSFORM_SIMPLIFYCFG_H
+
+namespace bugle {
+
+class Module;
+
+// Reduce the number of blocks of each function, by retargeting branches to
+// blocks which only branch on to another block, and merging each block with
+// its successor if it is that block's only predecessor.
+void simplifyCFG(Module *M);
+}
+
+#endif
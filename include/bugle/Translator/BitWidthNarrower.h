@@ -0,0 +1,33 @@
+#ifndef BUGLE_TRANSLATOR_BITWIDTHNARROWER_H
+#define BUGLE_TRANSLATOR_BITWIDTHNARROWER_H
+
+#include "bugle/Ref.h"
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace bugle {
+
+class Expr;
+
+// Re-expresses additions, multiplications and left shifts at the narrowest
+// width at which they cannot wrap around and their sign bit is clear,
+// zero-extending the result back to the original width with an extension
+// marked as non-negative. Bounds are derived from constants, from the widths
+// of zero-extended operands and from the bounds given for special variables,
+// such as the local and group ids of a launch whose dimensions are known.
+class BitWidthNarrower {
+  std::map<std::string, uint64_t> SpecialVarBounds;
+
+  uint64_t getUpperBound(Expr *E, unsigned Depth);
+  ref<Expr> truncate(ref<Expr> E, unsigned Width);
+
+public:
+  void addSpecialVarBound(const std::string &Name, uint64_t Bound) {
+    SpecialVarBounds[Name] = Bound;
+  }
+  ref<Expr> narrow(ref<Expr> E);
+};
+}
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef BUGLE_TRANSLATOR_FUNCTIONCLASSIFIER_H
+#define BUGLE_TRANSLATOR_FUNCTIONCLASSIFIER_H
+
+#include "bugle/Translator/TranslateModule.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include <set>
+#include <string>
+
+namespace llvm {
+
+class Function;
+class Module;
+}
+
+namespace bugle {
+
+// Classifies the functions of a module once, so that the preprocessing passes
+// and the translator can query the kind of a function without repeated name
+// lookups or scans of the kernel metadata. Kinds are computed on first query
+// and cached; invalidate() must be called after a pass replaces functions.
+class FunctionClassifier {
+public:
+  enum Kind {
+    FK_Intrinsic,
+    FK_Axiom,
+    FK_Uninterpreted,
+    FK_Special,
+    FK_Specification,
+    FK_Barrier,
+    FK_GridBarrier,
+    // All kinds from here on are normal functions.
+    FK_Kernel,
+    FK_StandardEntryPoint,
+    FK_Normal
+  };
+
+private:
+  llvm::Module *M;
+  TranslateModule::SourceLanguage SL;
+  std::set<std::string> GPUEntryPoints;
+
+  llvm::DenseMap<const llvm::Function *, Kind> Kinds;
+  llvm::SmallPtrSet<const llvm::Function *, 8> AnnotatedKernels;
+  bool AnnotatedKernelsValid;
+
+  void computeAnnotatedKernels();
+  Kind classify(llvm::Function *F);
+
+public:
+  FunctionClassifier(llvm::Module *M, TranslateModule::SourceLanguage SL,
+                     const std::set<std::string> &EP)
+      : M(M), SL(SL), GPUEntryPoints(EP), AnnotatedKernelsValid(false) {}
+
+  TranslateModule::SourceLanguage getSourceLanguage() const { return SL; }
+
+  Kind getKind(llvm::Function *F) {
+    auto i = Kinds.find(F);
+    if (i != Kinds.end())
+      return i->second;
+    return Kinds[F] = classify(F);
+  }
+
+  bool isNormalFunction(llvm::Function *F) { return getKind(F) >= FK_Kernel; }
+  bool isGPUEntryPoint(llvm::Function *F) { return getKind(F) == FK_Kernel; }
+  bool isEntryPoint(llvm::Function *F) {
+    Kind K = getKind(F);
+    return K == FK_Kernel || K == FK_StandardEntryPoint;
+  }
+  // Whether the function was named as an entry point on the command line.
+  bool isExplicitEntryPoint(llvm::Function *F);
+  // Whether the function specifies an invariant of the loop it is called in.
+  // Function-wide invariants are not loop invariants, as they must occur at
+  // the end of a function.
+  bool isLoopInvariantFunction(llvm::Function *F);
+
+  void invalidate();
+};
+}
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef BUGLE_TRANSLATOR_SPECIALFUNCTIONTABLE_H
+#define BUGLE_TRANSLATOR_SPECIALFUNCTIONTABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace bugle {
+
+// The tables of special functions are generated at build time by
+// bugle-specialfn-gen, which computes a perfect hash of the names for each
+// source language. Families of functions which share a prefix, such as the
+// axioms, are stored under their prefix in the same table.
+
+enum SpecialFnKind {
+  SFK_None,
+  // A function which is handled by the translator and not translated itself.
+  SFK_Function,
+  // Prefix families.
+  SFK_Axiom,
+  SFK_Uninterpreted,
+  SFK_Specification,
+  // Calls to these are handled by the translator, but the functions are
+  // otherwise normal.
+  SFK_FreshArray
+};
+
+const uint16_t NoSpecialFnHandler = 0xffff;
+
+struct SpecialFnEntry {
+  const char *Name;
+  uint16_t Length;
+  uint8_t Kind;
+  uint8_t IsPrefix;
+  uint16_t Handler;
+};
+
+inline uint32_t hashSpecialFnName(const char *Name, size_t Length,
+                                  uint32_t Seed) {
+  // FNV-1a, seeded, with a final avalanche step.
+  uint32_t H = (2166136261u ^ Seed) * 16777619u;
+  for (size_t i = 0; i != Length; ++i) {
+    H ^= (unsigned char)Name[i];
+    H *= 16777619u;
+  }
+  H ^= H >> 15;
+  H *= 0x2c1b3c6du;
+  H ^= H >> 12;
+  return H;
+}
+
+struct SpecialFnTable {
+  // Both sizes are powers of two.
+  const SpecialFnEntry *Entries;
+  uint32_t EntryMask;
+  const uint32_t *Displacements;
+  uint32_t DisplacementMask;
+  // Distinct lengths of the prefixes in the table, longest first.
+  const uint8_t *PrefixLengths;
+  unsigned NumPrefixLengths;
+
+  const SpecialFnEntry *find(const char *Name, size_t Length) const {
+    uint32_t D =
+        Displacements[hashSpecialFnName(Name, Length, 0) & DisplacementMask];
+    const SpecialFnEntry &E =
+        Entries[hashSpecialFnName(Name, Length, D) & EntryMask];
+    if (E.Name && E.Length == Length && std::memcmp(E.Name, Name, Length) == 0)
+      return &E;
+    return nullptr;
+  }
+
+  const SpecialFnEntry *lookup(const char *Name, size_t Length) const {
+    if (auto *E = find(Name, Length))
+      return E;
+    for (unsigned i = 0; i != NumPrefixLengths; ++i) {
+      if (PrefixLengths[i] > Length)
+        continue;
+      auto *E = find(Name, PrefixLengths[i]);
+      if (E && E->IsPrefix)
+        return E;
+    }
+    return nullptr;
+  }
+};
+}
+
+#endif
@@ -3,10 +3,13 @@
 
 #include "bugle/Ref.h"
 #include "bugle/Stmt.h"
+#include "bugle/Translator/SpecialFunctionTable.h"
 #include "bugle/Translator/TranslateModule.h"
-#include "llvm/ADT/StringMap.h"
+#include "bugle/Translator/UniformityAnalysis.h"
+#include "llvm/ADT/StringRef.h"
 #include <functional>
 #include <map>
+#include <memory>
 #include <vector>
 
 namespace llvm {
@@ -31,10 +34,6 @@ class Var;
 class TranslateFunction {
   typedef ref<Expr> SpecialFnHandler(BasicBlock *, llvm::CallInst *,
                                      const std::vector<klee::ref<Expr>> &);
-  struct SpecialFnMapTy {
-    llvm::StringMap<SpecialFnHandler TranslateFunction::*> Functions;
-    std::map<unsigned, SpecialFnHandler TranslateFunction::*> Intrinsics;
-  };
 
   typedef std::pair<llvm::Value *, ref<Expr>> PhiPair;
 
@@ -52,9 +51,10 @@ class TranslateFunction {
   std::map<unsigned, bugle::Function *> BarrierInvariants;
   std::map<unsigned, bugle::Function *> BinaryBarrierInvariants;
   SourceLocsRef currentSourceLocs;
+  std::unique_ptr<UniformityAnalysis> UA;
 
-  SpecialFnMapTy &SpecialFunctionMap;
-  static SpecialFnMapTy SpecialFunctionMaps[TranslateModule::SL_Count];
+  // Indexed by the handler of an entry in the special function tables.
+  static SpecialFnHandler TranslateFunction::*const SpecialFnHandlers[];
 
   SpecialFnHandler handleNoop, handleAssertFail, handleAssume, handleAssert,
       handleGlobalAssert, handleCandidateAssert, handleCandidateGlobalAssert,
@@ -78,17 +78,23 @@ class TranslateFunction {
       handleGetImageWidth, handleGetImageHeight, handleSamplerInitializer,
       handleAsyncWorkGroupCopy, handleWaitGroupEvents;
 
-  SpecialFnHandler handleCeil, handleCtpop, handleCos, handleCtlz, handleExp,
-      handleExp2, handleFabs, handleFmax, handleFmin, handleFloor,
-      handleFrexpExp, handleFrexpFrac, handleFma, handleLog, handleLog10,
-      handleLog2, handlePow, handlePowi, handleRint, handleRsqrt, handleSaddOvl,
-      handleSin, handleSqrt, handleSsubOvl, handleTrunc, handleUaddOvl,
-      handleUsubOvl;
+  SpecialFnHandler handleBitreverse, handleBswap, handleCeil, handleCtpop,
+      handleCos, handleCtlz, handleExp, handleExp2, handleFabs, handleFmax,
+      handleFmin, handleFloor, handleFrexpExp, handleFrexpFrac, handleFma,
+      handleLog, handleLog10, handleLog2, handlePow, handlePowi, handleRint,
+      handleRsqrt, handleSaddOvl, handleSin, handleSqrt, handleSsubOvl,
+      handleTrunc, handleUaddOvl, handleUmulOvl, handleUsubOvl;
 
   SpecialFnHandler handleAtomic;
 
-  static SpecialFnMapTy &
-  initSpecialFunctionMap(TranslateModule::SourceLanguage SL);
+  static const SpecialFnEntry *
+  lookupSpecialFunction(TranslateModule::SourceLanguage SL,
+                        llvm::StringRef fnName);
+  static SpecialFnHandler TranslateFunction::*
+  getSpecialFunctionHandler(TranslateModule::SourceLanguage SL,
+                            llvm::StringRef fnName);
+  static SpecialFnHandler TranslateFunction::*
+  getIntrinsicHandler(unsigned ID);
 
   ref<Expr>
   maybeTranslateSIMDInst(bugle::BasicBlock *BBB, llvm::Type *Ty,
@@ -107,6 +113,8 @@ class TranslateFunction {
                       std::vector<ref<Expr>> &assigns);
   void addPhiAssigns(BasicBlock *BBB, llvm::BasicBlock *Pred,
                      llvm::BasicBlock *Succ);
+  AssumeStmt *createPartition(ref<Expr> Pred, llvm::Value *Cond);
+  void addControlFlowUniformity();
   SourceLocsRef extractSourceLocsForBlock(llvm::BasicBlock *BB);
   SourceLocsRef extractSourceLocs(llvm::Instruction *I);
   void specifyZeroDimensions(unsigned PtrArgs);
@@ -119,23 +127,22 @@ public:
   TranslateFunction(TranslateModule *TM, bugle::Function *BF, llvm::Function *F,
                     bool isGPUEntryPoint)
       : TM(TM), BF(BF), F(F), isGPUEntryPoint(isGPUEntryPoint), ReturnVar(0),
-        LoadsAreTemporal(true), currentSourceLocs(new SourceLocs),
-        SpecialFunctionMap(initSpecialFunctionMap(TM->SL)) {}
+        LoadsAreTemporal(true), currentSourceLocs(new SourceLocs) {}
 
+  // The kind of special function with the given name, including the prefix
+  // families of axioms, uninterpreted and specification functions.
+  static SpecialFnKind
+  getSpecialFunctionKind(TranslateModule::SourceLanguage SL,
+                         llvm::StringRef fnName);
   static bool isSpecialFunction(TranslateModule::SourceLanguage SL,
-                                const std::string &fnName);
-  static void addUninterpretedFunction(TranslateModule::SourceLanguage SL,
-                                       const std::string &fnName);
-  static bool isAxiomFunction(llvm::StringRef fnName);
-  static bool isUninterpretedFunction(llvm::StringRef fnName);
-  static bool isSpecificationFunction(llvm::StringRef fnName);
+                                llvm::StringRef fnName) {
+    return getSpecialFunctionKind(SL, fnName) == SFK_Function;
+  }
   static bool isPreOrPostCondition(llvm::StringRef fnName);
   static bool isBarrierFunction(TranslateModule::SourceLanguage SL,
                                 llvm::StringRef fnName);
   static bool isGridBarrierFunction(TranslateModule::SourceLanguage SL,
                                 llvm::StringRef fnName);
-  static bool isNormalFunction(TranslateModule::SourceLanguage SL,
-                               llvm::Function *F);
   static bool isStandardEntryPoint(TranslateModule::SourceLanguage SL,
                                    llvm::StringRef fnName);
   static bool isRequiresFreshArrayFunction(llvm::StringRef fnName);
@@ -4,6 +4,7 @@
 #include "bugle/RaceInstrumenter.h"
 #include "bugle/Ref.h"
 #include "bugle/SourceLoc.h"
+#include "bugle/Translator/BitWidthNarrower.h"
 #include "bugle/Type.h"
 #include "klee/util/GetElementPtrTypeIterator.h"
 #include "llvm/ADT/ArrayRef.h"
@@ -29,12 +30,14 @@ namespace bugle {
 
 class Expr;
 class Function;
+class FunctionClassifier;
 class GlobalArray;
 class Module;
 class Stmt;
 class Var;
 
 typedef std::vector<std::pair<bool, uint64_t>> ArraySpec;
+typedef std::map<std::string, int64_t> ArgValueSpec;
 
 class TranslateModule {
 public:
@@ -54,16 +57,31 @@ public:
     AddressSpaceMap(unsigned Global, unsigned GroupShared, unsigned Constant);
   };
 
+  // Each dimension of a launch is paired with whether its value is known.
+  typedef std::vector<std::pair<bool, uint64_t>> LaunchDims;
+
+  // The parts of the launch configuration which are known at translation
+  // time. These are translated to constants rather than special variables.
+  struct LaunchConfiguration {
+    LaunchDims LocalSize, NumGroups, GlobalOffset;
+    std::pair<bool, uint64_t> WorkDim;
+    LaunchConfiguration() : WorkDim(false, 0) {}
+  };
+
 private:
   bugle::Module *BM;
   llvm::Module *M;
   llvm::DebugInfoFinder DIF;
   llvm::DataLayout TD;
   SourceLanguage SL;
-  std::set<std::string> GPUEntryPoints;
+  FunctionClassifier &FC;
   RaceInstrumenter RaceInst;
   AddressSpaceMap AddressSpaces;
   std::map<std::string, ArraySpec> GPUArraySizes;
+  LaunchConfiguration Launch;
+  std::map<std::string, ArgValueSpec> GPUArgValues;
+  bool NarrowBitWidths;
+  BitWidthNarrower Narrower;
 
   std::map<llvm::Function *, bugle::Function *> FunctionMap;
   std::map<llvm::Function *, std::vector<llvm::Instruction *> *> StructMap;
@@ -85,8 +103,12 @@ private:
 
   ref<Expr> translate1dCUDABuiltinGlobal(std::string Prefix,
                                          llvm::GlobalVariable *GV);
-  ref<Expr> translate3dCUDABuiltinGlobal(std::string Prefix,
-                                         llvm::GlobalVariable *GV);
+  ref<Expr>
+  translate3dCUDABuiltinGlobal(std::string Prefix, llvm::GlobalVariable *GV,
+                               const LaunchDims &Known = LaunchDims());
+  ref<Expr> translateLaunchDim(Type T, const std::string &Prefix,
+                               const LaunchDims &Known, unsigned Dim);
+  void addLaunchBounds();
 
   void translateGlobalInit(GlobalArray *GA, unsigned Offset,
                            llvm::Constant *Init);
@@ -120,6 +142,7 @@ private:
   ref<Expr> translateArbitrary(Type t);
   ref<Expr> translateICmp(llvm::CmpInst::Predicate P, ref<Expr> LHS,
                           ref<Expr> RHS);
+  ref<Expr> narrowBitWidth(ref<Expr> E);
 
   ref<Expr>
   maybeTranslateSIMDInst(llvm::Type *Ty, llvm::Type *OpTy, ref<Expr> Op,
@@ -150,15 +173,20 @@ private:
                                                       llvm::Function *F);
 
 public:
-  TranslateModule(llvm::Module *M, SourceLanguage SL, std::set<std::string> &EP,
-                  RaceInstrumenter RI, AddressSpaceMap &AS,
-                  std::map<std::string, ArraySpec> &GAS)
-      : BM(nullptr), M(M), TD(M), SL(SL), GPUEntryPoints(EP), RaceInst(RI),
-        AddressSpaces(AS), GPUArraySizes(GAS),
-        NeedAdditionalByteArrayModels(false), ModelAllAsByteArray(false),
-        NextModelAllAsByteArray(false),
+  TranslateModule(llvm::Module *M, SourceLanguage SL, FunctionClassifier &FC,
+                  RaceInstrumenter RI, const AddressSpaceMap &AS,
+                  const std::map<std::string, ArraySpec> &GAS,
+                  const LaunchConfiguration &LC = LaunchConfiguration(),
+                  const std::map<std::string, ArgValueSpec> &GAV =
+                      std::map<std::string, ArgValueSpec>(),
+                  bool NBW = false)
+      : BM(nullptr), M(M), TD(M), SL(SL), FC(FC), RaceInst(RI),
+        AddressSpaces(AS), GPUArraySizes(GAS), Launch(LC), GPUArgValues(GAV),
+        NarrowBitWidths(NBW), NeedAdditionalByteArrayModels(false),
+        ModelAllAsByteArray(false), NextModelAllAsByteArray(false),
         NeedAdditionalGlobalOffsetModels(false) {
     DIF.processModule(*M);
+    addLaunchBounds();
   }
 
   ~TranslateModule() {
@@ -169,8 +197,6 @@ public:
     }
   }
 
-  static bool isGPUEntryPoint(llvm::Function *F, llvm::Module *M,
-                              SourceLanguage SL, std::set<std::string> &EPS);
   std::string getSourceFunctionName(llvm::Function *F);
   static std::string getSourceGlobalArrayName(llvm::Value *V);
   static std::string getSourceName(llvm::Value *V, llvm::Function *F);
@@ -0,0 +1,62 @@
+#ifndef BUGLE_TRANSLATOR_UNIFORMITYANALYSIS_H
+#define BUGLE_TRANSLATOR_UNIFORMITYANALYSIS_H
+
+#include "bugle/Translator/TranslateModule.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallPtrSet.h"
+
+namespace llvm {
+
+class BasicBlock;
+class Function;
+class Instruction;
+class PostDominatorTree;
+class Value;
+}
+
+namespace bugle {
+
+// Computes which values of a function are the same for all threads of a
+// work-group, or of the whole grid. Divergence originates from the local
+// thread id, from loads of memory which may differ between threads and from
+// calls which are not known to be uniform, and is propagated through data
+// dependences and through the control dependences of divergent branches.
+//
+// The arguments of kernels are uniform; those of other functions are
+// assumed to be divergent, as nothing is known about their callers.
+class UniformityAnalysis {
+public:
+  // Ordered so that joining two values is taking the maximum.
+  enum Uniformity { Uniform, GroupUniform, Divergent };
+
+private:
+  llvm::Function *F;
+  TranslateModule::SourceLanguage SL;
+  bool IsKernel;
+  unsigned ConstantAddrSpace;
+
+  llvm::DenseMap<llvm::Value *, Uniformity> Values;
+  // The uniformity of the phi nodes of each block, due to the divergent
+  // branches of which the block is a join point.
+  llvm::DenseMap<llvm::BasicBlock *, Uniformity> JoinUniformity;
+  // The uniformity of the branch of each block as last propagated.
+  llvm::DenseMap<llvm::BasicBlock *, Uniformity> BranchUniformity;
+
+  bool raise(llvm::Value *V, Uniformity U);
+  Uniformity getOperandUniformity(llvm::Instruction *I);
+  Uniformity getCallUniformity(llvm::Instruction *I);
+  Uniformity getLoadUniformity(llvm::Value *Ptr);
+  Uniformity computeUniformity(llvm::Instruction *I);
+  bool propagateBranch(llvm::BasicBlock *BB, Uniformity U,
+                       llvm::PostDominatorTree &PDT);
+  void analyse();
+
+public:
+  UniformityAnalysis(llvm::Function *F, TranslateModule::SourceLanguage SL,
+                     bool IsKernel, unsigned ConstantAddrSpace);
+
+  Uniformity getUniformity(llvm::Value *V) const;
+};
+}
+
+#endif
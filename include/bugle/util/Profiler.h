@@ -0,0 +1,66 @@
+#ifndef BUGLE_UTIL_PROFILER_H
+#define BUGLE_UTIL_PROFILER_H
+
+#include "llvm/ADT/StringRef.h"
+#include <cstdint>
+
+namespace llvm {
+
+class ModulePass;
+class raw_ostream;
+}
+
+namespace bugle {
+
+// Collects a tree of timed phases and a set of named counters. Each phase also
+// records the heap in use at its start and end, and the peak RSS of the
+// process at its end. Collection is disabled by default, in which case all
+// recording functions return immediately.
+class Profiler {
+private:
+  Profiler();
+
+  static bool Enabled;
+
+public:
+  static void enable();
+  static bool isEnabled() { return Enabled; }
+
+  static void beginPhase(llvm::StringRef Name, llvm::StringRef Category);
+  static void endPhase();
+  static void addToCounter(llvm::StringRef Name, uint64_t Amount = 1);
+
+  // The peak resident set size of the process so far, in kilobytes, or 0 if
+  // this is unavailable. Available whether or not collection is enabled.
+  static uint64_t getMaxRSS();
+
+  // Write the phase tree and the counters as a JSON object.
+  static void writeJSON(llvm::raw_ostream &OS);
+  // Write the phases in the Chrome trace-event format.
+  static void writeTrace(llvm::raw_ostream &OS);
+  // Print the memory use recorded for each top-level phase.
+  static void printPhaseMemory(llvm::raw_ostream &OS);
+};
+
+class ScopedPhase {
+  bool Active;
+
+public:
+  ScopedPhase(llvm::StringRef Name, llvm::StringRef Category = "phase")
+      : Active(Profiler::isEnabled()) {
+    if (Active)
+      Profiler::beginPhase(Name, Category);
+  }
+  ~ScopedPhase() {
+    if (Active)
+      Profiler::endPhase();
+  }
+};
+
+// Passes which open and close a phase, used to time the passes of a
+// legacy::PassManager pipeline.
+llvm::ModulePass *createBeginPhasePass(llvm::StringRef Name);
+llvm::ModulePass *createEndPhasePass();
+}
+
+#endif
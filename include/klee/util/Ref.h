@@ -32,14 +32,22 @@ public:
   ~ref () { dec (); }
 
 private:
+  // T may observe reference count changes for statistics purposes.
   void inc() const {
-    if (ptr)
+    if (ptr) {
+      if (T::TrackAllocation)
+        T::noteIncrement(ptr);
       ++ptr->refCount;
+    }
   }
 
   void dec() const {
-    if (ptr && --ptr->refCount == 0)
-      delete ptr;
+    if (ptr) {
+      if (T::TrackAllocation)
+        T::noteDecrement(ptr);
+      if (--ptr->refCount == 0)
+        delete ptr;
+    }
   }
 
 public:
@@ -36,7 +36,188 @@ struct ScopedParenPrinter {
 
 BPLExprWriter::~BPLExprWriter() {}
 
+// A comparison is written on integers if one side is written as an integer
+// and the other is too, or is a constant. Constants compared unsigned must
+// be nonnegative to read the same as integers.
+bool BPLExprWriter::isMathOperand(Expr *E, bool Unsigned) {
+  if (MW->IntRep->isMathValue(E))
+    return true;
+  auto *CE = dyn_cast<BVConstExpr>(E);
+  return CE && CE->getValue().getBitWidth() <= 64 &&
+         (!Unsigned || !CE->getValue().isNegative());
+}
+
+bool BPLExprWriter::writeMathComparison(llvm::raw_ostream &OS, BinaryExpr *E,
+                                        const char *Op, bool Unsigned) {
+  Expr *LHS = E->getLHS().get(), *RHS = E->getRHS().get();
+  if (!LHS->getType().isKind(Type::BV) ||
+      (!MW->IntRep->isMathValue(LHS) && !MW->IntRep->isMathValue(RHS)) ||
+      !isMathOperand(LHS, Unsigned) || !isMathOperand(RHS, Unsigned))
+    return false;
+
+  OS << "(";
+  writeMathExpr(OS, LHS);
+  OS << " " << Op << " ";
+  writeMathExpr(OS, RHS);
+  OS << ")";
+  return true;
+}
+
+// Pointers are equal if both their array ids and their offsets are, which
+// saves packing pointers which are held in split form.
+bool BPLExprWriter::writeSplitPointerComparison(llvm::raw_ostream &OS,
+                                                BinaryExpr *E, bool Eq) {
+  Expr *LHS = E->getLHS().get(), *RHS = E->getRHS().get();
+  if (!MW->SplitPointers || !LHS->getType().isKind(Type::Pointer))
+    return false;
+
+  const char *Op = Eq ? " == " : " != ";
+  OS << "(";
+  writePointerPart(OS, LHS, false);
+  OS << Op;
+  writePointerPart(OS, RHS, false);
+  OS << (Eq ? " && " : " || ");
+  writePointerPart(OS, LHS, true);
+  OS << Op;
+  writePointerPart(OS, RHS, true);
+  OS << ")";
+  return true;
+}
+
+void BPLExprWriter::writeMathExpr(llvm::raw_ostream &OS, Expr *E) {
+  unsigned Width = E->getType().width;
+  if (auto *CE = dyn_cast<BVConstExpr>(E)) {
+    if (CE->getValue().isNegative())
+      OS << "(" << CE->getValue().getSExtValue() << ")";
+    else
+      OS << CE->getValue().getZExtValue();
+    return;
+  }
+
+  if (!MW->IntRep->isMathValue(E)) {
+    OS << "BV" << Width << "_TO_INT(";
+    writeExpr(OS, E);
+    OS << ")";
+    MW->writeIntrinsic(
+        [&](llvm::raw_ostream &OS) { OS << MW->IntRep->getToMath(Width); },
+        false);
+    return;
+  }
+
+  if (writeSSAVar(OS, E))
+    return;
+
+  if (auto *VarE = dyn_cast<VarRefExpr>(E)) {
+    OS << "$" << VarE->getVar()->getName();
+  } else if (isa<BVZExtExpr>(E) || isa<BVSExtExpr>(E)) {
+    writeMathExpr(OS, cast<UnaryExpr>(E)->getSubExpr().get());
+  } else if (auto *EE = dyn_cast<BVExtractExpr>(E)) {
+    writeMathExpr(OS, EE->getSubExpr().get());
+  } else if (auto *BinE = dyn_cast<BinaryExpr>(E)) {
+    const char *Op;
+    switch (BinE->getKind()) {
+    case Expr::BVAdd: Op = "+"; break;
+    case Expr::BVSub: Op = "-"; break;
+    case Expr::BVMul: Op = "*"; break;
+    default:
+      llvm_unreachable("Unsupported integer expr");
+    }
+    OS << "(";
+    writeMathExpr(OS, BinE->getLHS().get());
+    OS << " " << Op << " ";
+    writeMathExpr(OS, BinE->getRHS().get());
+    OS << ")";
+  } else {
+    llvm_unreachable("Unsupported integer expr");
+  }
+}
+
+// In split form, the offset of a pointer is truncated to the width it has
+// when packed, and zero-extended, as soon as the pointer is formed. A split
+// pointer then has the same parts as its packed copy, such as one stored to
+// and loaded back from memory.
+void BPLExprWriter::writePointerPart(llvm::raw_ostream &OS, Expr *E,
+                                     bool Offset) {
+  if (writeSplitPointerVar(OS, E, Offset ? "offset" : "base"))
+    return;
+
+  if (MW->SplitPointers) {
+    if (auto *PtrE = dyn_cast<PointerExpr>(E)) {
+      if (!Offset) {
+        writeExpr(OS, PtrE->getArray().get());
+        return;
+      }
+      unsigned OffsetWidth =
+          MW->M->getPointerWidth() - MW->bitsRequiredForArrayBases();
+      auto *CE = dyn_cast<BVConstExpr>(PtrE->getOffset());
+      if (CE && CE->getValue().getActiveBits() <= OffsetWidth) {
+        writeExpr(OS, CE);
+        return;
+      }
+      MW->UsesPointers = true;
+      OS << "offset#SPLIT(";
+      writeExpr(OS, PtrE->getOffset().get());
+      OS << ")";
+      return;
+    } else if (auto *ITEE = dyn_cast<IfThenElseExpr>(E)) {
+      OS << "(if ";
+      writeExpr(OS, ITEE->getCond().get());
+      OS << " then ";
+      writePointerPart(OS, ITEE->getTrueExpr().get(), Offset);
+      OS << " else ";
+      writePointerPart(OS, ITEE->getFalseExpr().get(), Offset);
+      OS << ")";
+      return;
+    }
+  }
+
+  MW->UsesPointers = true;
+  OS << (Offset ? "offset#MKPTR(" : "base#MKPTR(");
+  writeExpr(OS, E);
+  OS << ")";
+}
+
+void BPLExprWriter::writeCallArgs(llvm::raw_ostream &OS, Function *Callee,
+                                  const std::vector<ref<Expr>> &Args) {
+  bool Split = MW->splitsPointerParameters(Callee);
+  for (unsigned i = 0; i < Args.size(); ++i) {
+    if (i > 0)
+      OS << ", ";
+    if (Split && Args[i]->getType().isKind(Type::Pointer)) {
+      writePointerPart(OS, Args[i].get(), false);
+      OS << ", ";
+      writePointerPart(OS, Args[i].get(), true);
+    } else {
+      writeExpr(OS, Args[i].get());
+    }
+  }
+}
+
 void BPLExprWriter::writeExpr(llvm::raw_ostream &OS, Expr *E, unsigned Depth) {
+  if (MW->SplitPointers && E->getType().isKind(Type::Pointer)) {
+    std::string Base; llvm::raw_string_ostream BaseS(Base);
+    if (writeSplitPointerVar(BaseS, E, "base")) {
+      OS << "MKPTR(" << BaseS.str() << ", ";
+      writeSplitPointerVar(OS, E, "offset");
+      OS << ")";
+      return;
+    }
+  }
+
+  if (MW->IntRep->isMathValue(E)) {
+    unsigned Width = E->getType().width;
+    OS << "INT_TO_BV" << Width << "(";
+    writeMathExpr(OS, E);
+    OS << ")";
+    MW->writeIntrinsic(
+        [&](llvm::raw_ostream &OS) { OS << MW->IntRep->getFromMath(Width); },
+        false);
+    return;
+  }
+
+  if (writeSSAVar(OS, E))
+    return;
+
   if (DumpRefCounts)
     OS << "/*rc=" << E->refCount << "*/";
 
@@ -104,6 +285,7 @@ void BPLExprWriter::writeExpr(llvm::raw_ostream &OS, Expr *E, unsigned Depth) {
     OS << SVarE->getAttr();
   } else if (auto *ArrE = dyn_cast<GlobalArrayRefExpr>(E)) {
     MW->UsesPointers = true;
+    MW->addArrayUse(ArrE->getArray(), BPLModuleWriter::AU_Referenced);
     OS << "$arrayId$$" << ArrE->getArray()->getName();
   } else if (isa<NullArrayRefExpr>(E)) {
     MW->UsesPointers = true;
@@ -120,11 +302,17 @@ void BPLExprWriter::writeExpr(llvm::raw_ostream &OS, Expr *E, unsigned Depth) {
           [&](llvm::raw_ostream &OS) { OS << MW->IntRep->getConcat(); }, false);
     }
   } else if (auto *EE = dyn_cast<EqExpr>(E)) {
+    if (writeMathComparison(OS, EE, "==", false) ||
+        writeSplitPointerComparison(OS, EE, true))
+      return;
     ScopedParenPrinter X(OS, Depth, 4);
     writeExpr(OS, EE->getLHS().get(), 4);
     OS << " == ";
     writeExpr(OS, EE->getRHS().get(), 4);
   } else if (auto *NE = dyn_cast<NeExpr>(E)) {
+    if (writeMathComparison(OS, NE, "!=", false) ||
+        writeSplitPointerComparison(OS, NE, false))
+      return;
     ScopedParenPrinter X(OS, Depth, 4);
     writeExpr(OS, NE->getLHS().get(), 4);
     OS << " != ";
@@ -159,25 +347,16 @@ void BPLExprWriter::writeExpr(llvm::raw_ostream &OS, Expr *E, unsigned Depth) {
     writeExpr(OS, BV2BE->getSubExpr().get(), 4);
     OS << " == " << MW->IntRep->getLiteral(1, 1);
   } else if (auto *AIE = dyn_cast<ArrayIdExpr>(E)) {
-    OS << "base#MKPTR(";
-    writeExpr(OS, AIE->getSubExpr().get());
-    OS << ")";
+    writePointerPart(OS, AIE->getSubExpr().get(), false);
   } else if (auto *AOE = dyn_cast<ArrayOffsetExpr>(E)) {
-    OS << "offset#MKPTR(";
-    writeExpr(OS, AOE->getSubExpr().get());
-    OS << ")";
+    writePointerPart(OS, AOE->getSubExpr().get(), true);
   } else if (auto *NotE = dyn_cast<NotExpr>(E)) {
     ScopedParenPrinter X(OS, Depth, 7);
     OS << "!";
     writeExpr(OS, NotE->getSubExpr().get(), 8);
   } else if (auto *CE = dyn_cast<CallExpr>(E)) {
     OS << "$" << CE->getCallee()->getName() << "(";
-    const auto &Args = CE->getArgs();
-    for (unsigned i = 0; i < Args.size(); ++i) {
-      if (i > 0)
-        OS << ", ";
-      writeExpr(OS, Args[i].get());
-    }
+    writeCallArgs(OS, CE->getCallee(), CE->getArgs());
     OS << ")";
   } else if (isa<CallMemberOfExpr>(E)) {
     llvm_unreachable("Handled at statement level");
@@ -365,6 +544,7 @@ void BPLExprWriter::writeExpr(llvm::raw_ostream &OS, Expr *E, unsigned Depth) {
     }
 
     if (Globals.size() == 1 && *Globals.begin() != nullptr) {
+      MW->addArrayUse(*Globals.begin(), BPLModuleWriter::AU_Atomic);
       OS << "_USED_$$" << (*Globals.begin())->getName() << "[";
       writeExpr(OS, AHTVE->getOffset().get());
       OS << "][";
@@ -571,6 +751,15 @@ void BPLExprWriter::writeExpr(llvm::raw_ostream &OS, Expr *E, unsigned Depth) {
       default:
         llvm_unreachable("huh?");
       }
+      const char *Op;
+      switch (BinE->getKind()) {
+      case Expr::BVUgt: case Expr::BVSgt: Op = ">";  break;
+      case Expr::BVUge: case Expr::BVSge: Op = ">="; break;
+      case Expr::BVUlt: case Expr::BVSlt: Op = "<";  break;
+      default:                            Op = "<="; break;
+      }
+      if (writeMathComparison(OS, BinE, Op, BinE->getKind() <= Expr::BVUle))
+        return;
       OS << "BV" << BinE->getLHS()->getType().width << "_" << IntName;
       MW->writeIntrinsic([&](llvm::raw_ostream &OS) {
                            OS << MW->IntRep->getBooleanBinary(
@@ -691,6 +880,7 @@ void BPLExprWriter::writeExpr(llvm::raw_ostream &OS, Expr *E, unsigned Depth) {
     }
 
     if (Globals.size() == 1 && *Globals.begin() != nullptr) {
+      MW->addArrayUse(*Globals.begin(), BPLModuleWriter::AU_Read);
       OS << "$$" << (*Globals.begin())->getName() << "[";
       writeExpr(OS, LE->getOffset().get());
       OS << "]";
@@ -714,6 +904,7 @@ void BPLExprWriter::writeExpr(llvm::raw_ostream &OS, Expr *E, unsigned Depth) {
     }
 
     if (Globals.size() == 1 && *Globals.begin() != nullptr) {
+      MW->addArrayUse(*Globals.begin(), BPLModuleWriter::AU_Referenced);
       OS << "$$" << (*Globals.begin())->getName();
     } else {
       ErrorReporter::reportImplementationLimitation(
@@ -731,8 +922,11 @@ void BPLExprWriter::writeAccessHasOccurredVar(llvm::raw_ostream &OS,
                                               std::string accessKind) {
 
   std::string prefix = "_" + accessKind + "_HAS_OCCURRED_$$";
+  unsigned Use = accessKind == "WRITE" ? BPLModuleWriter::AU_Write
+                                       : BPLModuleWriter::AU_Read;
 
   if (auto *GARE = dyn_cast<GlobalArrayRefExpr>(PtrArr)) {
+    MW->addArrayUse(GARE->getArray(), Use);
     OS << prefix << GARE->getArray()->getName();
   } else {
     std::set<GlobalArray *> Globals;
@@ -743,6 +937,7 @@ void BPLExprWriter::writeAccessHasOccurredVar(llvm::raw_ostream &OS,
 
     if (Globals.size() == 1 && (*Globals.begin() != nullptr) &&
         (*Globals.begin())->isGlobalOrGroupShared()) {
+      MW->addArrayUse(*Globals.begin(), Use);
       OS << prefix << (*Globals.begin())->getName();
     } else {
       MW->UsesPointers = true;
@@ -752,6 +947,7 @@ void BPLExprWriter::writeAccessHasOccurredVar(llvm::raw_ostream &OS,
           continue; // Null pointer; dealt with as last case
         if (!GA->isGlobalOrGroupShared())
           continue; // Accesses of local arrays are not tracked
+        MW->addArrayUse(GA, Use);
         OS << "if (";
         writeExpr(OS, PtrArr);
         OS << " == $arrayId$$" << GA->getName() << ") then "
@@ -778,8 +974,11 @@ void BPLExprWriter::writeAccessOffsetVar(llvm::raw_ostream &OS,
     assert(MW->RaceInst == bugle::RaceInstrumenter::WatchdogMultiple);
     prefix = "_WATCHED_OFFSET_$$";
   }
+  unsigned Use = accessKind == "WRITE" ? BPLModuleWriter::AU_Write
+                                       : BPLModuleWriter::AU_Read;
 
   if (auto *GARE = dyn_cast<GlobalArrayRefExpr>(PtrArr)) {
+    MW->addArrayUse(GARE->getArray(), Use);
     OS << prefix << GARE->getArray()->getName();
   } else {
     std::set<GlobalArray *> Globals;
@@ -790,6 +989,7 @@ void BPLExprWriter::writeAccessOffsetVar(llvm::raw_ostream &OS,
 
     if (Globals.size() == 1 && (*Globals.begin() != nullptr) &&
         (*Globals.begin())->isGlobalOrGroupShared()) {
+      MW->addArrayUse(*Globals.begin(), Use);
       OS << prefix << (*Globals.begin())->getName();
     } else {
       MW->UsesPointers = true;
@@ -799,6 +999,7 @@ void BPLExprWriter::writeAccessOffsetVar(llvm::raw_ostream &OS,
           continue; // Null pointer; dealt with as last case
         if (!GA->isGlobalOrGroupShared())
           continue; // Offsets of local arrays are not tracked
+        MW->addArrayUse(GA, Use);
         OS << "if (";
         writeExpr(OS, PtrArr);
         OS << " == $arrayId$$" << GA->getName() << ") then "
@@ -11,9 +11,12 @@
 #include "bugle/SourceLocWriter.h"
 #include "bugle/Stmt.h"
 #include "bugle/util/ErrorReporter.h"
+#include "bugle/util/Profiler.h"
+#include "llvm/ADT/BitVector.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/raw_ostream.h"
+#include <algorithm>
 
 using namespace bugle;
 
@@ -38,6 +41,7 @@ void BPLFunctionWriter::maybeWriteCaseSplit(
       F(*Globals.begin(), indent);
       OS << "\n";
     } else {
+      Profiler::addToCounter("write.case-splits");
       MW->UsesPointers = true;
       OS << std::string(indent, ' ');
       for (auto *GA : Globals) {
@@ -46,6 +50,7 @@ void BPLFunctionWriter::maybeWriteCaseSplit(
         OS << "if (";
         writeExpr(OS, PtrArr);
         OS << " == $arrayId$$" << GA->getName() << ") {\n";
+        MW->addArrayUse(GA, BPLModuleWriter::AU_Referenced);
         F(GA, indent + 2);
         OS << "\n" << std::string(indent, ' ') << "} else ";
       }
@@ -57,25 +62,69 @@ void BPLFunctionWriter::maybeWriteCaseSplit(
   }
 }
 
-void BPLFunctionWriter::writeExpr(llvm::raw_ostream &OS, Expr *E,
-                                  unsigned Depth) {
+bool BPLFunctionWriter::writeSSAVar(llvm::raw_ostream &OS, Expr *E) {
+  auto id = SSAVarIds.find(E);
+  if (id == SSAVarIds.end())
+    return false;
+
+  OS << "v" << id->second;
+  return true;
+}
+
+// Pointers held in variables are split into an array id and an offset,
+// which are only packed together when a pointer is needed whole.
+bool BPLFunctionWriter::isSplitPointerVar(Var *V) {
+  if (!MW->SplitPointers || !V->getType().isKind(Type::Pointer))
+    return false;
+  if (MW->splitsPointerParameters(F))
+    return true;
+  return std::find(F->arg_begin(), F->arg_end(), V) == F->arg_end() &&
+         std::find(F->return_begin(), F->return_end(), V) == F->return_end();
+}
+
+bool BPLFunctionWriter::isSplitPointerValue(Expr *E) {
+  return MW->SplitPointers && E->getType().isKind(Type::Pointer);
+}
+
+bool BPLFunctionWriter::writeSplitPointerVar(llvm::raw_ostream &OS, Expr *E,
+                                             const char *Part) {
+  if (!isSplitPointerValue(E))
+    return false;
+
   auto id = SSAVarIds.find(E);
   if (id != SSAVarIds.end()) {
-    OS << "v" << id->second;
-    return;
+    OS << "v" << id->second << "#" << Part;
+    return true;
+  }
+
+  if (auto *VarE = dyn_cast<VarRefExpr>(E)) {
+    if (isSplitPointerVar(VarE->getVar())) {
+      OS << "$" << VarE->getVar()->getName() << "#" << Part;
+      return true;
+    }
   }
 
-  return BPLExprWriter::writeExpr(OS, E, Depth);
+  return false;
+}
+
+void BPLFunctionWriter::writeSSAVarDef(llvm::raw_ostream &OS, Expr *E,
+                                       unsigned Id) {
+  if (isSplitPointerValue(E))
+    OS << "v" << Id << "#base, v" << Id << "#offset";
+  else
+    OS << "v" << Id;
+}
+
+void BPLFunctionWriter::writeValue(llvm::raw_ostream &OS, Expr *E, bool Math) {
+  if (Math)
+    writeMathExpr(OS, E);
+  else
+    writeExpr(OS, E);
 }
 
 void BPLFunctionWriter::writeCallStmt(llvm::raw_ostream &OS, CallStmt *CS) {
   OS << "$" << CS->getCallee()->getName() << "(";
-  const auto &Args = CS->getArgs();
-  for (unsigned i = 0; i < Args.size(); ++i) {
-    if (i > 0)
-      OS << ", ";
-    writeExpr(OS, Args[i].get());
-  }
+  writeCallArgs(OS, CS->getCallee(), CS->getArgs());
   OS << ")";
 }
 
@@ -84,6 +133,9 @@ void BPLFunctionWriter::writeStmt(llvm::raw_ostream &OS, Stmt *S) {
     assert(!ES->getExpr()->preventEvalStmt);
     assert(SSAVarIds.find(ES->getExpr().get()) == SSAVarIds.end());
     unsigned id = SSAVarIds.size();
+    auto Slot = SSAVarSlots.find(ES->getExpr().get());
+    if (Slot != SSAVarSlots.end())
+      id = Slot->second;
     if (auto *ASE = dyn_cast<ArraySnapshotExpr>(ES->getExpr())) {
       auto DstArray = ASE->getDst().get();
       auto SrcArray = ASE->getSrc().get();
@@ -103,6 +155,8 @@ void BPLFunctionWriter::writeStmt(llvm::raw_ostream &OS, Stmt *S) {
       }
 
       if (GlobalsDst.size() == 1 && GlobalsSrc.size() == 1) {
+        MW->addArrayUse(*GlobalsDst.begin(), BPLModuleWriter::AU_Write);
+        MW->addArrayUse(*GlobalsSrc.begin(), BPLModuleWriter::AU_Read);
         OS << "  $$" << (*GlobalsDst.begin())->getName() << " := "
            << "$$" << (*GlobalsSrc.begin())->getName() << ";\n";
       } else {
@@ -119,7 +173,15 @@ void BPLFunctionWriter::writeStmt(llvm::raw_ostream &OS, Stmt *S) {
       OS << "  call ";
     }
     if (isa<HavocExpr>(ES->getExpr())) {
-      OS << "  havoc v" << id << ";\n";
+      OS << "  havoc ";
+      writeSSAVarDef(OS, ES->getExpr().get(), id);
+      OS << ";\n";
+      // Split offsets are kept truncated, as writePointerPart forms them.
+      if (isSplitPointerValue(ES->getExpr().get())) {
+        MW->UsesPointers = true;
+        OS << "  assume v" << id << "#offset == offset#SPLIT(v" << id
+           << "#offset);\n";
+      }
     } else if (auto *CMOE = dyn_cast<CallMemberOfExpr>(ES->getExpr())) {
       auto CES = CMOE->getCallExprs();
       auto SL = ES->getSourceLocs();
@@ -132,7 +194,8 @@ void BPLFunctionWriter::writeStmt(llvm::raw_ostream &OS, Stmt *S) {
         OS << " == $functionId$$" << CE->getCallee()->getName() << ") {\n";
         OS << "    call ";
         writeSourceLocs(OS, SL);
-        OS << "v" << id << " := ";
+        writeSSAVarDef(OS, CE, id);
+        OS << " := ";
         writeExpr(OS, CE);
         OS << ";\n  } else ";
       }
@@ -144,16 +207,27 @@ void BPLFunctionWriter::writeStmt(llvm::raw_ostream &OS, Stmt *S) {
                           [&](GlobalArray *GA, unsigned int indent) {
         writeSourceLocsMarker(OS, ES->getSourceLocs(), indent);
         assert(LE->getType() == GA->getRangeType());
+        MW->addArrayUse(GA, BPLModuleWriter::AU_Read);
+        std::string Elem; llvm::raw_string_ostream ElemS(Elem);
+        ElemS << "$$" << GA->getName() << "[";
+        writeExpr(ElemS, LE->getOffset().get());
+        ElemS << "]";
         OS << std::string(indent, ' ');
-        OS << "v" << id << " := $$" << GA->getName() << "[";
-        writeExpr(OS, LE->getOffset().get());
-        OS << "];";
+        writeSSAVarDef(OS, LE, id);
+        if (isSplitPointerValue(LE)) {
+          MW->UsesPointers = true;
+          OS << " := base#MKPTR(" << ElemS.str() << "), offset#MKPTR("
+             << ElemS.str() << ");";
+        } else {
+          OS << " := " << ElemS.str() << ";";
+        }
       });
     } else if (auto *AE = dyn_cast<AtomicExpr>(ES->getExpr())) {
       maybeWriteCaseSplit(OS, AE->getArray().get(), ES->getSourceLocs(),
                           [&](GlobalArray *GA, unsigned int indent) {
         writeSourceLocsMarker(OS, ES->getSourceLocs(), indent);
         assert(AE->getType() == GA->getRangeType());
+        MW->addArrayUse(GA, BPLModuleWriter::AU_Atomic);
         OS << std::string(indent, ' ');
         OS << "call {:atomic} ";
         OS << "{:atomic_function \"" << AE->getFunction() << "\"} ";
@@ -203,6 +277,8 @@ void BPLFunctionWriter::writeStmt(llvm::raw_ostream &OS, Stmt *S) {
                 OS, DstArray.get(), ES->getSourceLocs(),
                 [&](GlobalArray *DstGA, unsigned int indent) {
                   writeSourceLocsMarker(OS, ES->getSourceLocs(), indent);
+                  MW->addArrayUse(SrcGA, BPLModuleWriter::AU_Read);
+                  MW->addArrayUse(DstGA, BPLModuleWriter::AU_Write);
                   OS << std::string(indent, ' ')
                      << "call {:async_work_group_copy} v" << id
                      << ", $$" << DstGA->getName()
@@ -240,8 +316,17 @@ void BPLFunctionWriter::writeStmt(llvm::raw_ostream &OS, Stmt *S) {
       writeExpr(OS, CE->getIsZeroUndef().get());
       OS << ");\n";
     } else {
-      OS << "  v" << id << " := ";
-      writeExpr(OS, ES->getExpr().get());
+      Expr *E = ES->getExpr().get();
+      OS << "  ";
+      writeSSAVarDef(OS, E, id);
+      OS << " := ";
+      if (isSplitPointerValue(E) && !isa<CallExpr>(E)) {
+        writePointerPart(OS, E, false);
+        OS << ", ";
+        writePointerPart(OS, E, true);
+      } else {
+        writeValue(OS, E, MW->IntRep->isMathValue(E));
+      }
       OS << ";\n";
     }
     SSAVarIds[ES->getExpr().get()] = id;
@@ -273,6 +358,7 @@ void BPLFunctionWriter::writeStmt(llvm::raw_ostream &OS, Stmt *S) {
                         [&](GlobalArray *GA, unsigned int indent) {
       writeSourceLocsMarker(OS, SS->getSourceLocs(), indent);
       assert(SS->getValue()->getType() == GA->getRangeType());
+      MW->addArrayUse(GA, BPLModuleWriter::AU_Write);
       OS << std::string(indent, ' ');
       OS << "$$" << GA->getName() << "[";
       writeExpr(OS, SS->getOffset().get());
@@ -286,14 +372,24 @@ void BPLFunctionWriter::writeStmt(llvm::raw_ostream &OS, Stmt *S) {
     for (unsigned i = 0; i < Vars.size(); ++i) {
       if (i > 0)
         OS << ", ";
-      OS << "$" << Vars[i]->getName();
+      if (isSplitPointerVar(Vars[i]))
+        OS << "$" << Vars[i]->getName() << "#base, $" << Vars[i]->getName()
+           << "#offset";
+      else
+        OS << "$" << Vars[i]->getName();
     }
     OS << " := ";
     const auto &Vals = VAS->getValues();
     for (unsigned i = 0; i < Vals.size(); ++i) {
       if (i > 0)
         OS << ", ";
-      writeExpr(OS, Vals[i].get());
+      if (isSplitPointerVar(Vars[i])) {
+        writePointerPart(OS, Vals[i].get(), false);
+        OS << ", ";
+        writePointerPart(OS, Vals[i].get(), true);
+      } else {
+        writeValue(OS, Vals[i].get(), MW->IntRep->isMathVar(Vars[i]));
+      }
     }
     OS << ";\n";
   } else if (auto *GS = dyn_cast<GotoStmt>(S)) {
@@ -309,6 +405,10 @@ void BPLFunctionWriter::writeStmt(llvm::raw_ostream &OS, Stmt *S) {
     OS << "  assume ";
     if (AS->isPartition())
       OS << "{:partition} ";
+    if (AS->isUniform())
+      OS << "{:uniform} ";
+    else if (AS->isGroupUniform())
+      OS << "{:group_uniform} ";
     writeExpr(OS, AS->getPredicate().get());
     OS << ";\n";
   } else if (auto *AtS = dyn_cast<AssertStmt>(S)) {
@@ -379,8 +479,168 @@ void BPLFunctionWriter::writeSourceLocsMarker(llvm::raw_ostream &OS,
 }
 
 void BPLFunctionWriter::writeVar(llvm::raw_ostream &OS, Var *V) {
+  if (isSplitPointerVar(V)) {
+    MW->UsesPointers = true;
+    OS << "$" << V->getName() << "#base:arrayId, $" << V->getName()
+       << "#offset:" << MW->IntRep->getType(MW->M->getPointerWidth());
+    return;
+  }
+
   OS << "$" << V->getName() << ":";
-  MW->writeType(OS, V->getType());
+  if (MW->IntRep->isMathVar(V))
+    OS << "int";
+  else
+    MW->writeType(OS, V->getType());
+}
+
+std::string BPLFunctionWriter::getSSAVarType(Expr *E) {
+  if (isSplitPointerValue(E))
+    return "ptr#split";
+  if (MW->IntRep->isMathValue(E))
+    return "int";
+  std::string S;
+  llvm::raw_string_ostream SS(S);
+  MW->writeType(SS, E->getType());
+  return SS.str();
+}
+
+// Assign the same variable to expressions of the same type whose values are
+// never live at the same time. Each expression with an EvalStmt is assigned
+// once, so two such expressions interfere if one is live where the other is
+// assigned. An expression also interferes with those used by the statement
+// which assigns it, as some statements are written as several Boogie
+// statements, or are instrumented further by GPUVerify.
+void BPLFunctionWriter::coalesceSSAVars() {
+  // Expressions are read from their variables once their EvalStmt has been
+  // written, and are written inline before then, so the uses of each
+  // statement depend on the order in which the blocks are written.
+  std::map<Expr *, unsigned> DefIds;
+  std::vector<Expr *> Defs;
+  struct StmtInfo {
+    std::vector<unsigned> Uses;
+    int Def;
+  };
+  std::map<BasicBlock *, unsigned> BlockIds;
+  std::vector<std::vector<StmtInfo>> Blocks;
+  std::vector<std::vector<unsigned>> Succs;
+
+  for (auto *BB : *F) {
+    unsigned BlockId = Blocks.size();
+    BlockIds[BB] = BlockId;
+    Blocks.emplace_back();
+  }
+
+  for (auto *BB : *F) {
+    unsigned BlockId = BlockIds[BB];
+    Succs.emplace_back();
+    for (auto *S : *BB) {
+      StmtInfo Info;
+      Info.Def = -1;
+
+      std::vector<Expr *> Worklist;
+      std::set<Expr *> Visited;
+      S->getOperands(Worklist);
+      while (!Worklist.empty()) {
+        Expr *E = Worklist.back();
+        Worklist.pop_back();
+        if (!Visited.insert(E).second)
+          continue;
+        auto i = DefIds.find(E);
+        if (i != DefIds.end())
+          Info.Uses.push_back(i->second);
+        else
+          E->getOperands(Worklist);
+      }
+
+      if (auto *ES = dyn_cast<EvalStmt>(S)) {
+        if (!isa<ArraySnapshotExpr>(ES->getExpr())) {
+          Info.Def = Defs.size();
+          DefIds[ES->getExpr().get()] = Defs.size();
+          Defs.push_back(ES->getExpr().get());
+        }
+      } else if (auto *GS = dyn_cast<GotoStmt>(S)) {
+        for (auto *Succ : GS->getBlocks())
+          Succs[BlockId].push_back(BlockIds[Succ]);
+      }
+      Blocks[BlockId].push_back(Info);
+    }
+  }
+
+  if (Defs.empty())
+    return;
+
+  // Compute the expressions live on entry to each block.
+  unsigned NumBlocks = Blocks.size();
+  std::vector<llvm::BitVector> LiveIn(NumBlocks, llvm::BitVector(Defs.size()));
+  bool Changed = true;
+  while (Changed) {
+    Changed = false;
+    for (unsigned b = NumBlocks; b-- > 0;) {
+      llvm::BitVector Live(Defs.size());
+      for (unsigned Succ : Succs[b])
+        Live |= LiveIn[Succ];
+      for (auto i = Blocks[b].rbegin(), e = Blocks[b].rend(); i != e; ++i) {
+        if (i->Def >= 0)
+          Live.reset(i->Def);
+        for (unsigned Use : i->Uses)
+          Live.set(Use);
+      }
+      if (Live != LiveIn[b]) {
+        LiveIn[b] = Live;
+        Changed = true;
+      }
+    }
+  }
+
+  std::vector<std::vector<unsigned>> Interferes(Defs.size());
+  for (unsigned b = 0; b != NumBlocks; ++b) {
+    llvm::BitVector Live(Defs.size());
+    for (unsigned Succ : Succs[b])
+      Live |= LiveIn[Succ];
+    for (auto i = Blocks[b].rbegin(), e = Blocks[b].rend(); i != e; ++i) {
+      for (unsigned Use : i->Uses)
+        Live.set(Use);
+      if (i->Def < 0)
+        continue;
+      Live.reset(i->Def);
+      for (int j = Live.find_first(); j != -1; j = Live.find_next(j)) {
+        Interferes[i->Def].push_back(j);
+        Interferes[j].push_back(i->Def);
+      }
+    }
+  }
+
+  // Expressions which may be used before they are assigned keep their own
+  // variables.
+  const llvm::BitVector &Undefined = LiveIn[0];
+
+  std::vector<int> Slots(Defs.size(), -1);
+  std::map<std::string, std::vector<unsigned>> TypeSlots;
+  unsigned NumSlots = 0;
+  for (unsigned d = 0; d != Defs.size(); ++d) {
+    if (Undefined.test(d)) {
+      Slots[d] = NumSlots++;
+      continue;
+    }
+
+    std::set<unsigned> Taken;
+    for (unsigned j : Interferes[d])
+      if (Slots[j] >= 0)
+        Taken.insert(Slots[j]);
+
+    auto &Candidates = TypeSlots[getSSAVarType(Defs[d])];
+    auto i = std::find_if(Candidates.begin(), Candidates.end(),
+                          [&](unsigned Slot) { return !Taken.count(Slot); });
+    if (i != Candidates.end()) {
+      Slots[d] = *i;
+    } else {
+      Slots[d] = NumSlots++;
+      Candidates.push_back(Slots[d]);
+    }
+  }
+
+  for (unsigned d = 0; d != Defs.size(); ++d)
+    SSAVarSlots[Defs[d]] = Slots[d];
 }
 
 void BPLFunctionWriter::write() {
@@ -479,6 +739,9 @@ void BPLFunctionWriter::write() {
       return;
     }
 
+    if (MW->CoalesceVars)
+      coalesceSSAVars();
+
     std::string Body;
     llvm::raw_string_ostream BodyOS(Body);
     for (auto *BB : *F) {
@@ -493,9 +756,22 @@ void BPLFunctionWriter::write() {
       OS << ";\n";
     }
 
+    std::set<unsigned> Declared;
     for (const auto &VarId : SSAVarIds) {
+      if (!Declared.insert(VarId.second).second)
+        continue;
+      if (isSplitPointerValue(VarId.first)) {
+        MW->UsesPointers = true;
+        OS << "  var v" << VarId.second << "#base:arrayId, v" << VarId.second
+           << "#offset:" << MW->IntRep->getType(MW->M->getPointerWidth())
+           << ";\n";
+        continue;
+      }
       OS << "  var v" << VarId.second << ":";
-      MW->writeType(OS, VarId.first->getType());
+      if (MW->IntRep->isMathValue(VarId.first))
+        OS << "int";
+      else
+        MW->writeType(OS, VarId.first->getType());
       OS << ";\n";
     }
 
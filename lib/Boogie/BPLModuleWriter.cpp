@@ -1,9 +1,11 @@
 #include "bugle/BPLModuleWriter.h"
 #include "bugle/BPLFunctionWriter.h"
+#include "bugle/Function.h"
 #include "bugle/IntegerRepresentation.h"
 #include "bugle/Module.h"
 #include "bugle/RaceInstrumenter.h"
 #include "bugle/Type.h"
+#include "bugle/util/Profiler.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/raw_ostream.h"
 #include <cmath>
@@ -45,7 +47,20 @@ void BPLModuleWriter::writeIntrinsic(std::function<void(llvm::raw_ostream &)> F,
   if (addSeparator) {
     SS << ";";
   }
-  IntrinsicSet.insert(SS.str());
+  if (IntrinsicSet.insert(SS.str()).second)
+    Profiler::addToCounter("write.intrinsics");
+}
+
+void BPLModuleWriter::addArrayUse(GlobalArray *GA, unsigned Use) {
+  if (GA)
+    ArrayUses[GA] |= Use | AU_Referenced;
+}
+
+unsigned BPLModuleWriter::getArrayUse(GlobalArray *GA) {
+  if (!PruneRaceInstrumentation)
+    return AU_Referenced | AU_Access;
+  auto i = ArrayUses.find(GA);
+  return i == ArrayUses.end() ? 0 : i->second;
 }
 
 const std::string &BPLModuleWriter::getGlobalInitRequires() {
@@ -54,6 +69,7 @@ const std::string &BPLModuleWriter::getGlobalInitRequires() {
     llvm::raw_string_ostream SS(GlobalInitRequires);
     for (auto i = M->global_init_begin(), e = M->global_init_end(); i != e;
          ++i) {
+      addArrayUse(i->array, AU_Referenced);
       SS << "requires "
          << "$$" << i->array->getName() << "["
          << MW->IntRep->getLiteral(i->offset, M->getPointerWidth())
@@ -99,11 +115,23 @@ void BPLModuleWriter::write() {
   unsigned arrayIdCounter = 1;
   for (auto i = M->global_begin(), e = M->global_end(); i != e;
        ++i, ++arrayIdCounter) {
+    // The functions have been written, so the uses of the array are known.
+    unsigned Use = getArrayUse(*i);
+    if (!Use)
+      continue;
+
+    std::string AccessAttributes;
+    if ((Use & AU_Access) == AU_Read)
+      AccessAttributes = "{:read_only} ";
+    else if ((Use & AU_Access) == AU_Write)
+      AccessAttributes = "{:write_only} ";
+
     OS << "var {:source_name \"" << (*i)->getSourceName() << "\"} ";
     for (auto ai = (*i)->attrib_begin(), ae = (*i)->attrib_end(); ai != ae;
          ++ai) {
       OS << "{:" << *ai << "} ";
     }
+    OS << AccessAttributes;
     OS << "$$" << (*i)->getName()
        << " : [" << IntRep->getType(M->getPointerWidth()) << "]";
     writeType(OS, (*i)->getRangeType());
@@ -113,6 +141,7 @@ void BPLModuleWriter::write() {
     for (auto ai = (*i)->attrib_begin(), ae = (*i)->attrib_end(); ai != ae;
          ++ai)
       OS << "{:" << *ai << "} ";
+    OS << AccessAttributes;
     OS << "{:elem_width " << (*i)->getRangeType().width << "} "
        << "{:source_name \"" << (*i)->getSourceName() << "\"} "
        << "{:source_elem_width " << (*i)->getSourceRangeType().width << "} ";
@@ -128,7 +157,7 @@ void BPLModuleWriter::write() {
       OS << "," << (*di);
     OS << "\"} true;\n";
 
-    if ((*i)->isGlobalOrGroupShared()) {
+    if ((*i)->isGlobalOrGroupShared() && (Use & AU_Access)) {
       std::string attributes;
       attributes += " {:race_checking} ";
       if ((*i)->isGlobal())
@@ -149,21 +178,27 @@ void BPLModuleWriter::write() {
         AS << "," << (*di);
       AS << "\"} ";
 
-      OS << "var" << AS.str() << "_READ_HAS_OCCURRED_$$" << (*i)->getName()
-         << " : bool;\n";
-      OS << "var" << AS.str() << "_WRITE_HAS_OCCURRED_$$" << (*i)->getName()
-         << " : bool;\n";
-      OS << "var" << AS.str() << "_ATOMIC_HAS_OCCURRED_$$" << (*i)->getName()
-         << " : bool;\n";
+      if (Use & AU_Read)
+        OS << "var" << AS.str() << "_READ_HAS_OCCURRED_$$" << (*i)->getName()
+           << " : bool;\n";
+      if (Use & AU_Write)
+        OS << "var" << AS.str() << "_WRITE_HAS_OCCURRED_$$" << (*i)->getName()
+           << " : bool;\n";
+      if (Use & AU_Atomic)
+        OS << "var" << AS.str() << "_ATOMIC_HAS_OCCURRED_$$"
+           << (*i)->getName() << " : bool;\n";
 
       switch (RaceInst) {
       case RaceInstrumenter::Original:
-        OS << "var" << attributes << "_READ_OFFSET_$$" << (*i)->getName()
-           << " : " << IntRep->getType(M->getPointerWidth()) << ";\n";
-        OS << "var" << attributes << "_WRITE_OFFSET_$$" << (*i)->getName()
-           << " : " << IntRep->getType(M->getPointerWidth()) << ";\n";
-        OS << "var" << attributes << "_ATOMIC_OFFSET_$$" << (*i)->getName()
-           << " : " << IntRep->getType(M->getPointerWidth()) << ";\n";
+        if (Use & AU_Read)
+          OS << "var" << attributes << "_READ_OFFSET_$$" << (*i)->getName()
+             << " : " << IntRep->getType(M->getPointerWidth()) << ";\n";
+        if (Use & AU_Write)
+          OS << "var" << attributes << "_WRITE_OFFSET_$$" << (*i)->getName()
+             << " : " << IntRep->getType(M->getPointerWidth()) << ";\n";
+        if (Use & AU_Atomic)
+          OS << "var" << attributes << "_ATOMIC_OFFSET_$$" << (*i)->getName()
+             << " : " << IntRep->getType(M->getPointerWidth()) << ";\n";
         break;
       case RaceInstrumenter::WatchdogMultiple:
         OS << "const" << attributes << "_WATCHED_OFFSET_$$" << (*i)->getName()
@@ -217,6 +252,19 @@ void BPLModuleWriter::write() {
        << "axiom $arrayId$$null$ == "
        << IntRep->getLiteral(0, BitsRequiredForArrayBases) << ";\n\n";
 
+    // The offset of a split pointer, truncated as it is when packed.
+    if (SplitPointers)
+      OS << "function {:inline true} offset#SPLIT(offset : "
+         << IntRep->getType(M->getPointerWidth()) << ") : "
+         << IntRep->getType(M->getPointerWidth()) << " {\n"
+         << "  "
+         << IntRep->getConcatExpr(
+                IntRep->getLiteral(0, BitsRequiredForArrayBases),
+                IntRep->getExtractExpr(
+                    "offset",
+                    (M->getPointerWidth() - BitsRequiredForArrayBases), 0))
+         << "\n}\n\n";
+
     if (IntRep->abstractsConcat()) {
       writeIntrinsic(
           [&](llvm::raw_ostream &OS) { OS << MW->IntRep->getConcat(); }, false);
@@ -281,3 +329,9 @@ unsigned BPLModuleWriter::bitsRequiredForFunctionPointers() {
           (double)(M->function_size() + NumberOfSpecialFunctionPointerValues)) /
       std::log((double)2));
 }
+
+// The parameters of entry points are left packed, as they make up the
+// interface of the kernel.
+bool BPLModuleWriter::splitsPointerParameters(Function *F) {
+  return SplitPointers && !F->isEntryPoint();
+}
@@ -3,7 +3,9 @@
 #include "bugle/Function.h"
 #include "bugle/GlobalArray.h"
 #include "bugle/util/Functional.h"
+#include "bugle/util/Profiler.h"
 #include "llvm/Support/raw_ostream.h"
+#include <algorithm>
 
 using namespace bugle;
 
@@ -29,6 +31,330 @@ bool Expr::computeArrayCandidates(std::set<GlobalArray *> &GlobalSet) const {
   }
 }
 
+void Expr::getOperands(std::vector<Expr *> &Ops) const {
+  if (auto *CARE = dyn_cast<ConstantArrayRefExpr>(this)) {
+    for (const auto &E : CARE->getArray())
+      Ops.push_back(E.get());
+  } else if (auto *PE = dyn_cast<PointerExpr>(this)) {
+    Ops.push_back(PE->getArray().get());
+    Ops.push_back(PE->getOffset().get());
+  } else if (auto *LE = dyn_cast<LoadExpr>(this)) {
+    Ops.push_back(LE->getArray().get());
+    Ops.push_back(LE->getOffset().get());
+  } else if (auto *AE = dyn_cast<AtomicExpr>(this)) {
+    Ops.push_back(AE->getArray().get());
+    Ops.push_back(AE->getOffset().get());
+    for (const auto &E : AE->getArgs())
+      Ops.push_back(E.get());
+  } else if (auto *CE = dyn_cast<CallExpr>(this)) {
+    for (const auto &E : CE->getArgs())
+      Ops.push_back(E.get());
+  } else if (auto *CMOE = dyn_cast<CallMemberOfExpr>(this)) {
+    Ops.push_back(CMOE->getFunc().get());
+    for (const auto &E : CMOE->getCallExprs())
+      Ops.push_back(E.get());
+  } else if (auto *EE = dyn_cast<BVExtractExpr>(this)) {
+    Ops.push_back(EE->getSubExpr().get());
+  } else if (auto *CE = dyn_cast<BVCtlzExpr>(this)) {
+    Ops.push_back(CE->getVal().get());
+    Ops.push_back(CE->getIsZeroUndef().get());
+  } else if (auto *ITE = dyn_cast<IfThenElseExpr>(this)) {
+    Ops.push_back(ITE->getCond().get());
+    Ops.push_back(ITE->getTrueExpr().get());
+    Ops.push_back(ITE->getFalseExpr().get());
+  } else if (auto *AHOE = dyn_cast<AccessHasOccurredExpr>(this)) {
+    Ops.push_back(AHOE->getArray().get());
+  } else if (auto *AOE = dyn_cast<AccessOffsetExpr>(this)) {
+    Ops.push_back(AOE->getArray().get());
+  } else if (auto *ASE = dyn_cast<ArraySnapshotExpr>(this)) {
+    Ops.push_back(ASE->getDst().get());
+    Ops.push_back(ASE->getSrc().get());
+  } else if (auto *UAE = dyn_cast<UnderlyingArrayExpr>(this)) {
+    Ops.push_back(UAE->getArray().get());
+  } else if (auto *ANE = dyn_cast<AddNoovflExpr>(this)) {
+    Ops.push_back(ANE->getFirst().get());
+    Ops.push_back(ANE->getSecond().get());
+  } else if (auto *ANPE = dyn_cast<AddNoovflPredicateExpr>(this)) {
+    for (const auto &E : ANPE->getExprs())
+      Ops.push_back(E.get());
+  } else if (auto *UFE = dyn_cast<UninterpretedFunctionExpr>(this)) {
+    for (unsigned i = 0, e = UFE->getNumOperands(); i != e; ++i)
+      Ops.push_back(UFE->getOperand(i).get());
+  } else if (auto *MOE = dyn_cast<ArrayMemberOfExpr>(this)) {
+    Ops.push_back(MOE->getSubExpr().get());
+  } else if (auto *AHTVE = dyn_cast<AtomicHasTakenValueExpr>(this)) {
+    Ops.push_back(AHTVE->getArray().get());
+    Ops.push_back(AHTVE->getOffset().get());
+    Ops.push_back(AHTVE->getValue().get());
+  } else if (auto *AWGCE = dyn_cast<AsyncWorkGroupCopyExpr>(this)) {
+    Ops.push_back(AWGCE->getDst().get());
+    Ops.push_back(AWGCE->getDstOffset().get());
+    Ops.push_back(AWGCE->getSrc().get());
+    Ops.push_back(AWGCE->getSrcOffset().get());
+    Ops.push_back(AWGCE->getSize().get());
+    Ops.push_back(AWGCE->getHandle().get());
+  } else if (auto *UE = dyn_cast<UnaryExpr>(this)) {
+    Ops.push_back(UE->getSubExpr().get());
+  } else if (auto *BE = dyn_cast<BinaryExpr>(this)) {
+    Ops.push_back(BE->getLHS().get());
+    Ops.push_back(BE->getRHS().get());
+  }
+}
+
+void Expr::replaceOperands(const std::function<ref<Expr>(Expr *)> &F) {
+  auto replace = [&](ref<Expr> &E) { E = F(E.get()); };
+  if (auto *CARE = dyn_cast<ConstantArrayRefExpr>(this)) {
+    for (auto &E : CARE->array)
+      replace(E);
+  } else if (auto *PE = dyn_cast<PointerExpr>(this)) {
+    replace(PE->array);
+    replace(PE->offset);
+  } else if (auto *LE = dyn_cast<LoadExpr>(this)) {
+    replace(LE->array);
+    replace(LE->offset);
+  } else if (auto *AE = dyn_cast<AtomicExpr>(this)) {
+    replace(AE->array);
+    replace(AE->offset);
+    for (auto &E : AE->args)
+      replace(E);
+  } else if (auto *CE = dyn_cast<CallExpr>(this)) {
+    for (auto &E : CE->args)
+      replace(E);
+  } else if (auto *CMOE = dyn_cast<CallMemberOfExpr>(this)) {
+    replace(CMOE->func);
+    for (auto &E : CMOE->callExprs)
+      replace(E);
+  } else if (auto *EE = dyn_cast<BVExtractExpr>(this)) {
+    replace(EE->expr);
+  } else if (auto *CE = dyn_cast<BVCtlzExpr>(this)) {
+    replace(CE->val);
+    replace(CE->isZeroUndef);
+  } else if (auto *ITE = dyn_cast<IfThenElseExpr>(this)) {
+    replace(ITE->cond);
+    replace(ITE->trueExpr);
+    replace(ITE->falseExpr);
+  } else if (auto *AHOE = dyn_cast<AccessHasOccurredExpr>(this)) {
+    replace(AHOE->array);
+  } else if (auto *AOE = dyn_cast<AccessOffsetExpr>(this)) {
+    replace(AOE->array);
+  } else if (auto *ASE = dyn_cast<ArraySnapshotExpr>(this)) {
+    replace(ASE->dst);
+    replace(ASE->src);
+  } else if (auto *UAE = dyn_cast<UnderlyingArrayExpr>(this)) {
+    replace(UAE->array);
+  } else if (auto *ANE = dyn_cast<AddNoovflExpr>(this)) {
+    replace(ANE->first);
+    replace(ANE->second);
+  } else if (auto *ANPE = dyn_cast<AddNoovflPredicateExpr>(this)) {
+    for (auto &E : ANPE->exprs)
+      replace(E);
+  } else if (auto *UFE = dyn_cast<UninterpretedFunctionExpr>(this)) {
+    for (auto &E : UFE->args)
+      replace(E);
+  } else if (auto *MOE = dyn_cast<ArrayMemberOfExpr>(this)) {
+    replace(MOE->expr);
+  } else if (auto *AHTVE = dyn_cast<AtomicHasTakenValueExpr>(this)) {
+    replace(AHTVE->atomicArray);
+    replace(AHTVE->offset);
+    replace(AHTVE->value);
+  } else if (auto *AWGCE = dyn_cast<AsyncWorkGroupCopyExpr>(this)) {
+    replace(AWGCE->dst);
+    replace(AWGCE->dstOffset);
+    replace(AWGCE->src);
+    replace(AWGCE->srcOffset);
+    replace(AWGCE->size);
+    replace(AWGCE->handle);
+  } else if (auto *UE = dyn_cast<UnaryExpr>(this)) {
+    replace(UE->expr);
+  } else if (auto *BE = dyn_cast<BinaryExpr>(this)) {
+    replace(BE->lhs);
+    replace(BE->rhs);
+  }
+}
+
+bool Expr::TrackAllocation = false;
+
+namespace {
+
+struct AllocationStats {
+  uint64_t Created, Live, PeakLive;
+};
+
+AllocationStats KindStats[Expr::BinaryLast + 1];
+uint64_t TotalLive, TotalPeakLive, Increments, Decrements;
+}
+
+const char *Expr::getKindName(Kind K) {
+  static const char *const Names[] = {
+    "BVConst",
+    "BoolConst",
+    "GlobalArrayRef",
+    "NullArrayRef",
+    "ConstantArrayRef",
+    "Pointer",
+    "NullFunctionPointer",
+    "FunctionPointer",
+    "Load",
+    "Atomic",
+    "VarRef",
+    "SpecialVarRef",
+    "Call",
+    "CallMemberOf",
+    "BVExtract",
+    "BVCtlz",
+    "IfThenElse",
+    "Havoc",
+    "AccessHasOccurred",
+    "AccessOffset",
+    "ArraySnapshot",
+    "UnderlyingArray",
+    "AddNoovfl",
+    "AddNoovflPredicate",
+    "UninterpretedFunction",
+    "ArrayMemberOf",
+    "AtomicHasTakenValue",
+    "AsyncWorkGroupCopy",
+    "Not",
+    "ArrayId",
+    "ArrayOffset",
+    "BVToPtr",
+    "PtrToBV",
+    "SafeBVToPtr",
+    "SafePtrToBV",
+    "BVToFuncPtr",
+    "FuncPtrToBV",
+    "PtrToFuncPtr",
+    "FuncPtrToPtr",
+    "BVToBool",
+    "BoolToBV",
+    "BVCtpop",
+    "BVZExt",
+    "BVSExt",
+    "FPConv",
+    "FPToSI",
+    "FPToUI",
+    "SIToFP",
+    "UIToFP",
+    "FAbs",
+    "FCeil",
+    "FCos",
+    "FExp",
+    "FExp2",
+    "FFloor",
+    "FLog",
+    "FLog10",
+    "FLog2",
+    "FrexpExp",
+    "FrexpFrac",
+    "FRsqrt",
+    "FRint",
+    "FSin",
+    "FSqrt",
+    "FTrunc",
+    "OtherInt",
+    "OtherBool",
+    "OtherPtrBase",
+    "Old",
+    "GetImageWidth",
+    "GetImageHeight",
+    "Eq",
+    "Ne",
+    "And",
+    "Or",
+    "BVAdd",
+    "BVSub",
+    "BVMul",
+    "BVSDiv",
+    "BVUDiv",
+    "BVSRem",
+    "BVURem",
+    "BVShl",
+    "BVAShr",
+    "BVLShr",
+    "BVAnd",
+    "BVOr",
+    "BVXor",
+    "BVConcat",
+    "BVUgt",
+    "BVUge",
+    "BVUlt",
+    "BVUle",
+    "BVSgt",
+    "BVSge",
+    "BVSlt",
+    "BVSle",
+    "FAdd",
+    "FSub",
+    "FMul",
+    "FDiv",
+    "FRem",
+    "FPow",
+    "FMax",
+    "FMin",
+    "FPowi",
+    "FLt",
+    "FEq",
+    "FUno",
+    "PtrLt",
+    "FuncPtrLt",
+    "Implies",
+  };
+  static_assert(sizeof(Names) / sizeof(Names[0]) == BinaryLast + 1,
+                "Kind name table out of sync with Expr::Kind");
+  return Names[K];
+}
+
+void Expr::noteIncrement(const Expr *E) {
+  ++Increments;
+  if (E->refCount != 0)
+    return;
+
+  AllocationStats &S = KindStats[E->getKind()];
+  ++S.Created;
+  S.PeakLive = std::max(S.PeakLive, ++S.Live);
+  TotalPeakLive = std::max(TotalPeakLive, ++TotalLive);
+}
+
+void Expr::noteDecrement(const Expr *E) {
+  ++Decrements;
+  if (E->refCount != 1)
+    return;
+
+  --KindStats[E->getKind()].Live;
+  --TotalLive;
+}
+
+void Expr::reportAllocationCounts() {
+  for (unsigned i = 0; i <= BinaryLast; ++i) {
+    const AllocationStats &S = KindStats[i];
+    if (S.Created == 0)
+      continue;
+    std::string Name = getKindName((Kind)i);
+    Profiler::addToCounter("expr.created." + Name, S.Created);
+    Profiler::addToCounter("expr.live." + Name, S.Live);
+    Profiler::addToCounter("expr.peak-live." + Name, S.PeakLive);
+  }
+  Profiler::addToCounter("expr.live", TotalLive);
+  Profiler::addToCounter("expr.peak-live", TotalPeakLive);
+  Profiler::addToCounter("expr.ref-increments", Increments);
+  Profiler::addToCounter("expr.ref-decrements", Decrements);
+}
+
+void Expr::printAllocationStats(llvm::raw_ostream &OS) {
+  OS << "Expression nodes (kind: created / live / peak live)\n";
+  for (unsigned i = 0; i <= BinaryLast; ++i) {
+    const AllocationStats &S = KindStats[i];
+    if (S.Created == 0)
+      continue;
+    OS << "  " << getKindName((Kind)i) << ": " << S.Created << " / " << S.Live
+       << " / " << S.PeakLive << "\n";
+  }
+  OS << "  total live: " << TotalLive << ", peak live: " << TotalPeakLive
+     << "\n";
+  OS << "ref<Expr> traffic: " << Increments << " increments, " << Decrements
+     << " decrements\n";
+}
+
 ref<Expr> BVConstExpr::create(const llvm::APInt &bv) {
   return new BVConstExpr(bv);
 }
@@ -201,7 +527,7 @@ ref<Expr> ArrayOffsetExpr::create(ref<Expr> pointer) {
   return new ArrayOffsetExpr(Type(Type::BV, pointer->getType().width), pointer);
 }
 
-ref<Expr> BVZExtExpr::create(unsigned width, ref<Expr> bv) {
+ref<Expr> BVZExtExpr::create(unsigned width, ref<Expr> bv, bool nonNegative) {
   const Type &ty = bv->getType();
   assert(ty.isKind(Type::BV));
 
@@ -213,7 +539,11 @@ ref<Expr> BVZExtExpr::create(unsigned width, ref<Expr> bv) {
   if (auto e = dyn_cast<BVConstExpr>(bv))
     return BVConstExpr::create(e->getValue().zext(width));
 
-  return new BVZExtExpr(Type(Type::BV, width), bv);
+  // The operand of the inner extension is the one whose sign bit matters.
+  if (auto e = dyn_cast<BVZExtExpr>(bv))
+    return BVZExtExpr::create(width, e->getSubExpr(), e->isNonNegative());
+
+  return new BVZExtExpr(Type(Type::BV, width), bv, nonNegative);
 }
 
 ref<Expr> BVSExtExpr::create(unsigned width, ref<Expr> bv) {
@@ -478,6 +808,9 @@ ref<Expr> BVToBoolExpr::create(ref<Expr> bv) {
   assert(bv->getType().isKind(Type::BV));
   assert(bv->getType().width == 1);
 
+  if (auto *e = dyn_cast<BVConstExpr>(bv))
+    return BoolConstExpr::create(e->getValue().getBoolValue());
+
   if (auto *e = dyn_cast<BoolToBVExpr>(bv))
     return e->getSubExpr();
 
@@ -487,6 +820,9 @@ ref<Expr> BVToBoolExpr::create(ref<Expr> bv) {
 ref<Expr> BoolToBVExpr::create(ref<Expr> bv) {
   assert(bv->getType().isKind(Type::Bool));
 
+  if (auto *e = dyn_cast<BoolConstExpr>(bv))
+    return BVConstExpr::create(1, e->getValue());
+
   if (auto *e = dyn_cast<BVToBoolExpr>(bv))
     return e->getSubExpr();
 
@@ -700,6 +1036,14 @@ ref<Expr> Expr::createExactBVSDiv(ref<Expr> lhs, uint64_t rhs, Var *base) {
       return createExactBVSDivMul(ME->getRHS().get(), CE, (int64_t)rhs);
     if (auto *CE = dyn_cast<BVConstExpr>(ME->getRHS()))
       return createExactBVSDivMul(ME->getLHS().get(), CE, (int64_t)rhs);
+  } else if (auto *ZEE = dyn_cast<BVZExtExpr>(lhs)) {
+    // Dividing before extending only gives the same result if the operand is
+    // non-negative; otherwise the signed division of the operand differs.
+    if (!ZEE->isNonNegative())
+      return ref<Expr>();
+    auto subDiv = createExactBVSDiv(ZEE->getSubExpr(), rhs, base);
+    if (!subDiv.isNull())
+      return BVZExtExpr::create(ZEE->getType().width, subDiv);
   } else if (base) {
     if (auto *AOE = dyn_cast<ArrayOffsetExpr>(lhs)) {
       if (auto *VRE = dyn_cast<VarRefExpr>(AOE->getSubExpr())) {
@@ -983,6 +1327,12 @@ ref<Expr> ImpliesExpr::create(ref<Expr> lhs, ref<Expr> rhs) {
   assert(lhs->getType().isKind(Type::Bool));
   assert(rhs->getType().isKind(Type::Bool));
 
+  if (auto *e1 = dyn_cast<BoolConstExpr>(lhs))
+    return e1->getValue() ? rhs : BoolConstExpr::create(true);
+
+  if (auto *e2 = dyn_cast<BoolConstExpr>(rhs))
+    return e2->getValue() ? rhs : NotExpr::create(lhs);
+
   return new ImpliesExpr(Type(Type::Bool), lhs, rhs);
 }
 
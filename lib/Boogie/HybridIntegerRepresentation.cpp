@@ -0,0 +1,622 @@
+#include "bugle/IntegerRepresentation.h"
+#include "bugle/BasicBlock.h"
+#include "bugle/Casting.h"
+#include "bugle/Function.h"
+#include "bugle/Module.h"
+#include "bugle/Stmt.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <map>
+#include <vector>
+
+using namespace bugle;
+
+namespace {
+
+// An interval of the signed values of a bitvector of at most 64 bits.
+struct Interval {
+  int64_t Lo, Hi;
+
+  bool operator==(const Interval &Other) const {
+    return Lo == Other.Lo && Hi == Other.Hi;
+  }
+};
+
+const unsigned MaxWidth = 64;
+
+// The number of times the entry state of a block may grow before the bounds
+// which are still growing are widened to those of the type.
+const unsigned WideningThreshold = 3;
+
+int64_t getMin(unsigned Width) {
+  return Width == 64 ? INT64_MIN : -((int64_t)1 << (Width - 1));
+}
+
+int64_t getMax(unsigned Width) {
+  return Width == 64 ? INT64_MAX : ((int64_t)1 << (Width - 1)) - 1;
+}
+
+Interval getFull(unsigned Width) { return {getMin(Width), getMax(Width)}; }
+
+Interval join(const Interval &A, const Interval &B) {
+  return {std::min(A.Lo, B.Lo), std::max(A.Hi, B.Hi)};
+}
+
+bool isTracked(Expr *E) {
+  return E->getType().isKind(Type::BV) && E->getType().width <= MaxWidth;
+}
+
+bool isTracked(Var *V) {
+  return V->getType().isKind(Type::BV) && V->getType().width <= MaxWidth;
+}
+
+bool checkedAdd(int64_t A, int64_t B, int64_t &R) {
+  if ((B > 0 && A > INT64_MAX - B) || (B < 0 && A < INT64_MIN - B))
+    return false;
+  R = A + B;
+  return true;
+}
+
+bool checkedSub(int64_t A, int64_t B, int64_t &R) {
+  if ((B < 0 && A > INT64_MAX + B) || (B > 0 && A < INT64_MIN + B))
+    return false;
+  R = A - B;
+  return true;
+}
+
+bool checkedMul(int64_t A, int64_t B, int64_t &R) {
+  if (A != 0 && B != 0 &&
+      (A > 0 ? (B > 0 ? A > INT64_MAX / B : B < INT64_MIN / A)
+             : (B > 0 ? A < INT64_MIN / B : B < INT64_MAX / A)))
+    return false;
+  R = A * B;
+  return true;
+}
+
+bool getConstant(Expr *E, int64_t &C) {
+  auto *CE = dyn_cast<BVConstExpr>(E);
+  if (!CE || CE->getValue().getBitWidth() > MaxWidth)
+    return false;
+  C = CE->getValue().getSExtValue();
+  return true;
+}
+
+// Whether E uses the bits of its operands other than through their value,
+// in which case writing the operands as integers would only add conversions.
+bool isBitLevel(Expr *E) {
+  switch (E->getKind()) {
+  case Expr::BVAnd:
+  case Expr::BVOr:
+  case Expr::BVXor:
+  case Expr::BVShl:
+  case Expr::BVAShr:
+  case Expr::BVLShr:
+  case Expr::BVConcat:
+  case Expr::BVCtpop:
+  case Expr::BVCtlz:
+    return true;
+  case Expr::BVExtract:
+    return cast<BVExtractExpr>(E)->getOffset() != 0;
+  default:
+    return (E->getKind() >= Expr::FPConv && E->getKind() <= Expr::FTrunc) ||
+           (E->getKind() >= Expr::FAdd && E->getKind() <= Expr::FUno);
+  }
+}
+
+Expr::Kind negate(Expr::Kind K) {
+  switch (K) {
+  case Expr::Eq:    return Expr::Ne;
+  case Expr::Ne:    return Expr::Eq;
+  case Expr::BVUgt: return Expr::BVUle;
+  case Expr::BVUge: return Expr::BVUlt;
+  case Expr::BVUlt: return Expr::BVUge;
+  case Expr::BVUle: return Expr::BVUgt;
+  case Expr::BVSgt: return Expr::BVSle;
+  case Expr::BVSge: return Expr::BVSlt;
+  case Expr::BVSlt: return Expr::BVSge;
+  case Expr::BVSle: return Expr::BVSgt;
+  default:          return K;
+  }
+}
+
+Expr::Kind swap(Expr::Kind K) {
+  switch (K) {
+  case Expr::BVUgt: return Expr::BVUlt;
+  case Expr::BVUge: return Expr::BVUle;
+  case Expr::BVUlt: return Expr::BVUgt;
+  case Expr::BVUle: return Expr::BVUge;
+  case Expr::BVSgt: return Expr::BVSlt;
+  case Expr::BVSge: return Expr::BVSle;
+  case Expr::BVSlt: return Expr::BVSgt;
+  case Expr::BVSle: return Expr::BVSge;
+  default:          return K;
+  }
+}
+
+// A flow-sensitive interval analysis of the bitvector local variables of a
+// function, which records for every expression the hull of the values it
+// takes at the program points where it is evaluated, and for every local
+// variable the hull of the values assigned to it.
+class RangeAnalysis {
+  // The intervals of the tracked local variables; those which are absent
+  // are unbounded.
+  typedef std::map<Var *, Interval> State;
+
+  Function *F;
+  std::set<Var *> Locals;
+  std::map<Expr *, Interval> &Ranges;
+  std::map<Var *, Interval> &VarRanges;
+  std::set<Expr *> &BitUsed;
+  // Variables which are used bitwise, or which may be read before they are
+  // assigned.
+  std::set<Var *> &ExcludedVars;
+
+  std::map<BasicBlock *, unsigned> BlockIds;
+  // The entry states of the blocks reached so far.
+  std::map<BasicBlock *, State> EntryStates;
+  std::map<BasicBlock *, unsigned> Updates;
+  std::set<unsigned> Worklist;
+  // The values of the expressions evaluated in the current statement.
+  std::map<Expr *, Interval> Memo;
+
+  Interval eval(Expr *E, const State &S);
+  Interval evalDefinition(Expr *E, const State &S);
+  Interval compute(Expr *E, const std::vector<Expr *> &Ops,
+                   const std::vector<Interval> &OpRanges, const State &S);
+  bool constrain(Expr *E, Expr::Kind K, const Interval &Bound, State &S);
+  bool refine(Expr *Pred, bool Positive, State &S);
+  void propagate(BasicBlock *BB, const State &S);
+  void transfer(BasicBlock *BB);
+
+public:
+  RangeAnalysis(Function *F, std::map<Expr *, Interval> &Ranges,
+                std::map<Var *, Interval> &VarRanges,
+                std::set<Expr *> &BitUsed, std::set<Var *> &ExcludedVars)
+      : F(F), Ranges(Ranges), VarRanges(VarRanges), BitUsed(BitUsed),
+        ExcludedVars(ExcludedVars) {
+    for (auto i = F->local_begin(), e = F->local_end(); i != e; ++i)
+      if (isTracked(*i))
+        Locals.insert(*i);
+  }
+  void run();
+};
+}
+
+// Expressions captured by an EvalStmt are evaluated by that statement, which
+// dominates their uses.
+Interval RangeAnalysis::eval(Expr *E, const State &S) {
+  if (E->hasEvalStmt) {
+    auto i = Ranges.find(E);
+    if (i != Ranges.end())
+      return i->second;
+    return isTracked(E) ? getFull(E->getType().width) : Interval{0, 0};
+  }
+  return evalDefinition(E, S);
+}
+
+Interval RangeAnalysis::evalDefinition(Expr *E, const State &S) {
+  auto m = Memo.find(E);
+  if (m != Memo.end())
+    return m->second;
+
+  std::vector<Expr *> Ops;
+  E->getOperands(Ops);
+  std::vector<Interval> OpRanges;
+  for (auto *Op : Ops)
+    OpRanges.push_back(eval(Op, S));
+
+  if (isBitLevel(E)) {
+    for (auto *Op : Ops) {
+      BitUsed.insert(Op);
+      if (auto *VRE = dyn_cast<VarRefExpr>(Op))
+        ExcludedVars.insert(VRE->getVar());
+    }
+  }
+
+  Interval I = {0, 0};
+  if (isTracked(E)) {
+    I = compute(E, Ops, OpRanges, S);
+    unsigned Width = E->getType().width;
+    if (I.Lo < getMin(Width) || I.Hi > getMax(Width))
+      I = getFull(Width);
+    auto i = Ranges.find(E);
+    if (i == Ranges.end())
+      Ranges[E] = I;
+    else
+      i->second = join(i->second, I);
+  }
+  Memo[E] = I;
+  return I;
+}
+
+Interval RangeAnalysis::compute(Expr *E, const std::vector<Expr *> &Ops,
+                                const std::vector<Interval> &OpRanges,
+                                const State &S) {
+  unsigned Width = E->getType().width;
+  Interval Full = getFull(Width);
+  int64_t C;
+  if (getConstant(E, C))
+    return {C, C};
+
+  if (auto *VRE = dyn_cast<VarRefExpr>(E)) {
+    auto i = S.find(VRE->getVar());
+    if (i != S.end())
+      return i->second;
+    ExcludedVars.insert(VRE->getVar());
+    return Full;
+  }
+
+  // The remaining rules only need the operands which are bitvectors to be
+  // tracked; the condition of an if-then-else is not.
+  for (auto *Op : Ops)
+    if (Op->getType().isKind(Type::BV) && !isTracked(Op))
+      return Full;
+
+  Interval R;
+  switch (E->getKind()) {
+  case Expr::BVAdd: {
+    const Interval &A = OpRanges[0], &B = OpRanges[1];
+    if (checkedAdd(A.Lo, B.Lo, R.Lo) && checkedAdd(A.Hi, B.Hi, R.Hi))
+      return R;
+    return Full;
+  }
+  case Expr::BVSub: {
+    const Interval &A = OpRanges[0], &B = OpRanges[1];
+    if (checkedSub(A.Lo, B.Hi, R.Lo) && checkedSub(A.Hi, B.Lo, R.Hi))
+      return R;
+    return Full;
+  }
+  case Expr::BVMul: {
+    const Interval &A = OpRanges[0], &B = OpRanges[1];
+    int64_t P[4];
+    if (!checkedMul(A.Lo, B.Lo, P[0]) || !checkedMul(A.Lo, B.Hi, P[1]) ||
+        !checkedMul(A.Hi, B.Lo, P[2]) || !checkedMul(A.Hi, B.Hi, P[3]))
+      return Full;
+    return {*std::min_element(P, P + 4), *std::max_element(P, P + 4)};
+  }
+  case Expr::BVSExt:
+    return OpRanges[0];
+  case Expr::BVZExt: {
+    if (OpRanges[0].Lo >= 0)
+      return OpRanges[0];
+    unsigned FromWidth = Ops[0]->getType().width;
+    return {0, (int64_t)(UINT64_MAX >> (64 - FromWidth))};
+  }
+  case Expr::BVExtract:
+    if (cast<BVExtractExpr>(E)->getOffset() == 0)
+      return OpRanges[0];
+    return Full;
+  case Expr::BVAnd: {
+    const Interval &A = OpRanges[0], &B = OpRanges[1];
+    if (A.Lo >= 0 && B.Lo >= 0)
+      return {0, std::min(A.Hi, B.Hi)};
+    if (A.Lo >= 0 || B.Lo >= 0)
+      return {0, A.Lo >= 0 ? A.Hi : B.Hi};
+    return Full;
+  }
+  case Expr::BVAShr:
+  case Expr::BVLShr: {
+    const Interval &A = OpRanges[0];
+    if (!getConstant(Ops[1], C) || C < 0 || C >= (int64_t)Width)
+      return Full;
+    if (A.Lo >= 0 || E->getKind() == Expr::BVAShr)
+      return {A.Lo >> C, A.Hi >> C};
+    return Full;
+  }
+  case Expr::BVSDiv:
+  case Expr::BVUDiv: {
+    const Interval &A = OpRanges[0];
+    if (!getConstant(Ops[1], C) || C <= 0)
+      return Full;
+    if (A.Lo >= 0 || E->getKind() == Expr::BVSDiv)
+      return {A.Lo / C, A.Hi / C};
+    return Full;
+  }
+  case Expr::BVSRem:
+  case Expr::BVURem: {
+    const Interval &A = OpRanges[0];
+    if (!getConstant(Ops[1], C) || C <= 0 || A.Lo < 0)
+      return Full;
+    return {0, std::min(A.Hi, C - 1)};
+  }
+  case Expr::IfThenElse:
+    return join(OpRanges[1], OpRanges[2]);
+  default:
+    return Full;
+  }
+}
+
+// Narrow the interval of E, if it is a tracked local variable, to the values
+// which satisfy "E K Bound". Returns false if there are none.
+bool RangeAnalysis::constrain(Expr *E, Expr::Kind K, const Interval &Bound,
+                              State &S) {
+  auto *VRE = dyn_cast<VarRefExpr>(E);
+  if (!VRE || !Locals.count(VRE->getVar()))
+    return true;
+  Var *V = VRE->getVar();
+  unsigned Width = V->getType().width;
+  Interval Cur = getFull(Width);
+  auto i = S.find(V);
+  if (i != S.end())
+    Cur = i->second;
+
+  // Unsigned comparisons of nonnegative values agree with signed ones.
+  if (Bound.Lo >= 0 && (K == Expr::BVUlt || K == Expr::BVUle)) {
+    Cur.Lo = std::max(Cur.Lo, (int64_t)0);
+    K = K == Expr::BVUlt ? Expr::BVSlt : Expr::BVSle;
+  } else if (Bound.Lo >= 0 && Cur.Lo >= 0 &&
+             (K == Expr::BVUgt || K == Expr::BVUge)) {
+    K = K == Expr::BVUgt ? Expr::BVSgt : Expr::BVSge;
+  }
+
+  switch (K) {
+  case Expr::Eq:
+    Cur.Lo = std::max(Cur.Lo, Bound.Lo);
+    Cur.Hi = std::min(Cur.Hi, Bound.Hi);
+    break;
+  case Expr::Ne:
+    if (Bound.Lo == Bound.Hi && Cur.Lo == Bound.Lo) {
+      if (Cur.Lo == Cur.Hi)
+        return false;
+      ++Cur.Lo;
+    } else if (Bound.Lo == Bound.Hi && Cur.Hi == Bound.Hi) {
+      --Cur.Hi;
+    }
+    break;
+  case Expr::BVSlt:
+    if (Bound.Hi == getMin(Width))
+      return false;
+    Cur.Hi = std::min(Cur.Hi, Bound.Hi - 1);
+    break;
+  case Expr::BVSle:
+    Cur.Hi = std::min(Cur.Hi, Bound.Hi);
+    break;
+  case Expr::BVSgt:
+    if (Bound.Lo == getMax(Width))
+      return false;
+    Cur.Lo = std::max(Cur.Lo, Bound.Lo + 1);
+    break;
+  case Expr::BVSge:
+    Cur.Lo = std::max(Cur.Lo, Bound.Lo);
+    break;
+  default:
+    break;
+  }
+
+  if (Cur.Lo > Cur.Hi)
+    return false;
+  S[V] = Cur;
+  return true;
+}
+
+// Narrow S to the states in which Pred has the value Positive. Returns false
+// if there are none.
+bool RangeAnalysis::refine(Expr *Pred, bool Positive, State &S) {
+  if (auto *NE = dyn_cast<NotExpr>(Pred))
+    return refine(NE->getSubExpr().get(), !Positive, S);
+  if (auto *BCE = dyn_cast<BoolConstExpr>(Pred))
+    return BCE->getValue() == Positive;
+  if ((isa<AndExpr>(Pred) && Positive) || (isa<OrExpr>(Pred) && !Positive)) {
+    auto *BE = cast<BinaryExpr>(Pred);
+    return refine(BE->getLHS().get(), Positive, S) &&
+           refine(BE->getRHS().get(), Positive, S);
+  }
+
+  auto *BE = dyn_cast<BinaryExpr>(Pred);
+  if (!BE || !isTracked(BE->getLHS().get()))
+    return true;
+  Expr::Kind K = BE->getKind();
+  if (K != Expr::Eq && K != Expr::Ne && (K < Expr::BVUgt || K > Expr::BVSle))
+    return true;
+  if (!Positive)
+    K = negate(K);
+
+  Expr *LHS = BE->getLHS().get(), *RHS = BE->getRHS().get();
+  Interval L = eval(LHS, S), R = eval(RHS, S);
+  return constrain(LHS, K, R, S) && constrain(RHS, swap(K), L, S);
+}
+
+void RangeAnalysis::propagate(BasicBlock *BB, const State &S) {
+  auto i = EntryStates.find(BB);
+  if (i == EntryStates.end()) {
+    EntryStates[BB] = S;
+    Worklist.insert(BlockIds[BB]);
+    return;
+  }
+
+  State &Entry = i->second;
+  bool Widen = Updates[BB] >= WideningThreshold;
+  bool Changed = false;
+  for (auto j = Entry.begin(); j != Entry.end();) {
+    auto k = S.find(j->first);
+    if (k == S.end()) {
+      j = Entry.erase(j);
+      Changed = true;
+      continue;
+    }
+    Interval New = join(j->second, k->second);
+    if (Widen) {
+      unsigned Width = j->first->getType().width;
+      if (New.Lo < j->second.Lo)
+        New.Lo = getMin(Width);
+      if (New.Hi > j->second.Hi)
+        New.Hi = getMax(Width);
+    }
+    if (!(New == j->second)) {
+      j->second = New;
+      Changed = true;
+    }
+    ++j;
+  }
+
+  if (Changed) {
+    ++Updates[BB];
+    Worklist.insert(BlockIds[BB]);
+  }
+}
+
+void RangeAnalysis::transfer(BasicBlock *BB) {
+  State S = EntryStates[BB];
+  for (auto *St : *BB) {
+    Memo.clear();
+    if (auto *ES = dyn_cast<EvalStmt>(St)) {
+      evalDefinition(ES->getExpr().get(), S);
+    } else if (auto *VAS = dyn_cast<VarAssignStmt>(St)) {
+      const auto &Vars = VAS->getVars();
+      const auto &Values = VAS->getValues();
+      std::vector<Interval> Results;
+      for (const auto &V : Values)
+        Results.push_back(eval(V.get(), S));
+      for (unsigned i = 0; i < Vars.size(); ++i) {
+        if (!Locals.count(Vars[i]))
+          continue;
+        S[Vars[i]] = Results[i];
+        auto j = VarRanges.find(Vars[i]);
+        if (j == VarRanges.end())
+          VarRanges[Vars[i]] = Results[i];
+        else
+          j->second = join(j->second, Results[i]);
+      }
+    } else if (auto *AS = dyn_cast<AssumeStmt>(St)) {
+      eval(AS->getPredicate().get(), S);
+      if (!refine(AS->getPredicate().get(), true, S))
+        return;
+    } else if (auto *GS = dyn_cast<GotoStmt>(St)) {
+      for (auto *Succ : GS->getBlocks())
+        propagate(Succ, S);
+    } else if (auto *SS = dyn_cast<StoreStmt>(St)) {
+      eval(SS->getArray().get(), S);
+      eval(SS->getOffset().get(), S);
+      eval(SS->getValue().get(), S);
+    } else if (auto *AtS = dyn_cast<AssertStmt>(St)) {
+      eval(AtS->getPredicate().get(), S);
+    } else if (auto *CS = dyn_cast<CallStmt>(St)) {
+      for (const auto &A : CS->getArgs())
+        eval(A.get(), S);
+    } else if (auto *CMOS = dyn_cast<CallMemberOfStmt>(St)) {
+      eval(CMOS->getFunc().get(), S);
+      for (auto *CS : CMOS->getCallStmts())
+        for (const auto &A : cast<CallStmt>(CS)->getArgs())
+          eval(A.get(), S);
+    } else if (auto *WGES = dyn_cast<WaitGroupEventStmt>(St)) {
+      eval(WGES->getHandle().get(), S);
+    }
+  }
+}
+
+// Blocks are taken from the worklist in their order in the function, which
+// places the definitions of values before their uses.
+void RangeAnalysis::run() {
+  if (F->begin() == F->end())
+    return;
+  std::vector<BasicBlock *> Blocks(F->begin(), F->end());
+  for (unsigned i = 0; i < Blocks.size(); ++i)
+    BlockIds[Blocks[i]] = i;
+
+  propagate(*F->begin(), State());
+  while (!Worklist.empty()) {
+    unsigned Id = *Worklist.begin();
+    Worklist.erase(Worklist.begin());
+    transfer(Blocks[Id]);
+  }
+}
+
+// An expression is written as an integer if it is a sum, difference,
+// product, extension or truncation whose value and non-constant operands are
+// nonnegative wherever it is evaluated, as then no bitvector operation in it
+// wraps around, and if one of its operands is itself an integer, as otherwise
+// it would only be converted back and forth.
+void HybridIntegerRepresentation::analyse(Module *M) {
+  std::map<Expr *, Interval> Ranges;
+  std::map<Var *, Interval> VarRanges;
+  std::set<Expr *> BitUsed;
+  std::set<Var *> ExcludedVars;
+  for (auto i = M->function_begin(), e = M->function_end(); i != e; ++i) {
+    RangeAnalysis RA(*i, Ranges, VarRanges, BitUsed, ExcludedVars);
+    RA.run();
+  }
+
+  for (const auto &VR : VarRanges)
+    if (VR.second.Lo >= 0 && !ExcludedVars.count(VR.first))
+      MathVars.insert(VR.first);
+
+  for (const auto &R : Ranges) {
+    Expr *E = R.first;
+    if (R.second.Lo < 0 || BitUsed.count(E))
+      continue;
+    bool AllowConstants;
+    switch (E->getKind()) {
+    case Expr::BVAdd:
+    case Expr::BVSub:
+    case Expr::BVMul:
+      AllowConstants = true;
+      break;
+    case Expr::BVZExt:
+    case Expr::BVSExt:
+      AllowConstants = false;
+      break;
+    case Expr::BVExtract:
+      if (cast<BVExtractExpr>(E)->getOffset() != 0)
+        continue;
+      AllowConstants = false;
+      break;
+    default:
+      continue;
+    }
+
+    std::vector<Expr *> Ops;
+    E->getOperands(Ops);
+    bool Valid = true;
+    for (auto *Op : Ops) {
+      if (AllowConstants && isa<BVConstExpr>(Op))
+        continue;
+      auto i = Ranges.find(Op);
+      if (i == Ranges.end() || i->second.Lo < 0) {
+        Valid = false;
+        break;
+      }
+    }
+    if (Valid)
+      MathExprs.insert(E);
+  }
+
+  bool Changed = true;
+  while (Changed) {
+    Changed = false;
+    for (auto i = MathExprs.begin(); i != MathExprs.end();) {
+      std::vector<Expr *> Ops;
+      (*i)->getOperands(Ops);
+      if (std::none_of(Ops.begin(), Ops.end(),
+                       [&](Expr *Op) { return isMathValue(Op); })) {
+        i = MathExprs.erase(i);
+        Changed = true;
+      } else {
+        ++i;
+      }
+    }
+  }
+}
+
+bool HybridIntegerRepresentation::isMathValue(Expr *E) {
+  if (auto *VRE = dyn_cast<VarRefExpr>(E))
+    return MathVars.count(VRE->getVar());
+  return MathExprs.count(E);
+}
+
+bool HybridIntegerRepresentation::isMathVar(Var *V) {
+  return MathVars.count(V);
+}
+
+std::string HybridIntegerRepresentation::getToMath(unsigned Width) {
+  std::string S; llvm::raw_string_ostream SS(S);
+  SS << "function {:builtin \"bv2nat\"} BV" << Width << "_TO_INT(bv" << Width
+     << ") : int;";
+  return SS.str();
+}
+
+std::string HybridIntegerRepresentation::getFromMath(unsigned Width) {
+  std::string S; llvm::raw_string_ostream SS(S);
+  SS << "function {:builtin \"(_ int2bv " << Width << ")\"} INT_TO_BV" << Width
+     << "(int) : bv" << Width << ";";
+  return SS.str();
+}
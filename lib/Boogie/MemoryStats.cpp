@@ -0,0 +1,101 @@
+#include "bugle/MemoryStats.h"
+#include "bugle/BasicBlock.h"
+#include "bugle/Function.h"
+#include "bugle/Module.h"
+#include "bugle/Stmt.h"
+#include "bugle/util/Profiler.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace bugle;
+
+template <typename T> static uint64_t vectorBytes(const std::vector<T> &V) {
+  return V.capacity() * sizeof(T);
+}
+
+ModuleMemoryStats::ModuleMemoryStats(Module *M)
+    : StmtCount(0), StmtBytes(0), BlockCount(0), BlockBytes(0),
+      SourceLocsCount(0), SourceLocsBytes(0) {
+  for (auto fi = M->function_begin(), fe = M->function_end(); fi != fe; ++fi) {
+    for (auto *BB : **fi) {
+      ++BlockCount;
+      BlockBytes += sizeof(BasicBlock) + BB->getName().capacity() +
+                         vectorBytes(BB->getStmtVector());
+      for (auto *S : *BB)
+        addStmt(S);
+    }
+  }
+  SeenLocs.clear();
+}
+
+void ModuleMemoryStats::addSourceLocs(const SourceLocsRef &SLocs) {
+  if (!SLocs || !SeenLocs.insert(SLocs.get()).second)
+    return;
+
+  ++SourceLocsCount;
+  SourceLocsBytes += sizeof(SourceLocs) + vectorBytes(*SLocs);
+  for (const auto &SL : *SLocs)
+    SourceLocsBytes += SL.getFileName().capacity() + SL.getPath().capacity();
+}
+
+void ModuleMemoryStats::addStmt(Stmt *S) {
+  ++StmtCount;
+  switch (S->getKind()) {
+  case Stmt::Eval:
+    StmtBytes += sizeof(EvalStmt);
+    break;
+  case Stmt::Store:
+    StmtBytes += sizeof(StoreStmt);
+    break;
+  case Stmt::VarAssign: {
+    auto *VAS = cast<VarAssignStmt>(S);
+    StmtBytes += sizeof(VarAssignStmt) + vectorBytes(VAS->getVars()) +
+                 vectorBytes(VAS->getValues());
+    return;
+  }
+  case Stmt::Goto:
+    StmtBytes +=
+        sizeof(GotoStmt) + vectorBytes(cast<GotoStmt>(S)->getBlocks());
+    return;
+  case Stmt::Return:
+    StmtBytes += sizeof(ReturnStmt);
+    break;
+  case Stmt::Assume:
+    StmtBytes += sizeof(AssumeStmt);
+    return;
+  case Stmt::Assert:
+    StmtBytes += sizeof(AssertStmt);
+    break;
+  case Stmt::Call:
+    StmtBytes += sizeof(CallStmt) + vectorBytes(cast<CallStmt>(S)->getArgs());
+    break;
+  case Stmt::CallMemberOf: {
+    auto CallStmts = cast<CallMemberOfStmt>(S)->getCallStmts();
+    StmtBytes += sizeof(CallMemberOfStmt) + vectorBytes(CallStmts);
+    for (auto *CS : CallStmts)
+      addStmt(CS);
+    break;
+  }
+  case Stmt::WaitGroupEvent:
+    StmtBytes += sizeof(WaitGroupEventStmt);
+    break;
+  }
+  addSourceLocs(S->getSourceLocs());
+}
+
+void ModuleMemoryStats::print(llvm::raw_ostream &OS) const {
+  OS << "  statements: " << StmtCount << " (" << StmtBytes << " bytes)\n"
+     << "  basic blocks: " << BlockCount << " (" << BlockBytes
+     << " bytes)\n"
+     << "  source locations: " << SourceLocsCount << " (" << SourceLocsBytes
+     << " bytes)\n";
+}
+
+void ModuleMemoryStats::reportCounters(llvm::StringRef Prefix) const {
+  std::string P = Prefix.str() + ".";
+  Profiler::addToCounter(P + "stmts", StmtCount);
+  Profiler::addToCounter(P + "stmt-bytes", StmtBytes);
+  Profiler::addToCounter(P + "basic-blocks", BlockCount);
+  Profiler::addToCounter(P + "basic-block-bytes", BlockBytes);
+  Profiler::addToCounter(P + "source-locs", SourceLocsCount);
+  Profiler::addToCounter(P + "source-locs-bytes", SourceLocsBytes);
+}
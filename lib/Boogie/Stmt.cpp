@@ -5,6 +5,59 @@
 
 using namespace bugle;
 
+void Stmt::getOperands(std::vector<Expr *> &Ops) const {
+  if (auto *ES = dyn_cast<EvalStmt>(this)) {
+    ES->expr->getOperands(Ops);
+  } else if (auto *SS = dyn_cast<StoreStmt>(this)) {
+    Ops.push_back(SS->array.get());
+    Ops.push_back(SS->offset.get());
+    Ops.push_back(SS->value.get());
+  } else if (auto *VAS = dyn_cast<VarAssignStmt>(this)) {
+    for (const auto &E : VAS->values)
+      Ops.push_back(E.get());
+  } else if (auto *AS = dyn_cast<AssumeStmt>(this)) {
+    Ops.push_back(AS->pred.get());
+  } else if (auto *AtS = dyn_cast<AssertStmt>(this)) {
+    Ops.push_back(AtS->pred.get());
+  } else if (auto *CS = dyn_cast<CallStmt>(this)) {
+    for (const auto &E : CS->args)
+      Ops.push_back(E.get());
+  } else if (auto *CMOS = dyn_cast<CallMemberOfStmt>(this)) {
+    Ops.push_back(CMOS->func.get());
+    for (auto *S : CMOS->callStmts)
+      S->getOperands(Ops);
+  } else if (auto *WGES = dyn_cast<WaitGroupEventStmt>(this)) {
+    Ops.push_back(WGES->handle.get());
+  }
+}
+
+void Stmt::replaceOperands(const std::function<ref<Expr>(Expr *)> &F) {
+  auto replace = [&](ref<Expr> &E) { E = F(E.get()); };
+  if (auto *ES = dyn_cast<EvalStmt>(this)) {
+    ES->expr->replaceOperands(F);
+  } else if (auto *SS = dyn_cast<StoreStmt>(this)) {
+    replace(SS->array);
+    replace(SS->offset);
+    replace(SS->value);
+  } else if (auto *VAS = dyn_cast<VarAssignStmt>(this)) {
+    for (auto &E : VAS->values)
+      replace(E);
+  } else if (auto *AS = dyn_cast<AssumeStmt>(this)) {
+    replace(AS->pred);
+  } else if (auto *AtS = dyn_cast<AssertStmt>(this)) {
+    replace(AtS->pred);
+  } else if (auto *CS = dyn_cast<CallStmt>(this)) {
+    for (auto &E : CS->args)
+      replace(E);
+  } else if (auto *CMOS = dyn_cast<CallMemberOfStmt>(this)) {
+    replace(CMOS->func);
+    for (auto *S : CMOS->callStmts)
+      S->replaceOperands(F);
+  } else if (auto *WGES = dyn_cast<WaitGroupEventStmt>(this)) {
+    replace(WGES->handle);
+  }
+}
+
 EvalStmt *EvalStmt::create(ref<Expr> expr, const SourceLocsRef &sourcelocs) {
   assert(!expr->hasEvalStmt);
   expr->hasEvalStmt = true;
@@ -58,8 +111,12 @@ AssumeStmt *AssumeStmt::create(ref<Expr> pred) {
   return new AssumeStmt(pred, false);
 }
 
-AssumeStmt *AssumeStmt::createPartition(ref<Expr> pred) {
-  return new AssumeStmt(pred, true);
+AssumeStmt *AssumeStmt::createPartition(ref<Expr> pred, bool groupUniform,
+                                        bool uniform) {
+  AssumeStmt *AS = new AssumeStmt(pred, true);
+  AS->groupUniform = groupUniform || uniform;
+  AS->uniform = uniform;
+  return AS;
 }
 
 AssertStmt *AssertStmt::create(ref<Expr> pred, bool global, bool candidate,
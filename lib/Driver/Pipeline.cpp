@@ -0,0 +1,169 @@
+#include "bugle/Driver/Pipeline.h"
+#include "bugle/BPLModuleWriter.h"
+#include "bugle/Module.h"
+#include "bugle/Preprocessing/ArgumentPromotionPass.h"
+#include "bugle/Preprocessing/ArgumentRenamePass.h"
+#include "bugle/Preprocessing/BoundedUnrollPass.h"
+#include "bugle/Preprocessing/CycleDetectPass.h"
+#include "bugle/Preprocessing/FreshArrayPass.h"
+#include "bugle/Preprocessing/InlinePass.h"
+#include "bugle/Preprocessing/LoopUnrollPass.h"
+#include "bugle/Preprocessing/RestrictDetectPass.h"
+#include "bugle/Preprocessing/SimpleInternalizePass.h"
+#include "bugle/Preprocessing/StructSimplificationPass.h"
+#include "bugle/Preprocessing/Vector3SimplificationPass.h"
+#include "bugle/Transform/AffineAccessSummary.h"
+#include "bugle/Transform/ConstantPropagation.h"
+#include "bugle/Transform/GlobalValueNumbering.h"
+#include "bugle/Transform/SimplifyCFG.h"
+#include "bugle/Transform/SimplifyStmt.h"
+#include "bugle/util/ErrorReporter.h"
+#include "bugle/util/Profiler.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Transforms/IPO.h"
+#include "llvm/Transforms/InstCombine/InstCombine.h"
+#include "llvm/Transforms/Scalar.h"
+#include "llvm/Transforms/Scalar/GVN.h"
+
+using namespace llvm;
+using namespace bugle;
+
+static void AddPass(legacy::PassManager &PM, Pass *P) {
+  if (!Profiler::isEnabled()) {
+    PM.add(P);
+    return;
+  }
+
+  PM.add(createBeginPhasePass(P->getPassName()));
+  PM.add(P);
+  PM.add(createEndPhasePass());
+}
+
+// The pre-optimization passes must not give a thread an access to shared
+// memory on a path on which it made none, as the added access may race. They
+// must not move accesses across barriers either; barriers, and the
+// specification functions which must be translated in place, are declared
+// without a body, so no pass moves accesses across calls to them.
+//
+// GVN is therefore run without load PRE, which inserts loads on paths which
+// had none. SimplifyCFG is not offered, as it speculates loads into selects
+// and merges conditional stores into unconditional ones. InstCombine still
+// loads both sides of a select of two dereferenceable pointers, which may add
+// an access to a shared global array. The intrinsics InstCombine introduces
+// for byte swaps, bit reversals and multiplication overflow checks are
+// handled by the translator.
+static void AddPreOptPasses(legacy::PassManager &PM, StringRef PreOpt) {
+  if (PreOpt.empty() || PreOpt == "O0")
+    return;
+
+  SmallVector<StringRef, 8> Names;
+  if (PreOpt == "O1")
+    StringRef("sroa,early-cse,instcombine,gvn,instcombine,adce")
+        .split(Names, ",");
+  else
+    PreOpt.split(Names, ",");
+
+  // The legacy GVN pass can only be configured through its command line
+  // option.
+  auto &Options = cl::getRegisteredOptions();
+  auto LoadPRE = Options.find("enable-load-pre");
+  if (LoadPRE != Options.end())
+    static_cast<cl::opt<bool> *>(LoadPRE->second)->setValue(false);
+
+  for (auto Name : Names) {
+    Pass *P;
+    if (Name == "sroa")
+      P = createSROAPass();
+    else if (Name == "early-cse")
+      P = createEarlyCSEPass();
+    else if (Name == "gvn")
+      P = createGVNPass();
+    else if (Name == "instcombine")
+      P = createInstructionCombiningPass();
+    else if (Name == "adce")
+      P = createAggressiveDCEPass();
+    else
+      ErrorReporter::reportParameterError("Unknown pre-optimization pass: " +
+                                          Name.str());
+    AddPass(PM, P);
+  }
+}
+
+void Pipeline::preprocess() {
+  legacy::PassManager PM;
+  AddPass(PM, new FreshArrayPass());
+  AddPass(PM, new Vector3SimplificationPass());
+  AddPass(PM, new ArgumentPromotionPass(FC));
+  AddPass(PM, new StructSimplificationPass(M));
+  if (Opts.Inlining) {
+    AddPass(PM, new CycleDetectPass());
+    AddPass(PM, new InlinePass(FC));
+    AddPass(PM, new StructSimplificationPass(M));
+  }
+  if (Opts.Inlining || Opts.OnlyExplicitEntryPoints)
+    AddPass(PM, new SimpleInternalizePass(FC, Opts.OnlyExplicitEntryPoints));
+  AddPass(PM, createPromoteMemoryToRegisterPass());
+  AddPreOptPasses(PM, Opts.PreOpt);
+  if (Opts.UnrollThreshold > 0)
+    AddPass(PM, new LoopUnrollPass(FC, Opts.UnrollThreshold));
+  if (Opts.BoundedUnroll > 0)
+    AddPass(PM, new BoundedUnrollPass(FC, Opts.BoundedUnroll));
+  AddPass(PM, createGlobalDCEPass());
+  AddPass(PM, new RestrictDetectPass(FC, Opts.AddressSpaces));
+  AddPass(PM, new ArgumentRenamePass());
+#ifndef NDEBUG
+  AddPass(PM, createVerifierPass());
+#endif
+
+  ScopedPhase P("preprocess");
+  PM.run(*M);
+}
+
+void Pipeline::translate() {
+  TM.reset(new TranslateModule(M, Opts.SL, FC, Opts.RaceInstrumentation,
+                               Opts.AddressSpaces, Opts.ArraySizes,
+                               Opts.Launch, Opts.ArgValues,
+                               Opts.NarrowBitWidths));
+  ScopedPhase P("translate");
+  TM->translate();
+  BM.reset(TM->takeModule());
+}
+
+void Pipeline::transform() {
+  if (Opts.PropagateConstants) {
+    ScopedPhase P("propagateConstants");
+    propagateConstants(BM.get());
+  }
+
+  if (Opts.SimplifyCFG) {
+    ScopedPhase P("simplifyCFG");
+    simplifyCFG(BM.get());
+  }
+
+  if (Opts.GlobalValueNumbering) {
+    ScopedPhase P("numberGlobalValues");
+    numberGlobalValues(BM.get());
+  }
+
+  // Before simplification every access is an individual statement.
+  if (Opts.AffineAccessSummaries) {
+    ScopedPhase P("summarizeAffineAccesses");
+    summarizeAffineAccesses(BM.get());
+  }
+
+  ScopedPhase P("simplifyStmt");
+  simplifyStmt(BM.get());
+}
+
+void Pipeline::write(raw_ostream &OS, IntegerRepresentation *IntRep,
+                     SourceLocWriter *SLW) {
+  BPLModuleWriter MW(OS, BM.get(), IntRep, Opts.RaceInstrumentation, SLW,
+                     Opts.PruneRaceInstrumentation, Opts.SplitPointers,
+                     Opts.CoalesceVars);
+  ScopedPhase P("write");
+  MW.write();
+}
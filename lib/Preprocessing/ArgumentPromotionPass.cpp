@@ -15,7 +15,7 @@ using namespace bugle;
 
 bool ArgumentPromotionPass::needsPromotion(llvm::Function *F) {
   // Only apply promotion to normal functions.
-  if (TranslateFunction::isNormalFunction(SL, F))
+  if (FC.isNormalFunction(F))
     for (auto &Arg : F->args())
       if (Arg.hasByValAttr())
         return true;
@@ -234,6 +234,11 @@ bool ArgumentPromotionPass::runOnModule(llvm::Module &M) {
     }
   }
 
+  // The promoted functions have replaced the originals, including in the
+  // kernel meta-data.
+  if (promoted)
+    FC.invalidate();
+
   return promoted;
 }
 
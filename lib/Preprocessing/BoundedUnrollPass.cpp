@@ -0,0 +1,270 @@
+#include "bugle/Preprocessing/BoundedUnrollPass.h"
+#include "bugle/Translator/TranslateFunction.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Analysis/LoopInfo.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Dominators.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Transforms/Utils/Cloning.h"
+#include "llvm/Transforms/Utils/SSAUpdater.h"
+#include "llvm/Transforms/Utils/ValueMapper.h"
+#include <memory>
+#include <vector>
+
+using namespace llvm;
+using namespace bugle;
+
+namespace {
+
+Value *mapValue(ValueToValueMapTy *VMap, Value *V) {
+  if (!VMap)
+    return V;
+  auto i = VMap->find(V);
+  return i == VMap->end() ? V : (Value *)i->second;
+}
+
+// Add the exit edges of NewBB, a copy of the loop block BB, to the phi nodes
+// of the exit blocks.
+void addExitEdges(llvm::BasicBlock *BB, llvm::BasicBlock *NewBB,
+                  ValueToValueMapTy &VMap,
+                  const SmallPtrSetImpl<llvm::BasicBlock *> &InLoop) {
+  SmallPtrSet<llvm::BasicBlock *, 4> Exits;
+  for (auto *Succ : successors(BB)) {
+    if (InLoop.count(Succ) || !Exits.insert(Succ).second)
+      continue;
+    for (auto &I : *Succ) {
+      auto *PN = dyn_cast<PHINode>(&I);
+      if (!PN)
+        break;
+      SmallVector<Value *, 2> Incoming;
+      for (unsigned j = 0, e = PN->getNumIncomingValues(); j != e; ++j)
+        if (PN->getIncomingBlock(j) == BB)
+          Incoming.push_back(PN->getIncomingValue(j));
+      for (auto *V : Incoming)
+        PN->addIncoming(mapValue(&VMap, V), NewBB);
+    }
+  }
+}
+}
+
+bool BoundedUnrollPass::removeInvariants(llvm::Function &F) {
+  std::vector<Instruction *> Invariants;
+  for (auto &BB : F) {
+    for (auto &I : BB) {
+      auto *CI = dyn_cast<CallInst>(&I);
+      if (CI && CI->getCalledFunction() &&
+          FC.isLoopInvariantFunction(CI->getCalledFunction()))
+        Invariants.push_back(CI);
+    }
+  }
+
+  for (auto *I : Invariants)
+    I->eraseFromParent();
+  return !Invariants.empty();
+}
+
+// The cut block assumes false and returns, which is sound as no path through
+// it is feasible.
+llvm::BasicBlock *BoundedUnrollPass::createCutBlock(llvm::Function &F,
+                                                    llvm::BasicBlock *Header) {
+  LLVMContext &Ctx = F.getContext();
+  llvm::Module *M = F.getParent();
+  llvm::Function *Assume = M->getFunction("bugle_assume");
+  if (!Assume) {
+    auto *FT = FunctionType::get(llvm::Type::getVoidTy(Ctx),
+                                 llvm::Type::getInt1Ty(Ctx), false);
+    Assume = llvm::Function::Create(FT, GlobalValue::ExternalLinkage,
+                                    "bugle_assume", M);
+  }
+
+  llvm::BasicBlock *Cut =
+      llvm::BasicBlock::Create(Ctx, Header->getName() + ".cut", &F);
+  CallInst::Create(Assume, Constant::getNullValue(
+                               Assume->getFunctionType()->getParamType(0)),
+                   "", Cut);
+  llvm::Type *RetTy = F.getReturnType();
+  ReturnInst::Create(Ctx, RetTy->isVoidTy() ? nullptr : UndefValue::get(RetTy),
+                     Cut);
+  return Cut;
+}
+
+// Copy i of the loop body is entered only from the latches of copy i - 1, and
+// the latches of the last copy branch to a further copy of the header, so
+// that paths which leave the loop after exactly Depth iterations are kept.
+// That copy branches to the cut block instead of back into the loop. Values
+// defined in the loop and used after it may now come from any copy, so SSA
+// form is repaired for their uses outside the loop.
+void BoundedUnrollPass::unrollLoop(llvm::Function &F, Loop *L) {
+  llvm::BasicBlock *Header = L->getHeader();
+  std::vector<llvm::BasicBlock *> Blocks(L->block_begin(), L->block_end());
+  SmallPtrSet<llvm::BasicBlock *, 16> InLoop(Blocks.begin(), Blocks.end());
+  SmallVector<llvm::BasicBlock *, 4> Latches;
+  L->getLoopLatches(Latches);
+
+  // Uses of loop values outside the loop, other than by the incoming values
+  // of phi nodes on exit edges, which are extended for each copy below.
+  std::vector<std::pair<Instruction *, SmallVector<Use *, 4>>> OutsideUses;
+  for (auto *BB : Blocks) {
+    for (auto &I : *BB) {
+      SmallVector<Use *, 4> Uses;
+      for (auto &U : I.uses()) {
+        auto *User = cast<Instruction>(U.getUser());
+        llvm::BasicBlock *UseBB = User->getParent();
+        if (auto *PN = dyn_cast<PHINode>(User))
+          UseBB = PN->getIncomingBlock(U);
+        if (!InLoop.count(UseBB))
+          Uses.push_back(&U);
+      }
+      if (!Uses.empty())
+        OutsideUses.push_back(std::make_pair(&I, Uses));
+    }
+  }
+
+  // Copy 0 is the original loop body.
+  std::vector<std::unique_ptr<ValueToValueMapTy>> Maps;
+  for (unsigned i = 1; i < Depth; ++i) {
+    Maps.emplace_back(new ValueToValueMapTy);
+    ValueToValueMapTy &VMap = *Maps.back();
+    SmallVector<llvm::BasicBlock *, 16> NewBlocks;
+    for (auto *BB : Blocks) {
+      llvm::BasicBlock *NewBB =
+          CloneBasicBlock(BB, VMap, ".unroll" + Twine(i), &F);
+      VMap[BB] = NewBB;
+      NewBlocks.push_back(NewBB);
+    }
+    remapInstructionsInBlocks(NewBlocks, VMap);
+
+    for (auto *BB : Blocks)
+      addExitEdges(BB, cast<llvm::BasicBlock>(mapValue(&VMap, BB)), VMap,
+                   InLoop);
+  }
+
+  auto getMap = [&](unsigned i) -> ValueToValueMapTy * {
+    return i == 0 ? nullptr : Maps[i - 1].get();
+  };
+
+  // The exit test of the iteration after the last copy. Its phi nodes take
+  // their values from the latches of the last copy, and its edges back into
+  // the loop go to the cut block.
+  llvm::BasicBlock *Cut = createCutBlock(F, Header);
+  ValueToValueMapTy ExitMap;
+  llvm::BasicBlock *ExitHeader =
+      CloneBasicBlock(Header, ExitMap, ".unroll.exit", &F);
+  ExitMap[Header] = ExitHeader;
+  SmallVector<llvm::BasicBlock *, 1> ExitBlocks(1, ExitHeader);
+  remapInstructionsInBlocks(ExitBlocks, ExitMap);
+  for (auto &I : *Header) {
+    auto *PN = dyn_cast<PHINode>(&I);
+    if (!PN)
+      break;
+    auto *NewPN = cast<PHINode>(mapValue(&ExitMap, PN));
+    while (NewPN->getNumIncomingValues() > 0)
+      NewPN->removeIncomingValue(NewPN->getNumIncomingValues() - 1,
+                                 /*DeletePHIIfEmpty=*/false);
+    for (unsigned j = 0, e = PN->getNumIncomingValues(); j != e; ++j) {
+      llvm::BasicBlock *Pred = PN->getIncomingBlock(j);
+      if (!InLoop.count(Pred))
+        continue;
+      auto *LastMap = getMap(Depth - 1);
+      NewPN->addIncoming(mapValue(LastMap, PN->getIncomingValue(j)),
+                         cast<llvm::BasicBlock>(mapValue(LastMap, Pred)));
+    }
+  }
+  auto *HeaderTerm = Header->getTerminator();
+  auto *ExitTerm = ExitHeader->getTerminator();
+  for (unsigned s = 0, e = HeaderTerm->getNumSuccessors(); s != e; ++s)
+    if (InLoop.count(HeaderTerm->getSuccessor(s)))
+      ExitTerm->setSuccessor(s, Cut);
+  addExitEdges(Header, ExitHeader, ExitMap, InLoop);
+
+  // Give the header phi nodes of each copy their values from the latches of
+  // the previous copy, working backwards so that the original incoming values
+  // are still available.
+  for (unsigned i = Depth - 1; i > 0; --i) {
+    for (auto &I : *Header) {
+      auto *PN = dyn_cast<PHINode>(&I);
+      if (!PN)
+        break;
+      auto *NewPN = cast<PHINode>(mapValue(getMap(i), PN));
+      while (NewPN->getNumIncomingValues() > 0)
+        NewPN->removeIncomingValue(NewPN->getNumIncomingValues() - 1,
+                                   /*DeletePHIIfEmpty=*/false);
+      for (unsigned j = 0, e = PN->getNumIncomingValues(); j != e; ++j) {
+        llvm::BasicBlock *Pred = PN->getIncomingBlock(j);
+        if (!InLoop.count(Pred))
+          continue;
+        auto *PrevMap = getMap(i - 1);
+        NewPN->addIncoming(
+            mapValue(PrevMap, PN->getIncomingValue(j)),
+            cast<llvm::BasicBlock>(mapValue(PrevMap, Pred)));
+      }
+    }
+  }
+  for (auto &I : *Header) {
+    auto *PN = dyn_cast<PHINode>(&I);
+    if (!PN)
+      break;
+    for (auto *Latch : Latches)
+      while (PN->getBasicBlockIndex(Latch) >= 0)
+        PN->removeIncomingValue(Latch, /*DeletePHIIfEmpty=*/false);
+  }
+
+  // Redirect the back edges.
+  for (unsigned i = 0; i != Depth; ++i) {
+    auto *CopyHeader = cast<llvm::BasicBlock>(mapValue(getMap(i), Header));
+    llvm::BasicBlock *Next =
+        i + 1 == Depth
+            ? ExitHeader
+            : cast<llvm::BasicBlock>(mapValue(getMap(i + 1), Header));
+    for (auto *Latch : Latches) {
+      auto *CopyLatch = cast<llvm::BasicBlock>(mapValue(getMap(i), Latch));
+      auto *Term = CopyLatch->getTerminator();
+      for (unsigned s = 0, e = Term->getNumSuccessors(); s != e; ++s)
+        if (Term->getSuccessor(s) == CopyHeader)
+          Term->setSuccessor(s, Next);
+    }
+  }
+
+  for (auto &OU : OutsideUses) {
+    Instruction *I = OU.first;
+    SSAUpdater SSA;
+    SSA.Initialize(I->getType(), I->getName());
+    SSA.AddAvailableValue(I->getParent(), I);
+    for (auto &Map : Maps)
+      SSA.AddAvailableValue(
+          cast<llvm::BasicBlock>(mapValue(Map.get(), I->getParent())),
+          mapValue(Map.get(), I));
+    if (I->getParent() == Header)
+      SSA.AddAvailableValue(ExitHeader, mapValue(&ExitMap, I));
+    for (auto *U : OU.second)
+      SSA.RewriteUse(*U);
+  }
+}
+
+bool BoundedUnrollPass::runOnFunction(llvm::Function &F) {
+  if (!FC.isNormalFunction(&F) || F.isDeclaration())
+    return false;
+
+  bool Changed = removeInvariants(F);
+
+  // Each round unrolls the outermost loops, whose copies of any nested loops
+  // become the outermost loops of the next round.
+  while (true) {
+    DominatorTree DT(F);
+    LoopInfo LI(DT);
+    if (LI.empty())
+      break;
+
+    std::vector<Loop *> Loops(LI.begin(), LI.end());
+    for (auto *L : Loops)
+      unrollLoop(F, L);
+    Changed = true;
+  }
+
+  return Changed;
+}
+
+char BoundedUnrollPass::ID = 0;
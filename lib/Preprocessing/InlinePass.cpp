@@ -1,83 +1,181 @@
 #include "bugle/Preprocessing/InlinePass.h"
 #include "bugle/Translator/TranslateFunction.h"
-#include "bugle/Translator/TranslateModule.h"
 #include "bugle/util/ErrorReporter.h"
 #include "llvm/Pass.h"
+#include "llvm/ADT/SCCIterator.h"
 #include "llvm/Analysis/CallGraph.h"
-#include "llvm/IR/CallSite.h"
+#include "llvm/IR/Instructions.h"
 #include "llvm/IR/Module.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/raw_ostream.h"
 #include "llvm/Transforms/Utils/Cloning.h"
+#include <algorithm>
 
 using namespace llvm;
 using namespace bugle;
 
-bool InlinePass::doInline(llvm::Instruction *I, llvm::Function *OF) {
-  auto CI = dyn_cast<CallInst>(I);
+static cl::opt<unsigned> InlineBudget(
+    "inline-budget", cl::init(0), cl::value_desc("int"),
+    cl::desc("Do not inline a call if the caller would grow beyond this many "
+             "instructions (default 0, for no limit)"));
 
-  if (!CI)
-    return false;
+static cl::opt<bool> InlineReport(
+    "inline-report", cl::ValueDisallowed,
+    cl::desc("Report which calls were and were not inlined"));
 
-  auto F = CI->getCalledFunction();
-
-  if (!F)
-    ErrorReporter::reportImplementationLimitation(
-        "Function pointers not compatible with inlining");
+static unsigned getSize(llvm::Function *F) {
+  unsigned Size = 0;
+  for (auto &BB : *F)
+    Size += BB.size();
+  return Size;
+}
 
-  if (!(TranslateModule::isGPUEntryPoint(OF, M, SL, GPUEntryPoints) ||
-        TranslateFunction::isStandardEntryPoint(SL, OF->getName()))) {
-    if (TranslateFunction::isPreOrPostCondition(F->getName())) {
-      ErrorReporter::reportFatalError(
-          "Cannot inline, detected function with pre- or post-condition");
-    } else { // Do not perform inlining on non-entry point functions.
-      return false;
+void InlinePass::checkCalls(llvm::Function *F) {
+  for (auto &BB : *F) {
+    for (auto &I : BB) {
+      auto CI = dyn_cast<CallInst>(&I);
+      if (!CI)
+        continue;
+
+      auto Callee = CI->getCalledFunction();
+      if (!Callee)
+        ErrorReporter::reportImplementationLimitation(
+            "Function pointers not compatible with inlining");
+
+      if (!FC.isEntryPoint(F) &&
+          TranslateFunction::isPreOrPostCondition(Callee->getName()))
+        ErrorReporter::reportFatalError(
+            "Cannot inline, detected function with pre- or post-condition");
     }
   }
+}
 
+// Returns null if the call from F to Callee is to a special function and should
+// be ignored, the empty string if it can be inlined, or otherwise the reason
+// why it cannot be inlined.
+const char *InlinePass::getReasonNotInlined(llvm::Function *F,
+                                            llvm::Function *Callee) {
   // Do not inline functions that are special.
-  if (!TranslateFunction::isNormalFunction(SL, F))
-    return false;
+  if (!FC.isNormalFunction(Callee))
+    return nullptr;
 
   // Do not inline entry points in entry points, they may have pre- and
   // post-conditions.
-  if (TranslateModule::isGPUEntryPoint(F, M, SL, GPUEntryPoints) ||
-      TranslateFunction::isStandardEntryPoint(SL, F->getName()))
-    return false;
+  if (FC.isEntryPoint(Callee))
+    return "callee is an entry point";
 
-  CallSite CS(CI);
-  CallGraph &CG = getAnalysis<CallGraphWrapperPass>().getCallGraph();
-  InlineFunctionInfo IFI(&CG);
-  if (InlineFunction(CI, IFI))
-    return true;
-  else
-    return false;
-}
+  if (Callee->isDeclaration())
+    return "callee has no body";
 
-void InlinePass::doInline(llvm::BasicBlock *BB, llvm::Function *OF) {
-  // Re-process block as long as we did some inlining.
-  bool AppliedInlining = true;
-  while (AppliedInlining) {
-    for (auto &I : *BB) {
-      AppliedInlining = doInline(&I, OF);
-      if (AppliedInlining)
-        break;
-    }
-  }
+  if (Callee == F)
+    return "recursive call";
+
+  if (InlineBudget != 0 &&
+      FunctionSizes[F] + FunctionSizes[Callee] > InlineBudget)
+    return "exceeds inline budget";
+
+  return "";
 }
 
 void InlinePass::doInline(llvm::Function *F) {
-  // Only apply inlining to normal functions.
-  if (!TranslateFunction::isNormalFunction(SL, F))
-    return;
+  CallGraph &CG = getAnalysis<CallGraphWrapperPass>().getCallGraph();
 
+  std::vector<CallInst *> Worklist;
   for (auto &BB : *F)
-    doInline(&BB, F);
+    for (auto &I : BB)
+      if (auto CI = dyn_cast<CallInst>(&I))
+        Worklist.push_back(CI);
+  std::reverse(Worklist.begin(), Worklist.end());
+
+  while (!Worklist.empty()) {
+    auto CI = Worklist.back();
+    Worklist.pop_back();
+
+    auto Callee = CI->getCalledFunction();
+    const char *Reason = getReasonNotInlined(F, Callee);
+    if (!Reason)
+      continue;
+    if (*Reason) {
+      ++NotInlinedCounts[F->getName().str() + " -> " + Callee->getName().str() +
+                         " (" + Reason + ")"];
+      continue;
+    }
+
+    unsigned CalleeSize = FunctionSizes[Callee];
+    InlineFunctionInfo IFI(&CG);
+    if (!InlineFunction(CI, IFI))
+      continue;
+
+    ++InlinedCount;
+    FunctionSizes[F] += CalleeSize - 1;
+
+    // The callee was processed first, so the only calls left in its body are
+    // those it could not inline itself.
+    for (auto i = IFI.InlinedCalls.rbegin(), e = IFI.InlinedCalls.rend();
+         i != e; ++i) {
+      Value *V = *i;
+      if (auto NewCI = dyn_cast_or_null<CallInst>(V))
+        Worklist.push_back(NewCI);
+    }
+  }
+}
+
+void InlinePass::writeReport(llvm::raw_ostream &OS) {
+  OS << "Inlined " << InlinedCount << " calls\n";
+  for (auto &NI : NotInlinedCounts) {
+    OS << "Not inlined: " << NI.first;
+    if (NI.second > 1)
+      OS << " x" << NI.second;
+    OS << "\n";
+  }
 }
 
 bool InlinePass::runOnModule(llvm::Module &M) {
   this->M = &M;
 
-  for (auto &F : M)
-    doInline(&F);
+  std::vector<llvm::Function *> Stack;
+  for (auto &F : M) {
+    // Only apply inlining to normal functions.
+    if (FC.isNormalFunction(&F))
+      checkCalls(&F);
+    if (FC.isEntryPoint(&F))
+      Stack.push_back(&F);
+  }
+
+  // Only functions reachable from an entry point need to be processed, as all
+  // other functions are internalized and removed after inlining.
+  CallGraph &CG = getAnalysis<CallGraphWrapperPass>().getCallGraph();
+  std::set<llvm::Function *> Reachable;
+  while (!Stack.empty()) {
+    auto F = Stack.back();
+    Stack.pop_back();
+    if (!Reachable.insert(F).second)
+      continue;
+    for (auto &CR : *CG[F]) {
+      auto Callee = CR.second->getFunction();
+      if (Callee && FC.getKind(Callee) == FunctionClassifier::FK_Normal)
+        Stack.push_back(Callee);
+    }
+  }
+
+  // Fix the bottom-up order before inlining updates the call graph.
+  std::vector<llvm::Function *> Order;
+  for (auto i = scc_begin(&CG), e = scc_end(&CG); i != e; ++i) {
+    for (auto *Node : *i) {
+      auto F = Node->getFunction();
+      if (F && Reachable.count(F) && !F->isDeclaration())
+        Order.push_back(F);
+    }
+  }
+
+  for (auto F : Order)
+    FunctionSizes[F] = getSize(F);
+
+  for (auto F : Order)
+    doInline(F);
+
+  if (InlineReport)
+    writeReport(errs());
 
   return true;
 }
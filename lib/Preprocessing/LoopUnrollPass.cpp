@@ -0,0 +1,87 @@
+#include "bugle/Preprocessing/LoopUnrollPass.h"
+#include "bugle/Translator/TranslateFunction.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Analysis/OptimizationRemarkEmitter.h"
+#include "llvm/IR/CallSite.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/IntrinsicInst.h"
+#include "llvm/Transforms/Utils/UnrollLoop.h"
+
+using namespace llvm;
+using namespace bugle;
+
+bool LoopUnrollPass::isUnrollable(Loop *L) {
+  for (auto *BB : L->blocks()) {
+    for (auto &I : *BB) {
+      CallSite CS(&I);
+      if (!CS || isa<IntrinsicInst>(I))
+        continue;
+
+      auto *Callee = CS.getCalledFunction();
+      if (!Callee)
+        return false;
+
+      switch (FC.getKind(Callee)) {
+      case FunctionClassifier::FK_Barrier:
+      case FunctionClassifier::FK_GridBarrier:
+        return false;
+      case FunctionClassifier::FK_Special:
+        if (FC.isLoopInvariantFunction(Callee))
+          return false;
+        break;
+      case FunctionClassifier::FK_Kernel:
+      case FunctionClassifier::FK_StandardEntryPoint:
+      case FunctionClassifier::FK_Normal:
+        // Without inlining the callee may contain a barrier.
+        if (!Callee->isDeclaration())
+          return false;
+        break;
+      default:
+        break;
+      }
+    }
+  }
+
+  return true;
+}
+
+bool LoopUnrollPass::runOnFunction(llvm::Function &F) {
+  if (!FC.isNormalFunction(&F) || F.isDeclaration())
+    return false;
+
+  auto &LI = getAnalysis<LoopInfoWrapperPass>().getLoopInfo();
+  auto &SE = getAnalysis<ScalarEvolutionWrapperPass>().getSE();
+  auto &DT = getAnalysis<DominatorTreeWrapperPass>().getDomTree();
+  auto &AC = getAnalysis<AssumptionCacheTracker>().getAssumptionCache(F);
+  OptimizationRemarkEmitter ORE(&F);
+
+  // Visit the loops innermost first. Only loops without subloops are unrolled,
+  // so that the loops of an enclosing nest are not duplicated; an enclosing
+  // loop becomes a candidate once all loops nested in it have been unrolled.
+  SmallVector<Loop *, 8> Loops(LI.getLoopsInPreorder());
+  bool Changed = false;
+  for (auto i = Loops.rbegin(), e = Loops.rend(); i != e; ++i) {
+    Loop *L = *i;
+    if (!L->empty() || !isUnrollable(L))
+      continue;
+
+    unsigned TripCount = SE.getSmallConstantTripCount(L);
+    if (TripCount == 0 || TripCount > Threshold)
+      continue;
+
+    unsigned TripMultiple = SE.getSmallConstantTripMultiple(L);
+    LoopUnrollResult Result = UnrollLoop(
+        L, TripCount, TripCount, /*Force=*/false, /*AllowRuntime=*/false,
+        /*AllowExpensiveTripCount=*/false, /*PreserveCondBr=*/false,
+        /*PreserveOnlyFirst=*/false, TripMultiple, /*PeelCount=*/0,
+        /*UnrollRemainder=*/false, &LI, &SE, &DT, &AC, &ORE,
+        /*PreserveLCSSA=*/true);
+    if (Result != LoopUnrollResult::Unmodified)
+      Changed = true;
+  }
+
+  return Changed;
+}
+
+char LoopUnrollPass::ID = 0;
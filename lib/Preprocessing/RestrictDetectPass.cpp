@@ -92,9 +92,7 @@ void RestrictDetectPass::doRestrictCheck(llvm::Function &F) {
 bool RestrictDetectPass::runOnFunction(llvm::Function &F) {
   if (SL != TranslateModule::SL_OpenCL && SL != TranslateModule::SL_CUDA)
     return false;
-  if (!TranslateFunction::isNormalFunction(SL, &F))
-    return false;
-  if (!TranslateModule::isGPUEntryPoint(&F, M, SL, GPUEntryPoints))
+  if (!FC.isGPUEntryPoint(&F))
     return false;
 
   doRestrictCheck(F);
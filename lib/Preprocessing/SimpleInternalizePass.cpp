@@ -1,6 +1,5 @@
 #include "bugle/Preprocessing/SimpleInternalizePass.h"
 #include "bugle/Translator/TranslateFunction.h"
-#include "bugle/Translator/TranslateModule.h"
 #include "llvm/Pass.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/Module.h"
@@ -10,14 +9,13 @@ using namespace bugle;
 
 bool SimpleInternalizePass::isEntryPoint(llvm::Function *F) {
   if (OnlyExplicitEntryPoints)
-    return GPUEntryPoints.find(F->getName()) != GPUEntryPoints.end();
+    return FC.isExplicitEntryPoint(F);
   else
-    return TranslateModule::isGPUEntryPoint(F, M, SL, GPUEntryPoints) ||
-           TranslateFunction::isStandardEntryPoint(SL, F->getName());
+    return FC.isEntryPoint(F);
 }
 
 bool SimpleInternalizePass::doInternalize(llvm::Function *F) {
-  if (!TranslateFunction::isNormalFunction(SL, F) || isEntryPoint(F) ||
+  if (!FC.isNormalFunction(F) || isEntryPoint(F) ||
       F->isDeclaration())
     return false;
 
@@ -28,7 +26,6 @@ bool SimpleInternalizePass::doInternalize(llvm::Function *F) {
 
 bool SimpleInternalizePass::runOnModule(llvm::Module &M) {
   bool changed = false;
-  this->M = &M;
 
   for (auto &F : M)
     changed |= doInternalize(&F);
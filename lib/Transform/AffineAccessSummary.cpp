@@ -0,0 +1,260 @@
+#include "bugle/Transform/AffineAccessSummary.h"
+#include "bugle/BasicBlock.h"
+#include "bugle/Function.h"
+#include "bugle/GlobalArray.h"
+#include "bugle/Module.h"
+#include "bugle/Stmt.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace bugle;
+
+namespace {
+
+// A monomial is a sorted product of symbols, and the empty monomial is the
+// constant term. Coefficients wrap around like the offsets they describe.
+typedef std::vector<std::string> Monomial;
+typedef std::map<Monomial, int64_t> Polynomial;
+
+const unsigned MaxTerms = 16;
+
+class AffineAccessSummary {
+  Function *F;
+  // The arguments of a kernel, which have the same value in every thread.
+  // The arguments of other procedures may be given different values by
+  // different threads.
+  std::set<Var *> Args;
+  // Symbols which may differ between the threads of a group, or between loop
+  // iterations: the thread and group ids, and the local variables, which
+  // hold the values of phi nodes.
+  std::set<std::string> Varying;
+  std::map<Expr *, std::pair<bool, Polynomial>> Cache;
+
+  bool getSymbol(Expr *E, std::string &Name);
+  bool computePolynomial(Expr *E, Polynomial &P);
+  bool getPolynomial(Expr *E, Polynomial &P);
+  bool isAffine(const Polynomial &P);
+  void addAccess(ref<Expr> Array, ref<Expr> Offset, const char *Kind);
+
+public:
+  AffineAccessSummary(Function *F) : F(F) {
+    if (F->isEntryPoint())
+      Args.insert(F->arg_begin(), F->arg_end());
+  }
+  void summarize();
+};
+
+void addTo(Polynomial &P, const Polynomial &Q, int64_t Factor) {
+  for (const auto &T : Q) {
+    int64_t &C = P[T.first];
+    C = (int64_t)((uint64_t)C + (uint64_t)T.second * (uint64_t)Factor);
+    if (C == 0)
+      P.erase(T.first);
+  }
+}
+
+Polynomial multiply(const Polynomial &P, const Polynomial &Q) {
+  Polynomial R;
+  for (const auto &S : P) {
+    for (const auto &T : Q) {
+      Monomial M(S.first);
+      M.insert(M.end(), T.first.begin(), T.first.end());
+      std::sort(M.begin(), M.end());
+      Polynomial Term;
+      Term[M] = (int64_t)((uint64_t)S.second * (uint64_t)T.second);
+      addTo(R, Term, 1);
+    }
+  }
+  return R;
+}
+
+bool getConstant(const Polynomial &P, int64_t &C) {
+  if (P.empty()) {
+    C = 0;
+    return true;
+  }
+  if (P.size() != 1 || !P.begin()->first.empty())
+    return false;
+  C = P.begin()->second;
+  return true;
+}
+}
+
+bool AffineAccessSummary::getSymbol(Expr *E, std::string &Name) {
+  if (auto *SVRE = dyn_cast<SpecialVarRefExpr>(E)) {
+    Name = SVRE->getAttr();
+    if (Name.compare(0, 8, "local_id") == 0 ||
+        Name.compare(0, 8, "group_id") == 0)
+      Varying.insert(Name);
+    return true;
+  }
+
+  Var *V = nullptr;
+  if (auto *VRE = dyn_cast<VarRefExpr>(E)) {
+    V = VRE->getVar();
+    Name = "$" + V->getName();
+  } else if (auto *AOE = dyn_cast<ArrayOffsetExpr>(E)) {
+    if (auto *VRE = dyn_cast<VarRefExpr>(AOE->getSubExpr())) {
+      V = VRE->getVar();
+      Name = "offset#MKPTR($" + V->getName() + ")";
+    }
+  }
+  if (!V)
+    return false;
+  if (!Args.count(V))
+    Varying.insert(Name);
+  return true;
+}
+
+bool AffineAccessSummary::computePolynomial(Expr *E, Polynomial &P) {
+  std::string Name;
+  if (auto *CE = dyn_cast<BVConstExpr>(E)) {
+    if (CE->getValue().getBitWidth() > 64)
+      return false;
+    if (int64_t C = CE->getValue().getSExtValue())
+      P[Monomial()] = C;
+    return true;
+  } else if (getSymbol(E, Name)) {
+    P[Monomial(1, Name)] = 1;
+    return true;
+  } else if (isa<BVSExtExpr>(E) || isa<BVZExtExpr>(E)) {
+    // Extending the result of arithmetic which may wrap around is not the
+    // same as extending its operands, so only extended symbols are accepted,
+    // with the extension recorded in the symbol. Extended constants are
+    // folded when they are created. The exception is arithmetic narrowed by
+    // the translator, which cannot wrap around and is non-negative.
+    auto *UE = cast<UnaryExpr>(E);
+    auto *ZEE = dyn_cast<BVZExtExpr>(E);
+    if (ZEE && ZEE->isNonNegative())
+      return getPolynomial(ZEE->getSubExpr().get(), P);
+    if (!getSymbol(UE->getSubExpr().get(), Name))
+      return false;
+    std::string ExtName;
+    llvm::raw_string_ostream SS(ExtName);
+    SS << "BV" << UE->getSubExpr()->getType().width
+       << (isa<BVZExtExpr>(E) ? "_ZEXT" : "_SEXT") << E->getType().width
+       << "(" << Name << ")";
+    if (Varying.count(Name))
+      Varying.insert(SS.str());
+    P[Monomial(1, SS.str())] = 1;
+    return true;
+  } else if (isa<BVAddExpr>(E) || isa<BVSubExpr>(E) || isa<BVMulExpr>(E) ||
+             isa<BVShlExpr>(E) || isa<BVSDivExpr>(E)) {
+    auto *BE = cast<BinaryExpr>(E);
+    Polynomial L, R;
+    if (!getPolynomial(BE->getLHS().get(), L) ||
+        !getPolynomial(BE->getRHS().get(), R))
+      return false;
+
+    int64_t C;
+    if (isa<BVAddExpr>(E) || isa<BVSubExpr>(E)) {
+      P = L;
+      addTo(P, R, isa<BVAddExpr>(E) ? 1 : -1);
+    } else if (isa<BVMulExpr>(E)) {
+      P = multiply(L, R);
+    } else if (isa<BVShlExpr>(E)) {
+      if (!getConstant(R, C) || C < 0 || C > 62)
+        return false;
+      addTo(P, L, (int64_t)1 << C);
+    } else {
+      // Division does not distribute over arithmetic which wraps around, so
+      // only dividends which cannot wrap, as marked by narrowing, are
+      // divided.
+      auto *ZEE = dyn_cast<BVZExtExpr>(BE->getLHS());
+      if (!ZEE || !ZEE->isNonNegative() || !getConstant(R, C) || C <= 0)
+        return false;
+      for (const auto &T : L) {
+        if (T.second % C != 0)
+          return false;
+        P[T.first] = T.second / C;
+      }
+    }
+    return P.size() <= MaxTerms;
+  }
+
+  return false;
+}
+
+bool AffineAccessSummary::getPolynomial(Expr *E, Polynomial &P) {
+  auto i = Cache.find(E);
+  if (i == Cache.end()) {
+    Polynomial Q;
+    bool Valid = computePolynomial(E, Q);
+    i = Cache.insert(std::make_pair(E, std::make_pair(Valid, Q))).first;
+  }
+  P = i->second.second;
+  return i->second.first;
+}
+
+// The coefficient of each varying symbol must be uniform.
+bool AffineAccessSummary::isAffine(const Polynomial &P) {
+  for (const auto &T : P) {
+    unsigned NumVarying = 0;
+    for (const auto &S : T.first)
+      NumVarying += Varying.count(S);
+    if (NumVarying > 1)
+      return false;
+  }
+  return true;
+}
+
+void AffineAccessSummary::addAccess(ref<Expr> Array, ref<Expr> Offset,
+                                    const char *Kind) {
+  std::set<GlobalArray *> Globals;
+  if (!Array->computeArrayCandidates(Globals) || Globals.size() != 1)
+    return;
+  GlobalArray *GA = *Globals.begin();
+  if (!GA || !GA->isGlobalOrGroupShared())
+    return;
+
+  Polynomial P;
+  if (!getPolynomial(Offset.get(), P) || !isAffine(P))
+    return;
+
+  // affine_access "array", "kind", constant, "monomial", coefficient, ...
+  std::string S;
+  llvm::raw_string_ostream SS(S);
+  auto Constant = P.find(Monomial());
+  SS << "affine_access \"$$" << GA->getName() << "\", \"" << Kind << "\", "
+     << (Constant == P.end() ? 0 : Constant->second);
+  for (const auto &T : P) {
+    if (T.first.empty())
+      continue;
+    SS << ", \"";
+    for (auto b = T.first.begin(), i = b, e = T.first.end(); i != e; ++i)
+      SS << (i == b ? "" : "*") << *i;
+    SS << "\", " << T.second;
+  }
+  F->addAttribute(SS.str());
+}
+
+void AffineAccessSummary::summarize() {
+  for (auto *BB : *F) {
+    for (auto *S : *BB) {
+      if (auto *ES = dyn_cast<EvalStmt>(S)) {
+        Expr *E = ES->getExpr().get();
+        if (auto *LE = dyn_cast<LoadExpr>(E)) {
+          addAccess(LE->getArray(), LE->getOffset(), "READ");
+        } else if (auto *AE = dyn_cast<AtomicExpr>(E)) {
+          addAccess(AE->getArray(), AE->getOffset(), "ATOMIC");
+        } else if (auto *AWGCE = dyn_cast<AsyncWorkGroupCopyExpr>(E)) {
+          addAccess(AWGCE->getSrc(), AWGCE->getSrcOffset(), "READ");
+          addAccess(AWGCE->getDst(), AWGCE->getDstOffset(), "WRITE");
+        }
+      } else if (auto *SS = dyn_cast<StoreStmt>(S)) {
+        addAccess(SS->getArray(), SS->getOffset(), "WRITE");
+      }
+    }
+  }
+}
+
+void bugle::summarizeAffineAccesses(Module *M) {
+  for (auto i = M->function_begin(), e = M->function_end(); i != e; ++i) {
+    AffineAccessSummary AAS(*i);
+    AAS.summarize();
+  }
+}
@@ -0,0 +1,379 @@
+#include "bugle/Transform/ConstantPropagation.h"
+#include "bugle/BasicBlock.h"
+#include "bugle/Function.h"
+#include "bugle/Module.h"
+#include "bugle/util/Profiler.h"
+#include <map>
+#include <set>
+
+using namespace bugle;
+
+namespace {
+
+// The value of a variable or expression in every execution which reaches it:
+// not yet known to be reached, a single constant, or not constant.
+struct LatticeValue {
+  enum State { Unknown, Constant, Overdefined };
+
+  State S;
+  ref<Expr> C;
+
+  LatticeValue(State S = Unknown) : S(S) {}
+  LatticeValue(ref<Expr> C) : S(Constant), C(C) {}
+
+  bool isConstant() const { return S == Constant; }
+
+  bool operator==(const LatticeValue &Other) const {
+    if (S != Other.S)
+      return false;
+    if (S != Constant)
+      return true;
+    if (auto *BV1 = dyn_cast<BVConstExpr>(C))
+      if (auto *BV2 = dyn_cast<BVConstExpr>(Other.C))
+        return BV1->getValue().getBitWidth() ==
+                   BV2->getValue().getBitWidth() &&
+               BV1->getValue() == BV2->getValue();
+    if (auto *B1 = dyn_cast<BoolConstExpr>(C))
+      if (auto *B2 = dyn_cast<BoolConstExpr>(Other.C))
+        return B1->getValue() == B2->getValue();
+    return false;
+  }
+  bool operator!=(const LatticeValue &Other) const { return !(*this == Other); }
+
+  LatticeValue meet(const LatticeValue &Other) const {
+    if (S == Unknown)
+      return Other;
+    if (Other.S == Unknown || *this == Other)
+      return *this;
+    return Overdefined;
+  }
+};
+
+bool isConstantExpr(Expr *E) {
+  return isa<BVConstExpr>(E) || isa<BoolConstExpr>(E);
+}
+
+// Rebuild E from the given constant operands, which the create functions
+// fold to a constant for each kind of expression handled here.
+ref<Expr> foldExpr(Expr *E, const std::vector<ref<Expr>> &Ops) {
+  switch (E->getKind()) {
+  case Expr::Not:
+    return NotExpr::create(Ops[0]);
+  case Expr::BVToBool:
+    return BVToBoolExpr::create(Ops[0]);
+  case Expr::BoolToBV:
+    return BoolToBVExpr::create(Ops[0]);
+  case Expr::BVZExt:
+    return BVZExtExpr::create(E->getType().width, Ops[0],
+                              cast<BVZExtExpr>(E)->isNonNegative());
+  case Expr::BVSExt:
+    return BVSExtExpr::create(E->getType().width, Ops[0]);
+  case Expr::BVExtract:
+    return BVExtractExpr::create(Ops[0], cast<BVExtractExpr>(E)->getOffset(),
+                                 E->getType().width);
+  case Expr::Eq:
+    return EqExpr::create(Ops[0], Ops[1]);
+  case Expr::Ne:
+    return NeExpr::create(Ops[0], Ops[1]);
+  case Expr::And:
+    return AndExpr::create(Ops[0], Ops[1]);
+  case Expr::Or:
+    return OrExpr::create(Ops[0], Ops[1]);
+  case Expr::Implies:
+    return ImpliesExpr::create(Ops[0], Ops[1]);
+  case Expr::BVAdd:
+    return BVAddExpr::create(Ops[0], Ops[1]);
+  case Expr::BVSub:
+    return BVSubExpr::create(Ops[0], Ops[1]);
+  case Expr::BVMul:
+    return BVMulExpr::create(Ops[0], Ops[1]);
+  case Expr::BVSDiv:
+    return BVSDivExpr::create(Ops[0], Ops[1]);
+  case Expr::BVUDiv:
+    return BVUDivExpr::create(Ops[0], Ops[1]);
+  case Expr::BVSRem:
+    return BVSRemExpr::create(Ops[0], Ops[1]);
+  case Expr::BVURem:
+    return BVURemExpr::create(Ops[0], Ops[1]);
+  case Expr::BVShl:
+    return BVShlExpr::create(Ops[0], Ops[1]);
+  case Expr::BVAShr:
+    return BVAShrExpr::create(Ops[0], Ops[1]);
+  case Expr::BVLShr:
+    return BVLShrExpr::create(Ops[0], Ops[1]);
+  case Expr::BVAnd:
+    return BVAndExpr::create(Ops[0], Ops[1]);
+  case Expr::BVOr:
+    return BVOrExpr::create(Ops[0], Ops[1]);
+  case Expr::BVXor:
+    return BVXorExpr::create(Ops[0], Ops[1]);
+  case Expr::BVConcat:
+    return BVConcatExpr::create(Ops[0], Ops[1]);
+  case Expr::BVUgt:
+    return BVUgtExpr::create(Ops[0], Ops[1]);
+  case Expr::BVUge:
+    return BVUgeExpr::create(Ops[0], Ops[1]);
+  case Expr::BVUlt:
+    return BVUltExpr::create(Ops[0], Ops[1]);
+  case Expr::BVUle:
+    return BVUleExpr::create(Ops[0], Ops[1]);
+  case Expr::BVSgt:
+    return BVSgtExpr::create(Ops[0], Ops[1]);
+  case Expr::BVSge:
+    return BVSgeExpr::create(Ops[0], Ops[1]);
+  case Expr::BVSlt:
+    return BVSltExpr::create(Ops[0], Ops[1]);
+  case Expr::BVSle:
+    return BVSleExpr::create(Ops[0], Ops[1]);
+  default:
+    return ref<Expr>();
+  }
+}
+
+class ConstantPropagation {
+  Function *F;
+  std::map<Var *, LatticeValue> VarValues;
+  std::map<Expr *, LatticeValue> ExprValues;
+  std::map<Var *, std::vector<BasicBlock *>> VarUsers;
+  std::set<BasicBlock *> Executable, Infeasible;
+  std::vector<BasicBlock *> Worklist;
+  std::map<Expr *, ref<Expr>> Simplified;
+  unsigned Folded;
+
+  void computeVarUsers();
+  LatticeValue evaluate(Expr *E);
+  void markExecutable(BasicBlock *BB);
+  void processBlock(BasicBlock *BB);
+  ref<Expr> simplify(Expr *E);
+  unsigned pruneBranches();
+
+public:
+  ConstantPropagation(Function *F) : F(F), Folded(0) {}
+  void run();
+};
+
+// Record the blocks whose phi assignments and assumptions read each variable,
+// which must be processed again when the value of the variable changes.
+void ConstantPropagation::computeVarUsers() {
+  for (auto *BB : *F) {
+    std::set<Expr *> Visited;
+    std::vector<Expr *> Exprs;
+    for (auto *S : *BB) {
+      if (auto *VAS = dyn_cast<VarAssignStmt>(S)) {
+        for (const auto &V : VAS->getValues())
+          Exprs.push_back(V.get());
+      } else if (auto *AS = dyn_cast<AssumeStmt>(S)) {
+        Exprs.push_back(AS->getPredicate().get());
+      }
+    }
+    while (!Exprs.empty()) {
+      Expr *E = Exprs.back();
+      Exprs.pop_back();
+      if (!Visited.insert(E).second)
+        continue;
+      if (auto *VRE = dyn_cast<VarRefExpr>(E)) {
+        auto &Users = VarUsers[VRE->getVar()];
+        if (Users.empty() || Users.back() != BB)
+          Users.push_back(BB);
+      }
+      E->getOperands(Exprs);
+    }
+  }
+}
+
+LatticeValue ConstantPropagation::evaluate(Expr *E) {
+  auto i = ExprValues.find(E);
+  if (i != ExprValues.end())
+    return i->second;
+
+  LatticeValue V(LatticeValue::Overdefined);
+  if (isConstantExpr(E)) {
+    V = LatticeValue(E);
+  } else if (auto *VRE = dyn_cast<VarRefExpr>(E)) {
+    auto vi = VarValues.find(VRE->getVar());
+    if (vi != VarValues.end())
+      V = vi->second;
+  } else if (auto *ITE = dyn_cast<IfThenElseExpr>(E)) {
+    LatticeValue Cond = evaluate(ITE->getCond().get());
+    if (Cond.isConstant())
+      V = evaluate(cast<BoolConstExpr>(Cond.C)->getValue()
+                       ? ITE->getTrueExpr().get()
+                       : ITE->getFalseExpr().get());
+    else if (Cond.S == LatticeValue::Unknown)
+      V = Cond;
+    else
+      V = evaluate(ITE->getTrueExpr().get())
+              .meet(evaluate(ITE->getFalseExpr().get()));
+  } else if (E->getType().isKind(Type::Bool) ||
+             E->getType().isKind(Type::BV)) {
+    std::vector<Expr *> Ops;
+    E->getOperands(Ops);
+    std::vector<ref<Expr>> ConstOps;
+    bool HasUnknown = false, HasOverdefined = false;
+    for (auto *Op : Ops) {
+      LatticeValue OpV = evaluate(Op);
+      if (OpV.isConstant())
+        ConstOps.push_back(OpV.C);
+      else if (OpV.S == LatticeValue::Unknown)
+        HasUnknown = true;
+      else
+        HasOverdefined = true;
+    }
+
+    // A constant operand of a conjunction or disjunction may determine its
+    // value regardless of the other.
+    bool Absorbed = false;
+    if ((isa<AndExpr>(E) || isa<OrExpr>(E)) && ConstOps.size() == 1)
+      Absorbed = cast<BoolConstExpr>(ConstOps[0])->getValue() == isa<OrExpr>(E);
+
+    if (Absorbed) {
+      V = LatticeValue(ConstOps[0]);
+    } else if (HasOverdefined) {
+      V = LatticeValue::Overdefined;
+    } else if (HasUnknown) {
+      V = LatticeValue::Unknown;
+    } else if (ConstOps.size() == Ops.size()) {
+      ref<Expr> Folded = Ops.empty() ? ref<Expr>() : foldExpr(E, ConstOps);
+      if (!Folded.isNull() && isConstantExpr(Folded.get()))
+        V = LatticeValue(Folded);
+    }
+  }
+
+  return ExprValues[E] = V;
+}
+
+void ConstantPropagation::markExecutable(BasicBlock *BB) {
+  if (Executable.insert(BB).second)
+    Worklist.push_back(BB);
+}
+
+// A block whose leading partition assumption fails is infeasible, and the
+// branches into it may be pruned. Any other failing assumption only ends
+// propagation within its block, as the block itself may not be removed.
+void ConstantPropagation::processBlock(BasicBlock *BB) {
+  Infeasible.erase(BB);
+  for (auto *S : *BB) {
+    if (auto *VAS = dyn_cast<VarAssignStmt>(S)) {
+      for (unsigned i = 0; i != VAS->getVars().size(); ++i) {
+        Var *V = VAS->getVars()[i];
+        auto vi = VarValues.find(V);
+        if (vi == VarValues.end())
+          continue;
+        LatticeValue New = vi->second.meet(evaluate(VAS->getValues()[i].get()));
+        if (New == vi->second)
+          continue;
+        vi->second = New;
+        ExprValues.clear();
+        for (auto *User : VarUsers[V])
+          if (Executable.count(User))
+            Worklist.push_back(User);
+      }
+    } else if (auto *AS = dyn_cast<AssumeStmt>(S)) {
+      LatticeValue Pred = evaluate(AS->getPredicate().get());
+      if (Pred.isConstant() && !cast<BoolConstExpr>(Pred.C)->getValue()) {
+        if (AS->isPartition() && S == *BB->begin())
+          Infeasible.insert(BB);
+        return;
+      }
+    } else if (auto *GS = dyn_cast<GotoStmt>(S)) {
+      for (auto *Succ : GS->getBlocks())
+        markExecutable(Succ);
+    }
+  }
+}
+
+// Replace each expression which is constant, or whose value is chosen by a
+// constant condition, with that constant or choice. Expressions evaluated by
+// an EvalStmt are named where they are used, so only their subexpressions
+// are simplified, by their EvalStmt.
+ref<Expr> ConstantPropagation::simplify(Expr *E) {
+  auto i = Simplified.find(E);
+  if (i != Simplified.end())
+    return i->second;
+
+  ref<Expr> R = E;
+  LatticeValue V = evaluate(E);
+  if (V.isConstant() && !isConstantExpr(E)) {
+    R = V.C;
+  } else if (!E->hasEvalStmt) {
+    E->replaceOperands([&](Expr *Op) { return simplify(Op); });
+    if (auto *ITE = dyn_cast<IfThenElseExpr>(E)) {
+      if (auto *Cond = dyn_cast<BoolConstExpr>(ITE->getCond()))
+        R = Cond->getValue() ? ITE->getTrueExpr() : ITE->getFalseExpr();
+    } else if (isa<AndExpr>(E) || isa<OrExpr>(E)) {
+      auto *BE = cast<BinaryExpr>(E);
+      if (isConstantExpr(BE->getLHS().get()) ||
+          isConstantExpr(BE->getRHS().get()))
+        R = isa<AndExpr>(E) ? AndExpr::create(BE->getLHS(), BE->getRHS())
+                            : OrExpr::create(BE->getLHS(), BE->getRHS());
+    }
+  }
+
+  if (R.get() != E)
+    ++Folded;
+  return Simplified[E] = R;
+}
+
+// Remove the branches to blocks whose partition assumptions cannot hold. A
+// branch whose targets all fail is left alone, as the block is then itself
+// infeasible.
+unsigned ConstantPropagation::pruneBranches() {
+  unsigned Pruned = 0;
+  for (auto *BB : *F) {
+    if (!Executable.count(BB) || Infeasible.count(BB))
+      continue;
+    OwningPtrVector<Stmt> &V = BB->getStmtVector();
+    if (V.empty())
+      continue;
+    auto *GS = dyn_cast<GotoStmt>(V.back());
+    if (!GS)
+      continue;
+
+    std::vector<BasicBlock *> Succs;
+    for (auto *Succ : GS->getBlocks())
+      if (!Infeasible.count(Succ))
+        Succs.push_back(Succ);
+    if (Succs.empty() || Succs.size() == GS->getBlocks().size())
+      continue;
+
+    Pruned += GS->getBlocks().size() - Succs.size();
+    delete GS;
+    V.back() = GotoStmt::create(Succs);
+  }
+  return Pruned;
+}
+
+void ConstantPropagation::run() {
+  if (F->begin() == F->end())
+    return;
+
+  for (auto i = F->local_begin(), e = F->local_end(); i != e; ++i)
+    VarValues[*i] = LatticeValue();
+  computeVarUsers();
+
+  markExecutable(*F->begin());
+  while (!Worklist.empty()) {
+    BasicBlock *BB = Worklist.back();
+    Worklist.pop_back();
+    processBlock(BB);
+  }
+
+  auto Simplify = [&](Expr *E) { return simplify(E); };
+  for (auto *BB : *F) {
+    if (!Executable.count(BB))
+      continue;
+    for (auto *S : *BB)
+      S->replaceOperands(Simplify);
+  }
+
+  Profiler::addToCounter("sccp.folded-exprs", Folded);
+  Profiler::addToCounter("sccp.pruned-branches", pruneBranches());
+}
+}
+
+void bugle::propagateConstants(Module *M) {
+  for (auto i = M->function_begin(), e = M->function_end(); i != e; ++i) {
+    ConstantPropagation CP(*i);
+    CP.run();
+  }
+}
@@ -0,0 +1,290 @@
+#include "bugle/Transform/GlobalValueNumbering.h"
+#include "bugle/BasicBlock.h"
+#include "bugle/Function.h"
+#include "bugle/Module.h"
+#include "bugle/util/Profiler.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <map>
+#include <set>
+
+using namespace bugle;
+
+namespace {
+
+// Expressions whose value depends on the point at which they are evaluated,
+// or which are given a fresh value each time they are evaluated. These are
+// only ever equivalent to themselves.
+bool isImpure(Expr *E) {
+  switch (E->getKind()) {
+  case Expr::Load:
+  case Expr::Atomic:
+  case Expr::Call:
+  case Expr::CallMemberOf:
+  case Expr::BVCtlz:
+  case Expr::Havoc:
+  case Expr::AccessHasOccurred:
+  case Expr::AccessOffset:
+  case Expr::ArraySnapshot:
+  case Expr::UnderlyingArray:
+  case Expr::AddNoovfl:
+  case Expr::AddNoovflPredicate:
+  case Expr::UninterpretedFunction:
+  case Expr::AtomicHasTakenValue:
+  case Expr::AsyncWorkGroupCopy:
+  case Expr::OtherInt:
+  case Expr::OtherBool:
+  case Expr::OtherPtrBase:
+  case Expr::Old:
+    return true;
+  default:
+    return false;
+  }
+}
+
+class GlobalValueNumbering {
+  Function *F;
+  std::vector<BasicBlock *> Blocks;
+  std::map<BasicBlock *, unsigned> BlockIds, LinearIds;
+  std::map<BasicBlock *, std::vector<BasicBlock *>> DomChildren;
+
+  std::map<Expr *, unsigned> Numbers;
+  std::map<std::string, unsigned> Keys;
+  unsigned NextNumber;
+
+  // The EvalStmt'd expression holding each value number in the dominator
+  // tree scope being visited, and the block in which it is evaluated.
+  std::map<unsigned, std::pair<Expr *, BasicBlock *>> Available;
+  std::map<Expr *, ref<Expr>> Replacements;
+  std::set<Expr *> Rewritten;
+
+  void computeDominatorTree();
+  unsigned getNumber(Expr *E);
+  ref<Expr> replace(Expr *E);
+  void rewriteOperands(Stmt *S);
+  void processBlock(BasicBlock *BB);
+
+public:
+  GlobalValueNumbering(Function *F) : F(F), NextNumber(0) {}
+  unsigned run();
+};
+
+std::vector<BasicBlock *> getSuccessors(BasicBlock *BB) {
+  if (BB->begin() == BB->end())
+    return {};
+  if (auto *GS = dyn_cast<GotoStmt>(*(BB->end() - 1)))
+    return GS->getBlocks();
+  return {};
+}
+
+// Compute the dominator tree of the blocks reachable from the entry block
+// using the iterative algorithm of Cooper, Harvey and Kennedy.
+void GlobalValueNumbering::computeDominatorTree() {
+  BasicBlock *Entry = *F->begin();
+  std::set<BasicBlock *> Visited;
+  std::vector<std::pair<BasicBlock *, unsigned>> Stack;
+  std::map<BasicBlock *, std::vector<BasicBlock *>> Preds;
+  std::map<BasicBlock *, std::vector<BasicBlock *>> Succs;
+
+  Visited.insert(Entry);
+  Succs[Entry] = getSuccessors(Entry);
+  Stack.push_back(std::make_pair(Entry, 0));
+  while (!Stack.empty()) {
+    BasicBlock *BB = Stack.back().first;
+    unsigned &I = Stack.back().second;
+    if (I == Succs[BB].size()) {
+      Blocks.push_back(BB);
+      Stack.pop_back();
+      continue;
+    }
+    BasicBlock *Succ = Succs[BB][I++];
+    Preds[Succ].push_back(BB);
+    if (Visited.insert(Succ).second) {
+      Succs[Succ] = getSuccessors(Succ);
+      Stack.push_back(std::make_pair(Succ, 0));
+    }
+  }
+  std::reverse(Blocks.begin(), Blocks.end());
+  for (unsigned i = 0; i != Blocks.size(); ++i)
+    BlockIds[Blocks[i]] = i;
+
+  std::vector<unsigned> IDom(Blocks.size(), ~0u);
+  IDom[0] = 0;
+  auto Intersect = [&](unsigned A, unsigned B) {
+    while (A != B) {
+      while (A > B)
+        A = IDom[A];
+      while (B > A)
+        B = IDom[B];
+    }
+    return A;
+  };
+
+  bool Changed = true;
+  while (Changed) {
+    Changed = false;
+    for (unsigned i = 1; i != Blocks.size(); ++i) {
+      unsigned NewIDom = ~0u;
+      for (auto *Pred : Preds[Blocks[i]]) {
+        unsigned P = BlockIds[Pred];
+        if (IDom[P] == ~0u)
+          continue;
+        NewIDom = NewIDom == ~0u ? P : Intersect(P, NewIDom);
+      }
+      if (IDom[i] != NewIDom) {
+        IDom[i] = NewIDom;
+        Changed = true;
+      }
+    }
+  }
+
+  for (unsigned i = 1; i != Blocks.size(); ++i)
+    DomChildren[Blocks[IDom[i]]].push_back(Blocks[i]);
+}
+
+unsigned GlobalValueNumbering::getNumber(Expr *E) {
+  auto i = Numbers.find(E);
+  if (i != Numbers.end())
+    return i->second;
+
+  if (isImpure(E))
+    return Numbers[E] = NextNumber++;
+
+  std::string Key;
+  llvm::raw_string_ostream SS(Key);
+  Type T = E->getType();
+  SS << E->getKind() << ':' << T.kind << ':' << T.width << ':' << T.array;
+
+  if (auto *BVC = dyn_cast<BVConstExpr>(E)) {
+    SS << ':';
+    BVC->getValue().print(SS, false);
+  } else if (auto *BC = dyn_cast<BoolConstExpr>(E)) {
+    SS << ':' << BC->getValue();
+  } else if (auto *GARE = dyn_cast<GlobalArrayRefExpr>(E)) {
+    SS << ':' << GARE->getArray();
+  } else if (auto *VRE = dyn_cast<VarRefExpr>(E)) {
+    SS << ':' << VRE->getVar();
+  } else if (auto *SVRE = dyn_cast<SpecialVarRefExpr>(E)) {
+    SS << ':' << SVRE->getAttr();
+  } else if (auto *FPE = dyn_cast<FunctionPointerExpr>(E)) {
+    SS << ':' << FPE->getFuncName();
+  } else if (auto *EE = dyn_cast<BVExtractExpr>(E)) {
+    SS << ':' << EE->getOffset();
+  } else if (auto *AMOE = dyn_cast<ArrayMemberOfExpr>(E)) {
+    for (auto *GA : AMOE->getElems())
+      SS << ':' << GA;
+  }
+
+  std::vector<Expr *> Ops;
+  E->getOperands(Ops);
+  for (auto *Op : Ops)
+    SS << '#' << getNumber(Op);
+
+  auto k = Keys.insert(std::make_pair(SS.str(), NextNumber));
+  if (k.second)
+    ++NextNumber;
+  return Numbers[E] = k.first->second;
+}
+
+ref<Expr> GlobalValueNumbering::replace(Expr *E) {
+  auto i = Replacements.find(E);
+  if (i != Replacements.end())
+    return i->second;
+  return E;
+}
+
+// Replace the uses of replaced expressions by this statement, including those
+// by the inline subexpressions of the expressions it uses.
+void GlobalValueNumbering::rewriteOperands(Stmt *S) {
+  auto Replace = [&](Expr *E) { return replace(E); };
+  S->replaceOperands(Replace);
+
+  std::vector<Expr *> Worklist;
+  S->getOperands(Worklist);
+  while (!Worklist.empty()) {
+    Expr *E = Worklist.back();
+    Worklist.pop_back();
+    if (E->hasEvalStmt || !Rewritten.insert(E).second)
+      continue;
+    E->replaceOperands(Replace);
+    E->getOperands(Worklist);
+  }
+}
+
+void GlobalValueNumbering::processBlock(BasicBlock *BB) {
+  std::vector<unsigned> Added;
+  for (auto *S : *BB) {
+    rewriteOperands(S);
+
+    auto *ES = dyn_cast<EvalStmt>(S);
+    if (!ES)
+      continue;
+    Expr *E = ES->getExpr().get();
+    if (isImpure(E))
+      continue;
+
+    unsigned N = getNumber(E);
+    auto i = Available.find(N);
+    // The writer names the value of an EvalStmt only after it has written
+    // that statement, so only reuse expressions evaluated earlier in the
+    // order in which the blocks are written.
+    if (i != Available.end() &&
+        LinearIds[i->second.second] <= LinearIds[BB]) {
+      Replacements[E] = i->second.first;
+    } else if (i == Available.end()) {
+      Available[N] = std::make_pair(E, BB);
+      Added.push_back(N);
+    }
+  }
+
+  for (auto *Child : DomChildren[BB])
+    processBlock(Child);
+
+  for (auto N : Added)
+    Available.erase(N);
+}
+
+unsigned GlobalValueNumbering::run() {
+  if (F->begin() == F->end())
+    return 0;
+
+  unsigned LinearId = 0;
+  for (auto *BB : *F)
+    LinearIds[BB] = LinearId++;
+
+  computeDominatorTree();
+  processBlock(Blocks[0]);
+
+  // Blocks which are unreachable from the entry block may still use
+  // replaced expressions.
+  for (auto *BB : *F) {
+    if (BlockIds.find(BB) == BlockIds.end())
+      for (auto *S : *BB)
+        rewriteOperands(S);
+  }
+
+  unsigned Removed = 0;
+  for (auto *BB : *F) {
+    OwningPtrVector<Stmt> &V = BB->getStmtVector();
+    for (auto i = V.begin(); i != V.end();) {
+      auto *ES = dyn_cast<EvalStmt>(*i);
+      if (ES && Replacements.count(ES->getExpr().get()) &&
+          ES->getExpr()->refCount == 1) {
+        delete *i;
+        i = V.erase(i);
+        ++Removed;
+      } else {
+        ++i;
+      }
+    }
+  }
+  return Removed;
+}
+}
+
+void bugle::numberGlobalValues(Module *M) {
+  for (auto i = M->function_begin(), e = M->function_end(); i != e; ++i) {
+    GlobalValueNumbering GVN(*i);
+    Profiler::addToCounter("gvn.replaced-exprs", GVN.run());
+  }
+}
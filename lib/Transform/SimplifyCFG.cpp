@@ -0,0 +1,242 @@
+#include "bugle/Transform/SimplifyCFG.h"
+#include "bugle/BasicBlock.h"
+#include "bugle/Function.h"
+#include "bugle/Module.h"
+#include "bugle/util/Profiler.h"
+#include <algorithm>
+#include <map>
+#include <set>
+
+using namespace bugle;
+
+namespace {
+
+GotoStmt *getGoto(BasicBlock *BB) {
+  if (BB->begin() == BB->end())
+    return nullptr;
+  return dyn_cast<GotoStmt>(*(BB->end() - 1));
+}
+
+bool isBlockSourceLoc(Stmt *S) {
+  auto *AtS = dyn_cast<AssertStmt>(S);
+  return AtS && AtS->isBlockSourceLoc();
+}
+
+bool isTruePartition(Stmt *S) {
+  auto *AS = dyn_cast<AssumeStmt>(S);
+  if (!AS || !AS->isPartition())
+    return false;
+  auto *BCE = dyn_cast<BoolConstExpr>(AS->getPredicate());
+  return BCE && BCE->getValue();
+}
+
+bool equalSourceLocs(const SourceLocsRef &A, const SourceLocsRef &B) {
+  if (A == B)
+    return true;
+  if (!A || !B || A->size() != B->size())
+    return false;
+  for (unsigned i = 0; i != A->size(); ++i) {
+    const SourceLoc &LA = (*A)[i], &LB = (*B)[i];
+    if (LA.getLineNo() != LB.getLineNo() || LA.getColNo() != LB.getColNo() ||
+        LA.getFileName() != LB.getFileName() || LA.getPath() != LB.getPath())
+      return false;
+  }
+  return true;
+}
+
+class SimplifyCFG {
+  Function *F;
+  BasicBlock *Entry;
+  unsigned Threaded, Merged;
+
+  void removeRedundantSourceLocs(BasicBlock *BB);
+  void threadJumps();
+  void mergeBlocks();
+  void removeUnreachableBlocks();
+
+public:
+  SimplifyCFG(Function *F) : F(F), Entry(*F->begin()), Threaded(0), Merged(0) {}
+  void run();
+};
+
+// A block source location marks that the block was reached. It is redundant
+// if it has no source locations, or if an earlier statement of the same
+// straight-line block marks the same locations.
+void SimplifyCFG::removeRedundantSourceLocs(BasicBlock *BB) {
+  OwningPtrVector<Stmt> &V = BB->getStmtVector();
+  std::vector<SourceLocsRef> Seen;
+  bool Removed = false;
+  for (auto &S : V) {
+    if (!isBlockSourceLoc(S))
+      continue;
+
+    const SourceLocsRef &SL = S->getSourceLocs();
+    bool Redundant = !SL || SL->empty() ||
+                     std::any_of(Seen.begin(), Seen.end(),
+                                 [&](const SourceLocsRef &Other) {
+                                   return equalSourceLocs(SL, Other);
+                                 });
+    if (Redundant) {
+      delete S;
+      S = nullptr;
+      Removed = true;
+    } else {
+      Seen.push_back(SL);
+    }
+  }
+  if (Removed)
+    V.erase(std::remove(V.begin(), V.end(), nullptr), V.end());
+}
+
+// Retarget branches to blocks which contain nothing but block source
+// locations and a branch to a single other block.
+void SimplifyCFG::threadJumps() {
+  std::map<BasicBlock *, BasicBlock *> Forward;
+  for (auto *BB : *F) {
+    if (BB == Entry)
+      continue;
+    auto *GS = getGoto(BB);
+    if (!GS || GS->getBlocks().size() != 1 || GS->getBlocks()[0] == BB)
+      continue;
+    if (std::all_of(BB->begin(), BB->end() - 1, isBlockSourceLoc))
+      Forward[BB] = GS->getBlocks()[0];
+  }
+  if (Forward.empty())
+    return;
+
+  auto Resolve = [&](BasicBlock *BB) {
+    std::set<BasicBlock *> Visited;
+    auto i = Forward.find(BB);
+    while (i != Forward.end() && Visited.insert(BB).second) {
+      BB = i->second;
+      i = Forward.find(BB);
+    }
+    // A cycle of empty blocks is an infinite loop, which is left alone.
+    return i == Forward.end() ? BB : nullptr;
+  };
+
+  for (auto *BB : *F) {
+    auto *GS = getGoto(BB);
+    if (!GS)
+      continue;
+
+    bool Changed = false;
+    std::vector<BasicBlock *> Succs;
+    for (auto *Succ : GS->getBlocks()) {
+      BasicBlock *Target = Resolve(Succ);
+      if (!Target)
+        Target = Succ;
+      Changed |= Target != Succ;
+      if (std::find(Succs.begin(), Succs.end(), Target) == Succs.end())
+        Succs.push_back(Target);
+    }
+    if (!Changed)
+      continue;
+
+    ++Threaded;
+    OwningPtrVector<Stmt> &V = BB->getStmtVector();
+    delete V.back();
+    V.back() = GotoStmt::create(Succs);
+  }
+}
+
+// Append each block to its predecessor if it is the only predecessor and
+// the block its only successor. Partitions are kept at the start of blocks,
+// so a block guarded by a partition is only merged if the partition always
+// holds, in which case the partition is dropped.
+void SimplifyCFG::mergeBlocks() {
+  std::map<BasicBlock *, unsigned> PredCount;
+  for (auto *BB : *F)
+    if (auto *GS = getGoto(BB))
+      for (auto *Succ : GS->getBlocks())
+        ++PredCount[Succ];
+
+  std::set<BasicBlock *> Absorbed;
+  for (auto *BB : *F) {
+    if (Absorbed.count(BB))
+      continue;
+
+    while (true) {
+      auto *GS = getGoto(BB);
+      if (!GS || GS->getBlocks().size() != 1)
+        break;
+      BasicBlock *Succ = GS->getBlocks()[0];
+      if (Succ == BB || Succ == Entry || PredCount[Succ] != 1)
+        break;
+      OwningPtrVector<Stmt> &SuccV = Succ->getStmtVector();
+      bool Guarded = std::any_of(SuccV.begin(), SuccV.end(), [](Stmt *S) {
+        auto *AS = dyn_cast<AssumeStmt>(S);
+        return AS && AS->isPartition() && !isTruePartition(S);
+      });
+      if (Guarded)
+        break;
+
+      OwningPtrVector<Stmt> &V = BB->getStmtVector();
+      delete V.back();
+      V.pop_back();
+      for (auto *S : SuccV) {
+        if (isTruePartition(S))
+          delete S;
+        else
+          V.push_back(S);
+      }
+      SuccV.clear();
+      Absorbed.insert(Succ);
+      ++Merged;
+    }
+  }
+}
+
+void SimplifyCFG::removeUnreachableBlocks() {
+  std::set<BasicBlock *> Reachable;
+  std::vector<BasicBlock *> Worklist;
+  Reachable.insert(Entry);
+  Worklist.push_back(Entry);
+  while (!Worklist.empty()) {
+    BasicBlock *BB = Worklist.back();
+    Worklist.pop_back();
+    if (auto *GS = getGoto(BB))
+      for (auto *Succ : GS->getBlocks())
+        if (Reachable.insert(Succ).second)
+          Worklist.push_back(Succ);
+  }
+
+  OwningPtrVector<BasicBlock> &Blocks = F->getBlockVector();
+  for (auto &BB : Blocks) {
+    if (!Reachable.count(BB)) {
+      delete BB;
+      BB = nullptr;
+    }
+  }
+  Blocks.erase(std::remove(Blocks.begin(), Blocks.end(), nullptr),
+               Blocks.end());
+}
+
+void SimplifyCFG::run() {
+  for (auto *BB : *F)
+    removeRedundantSourceLocs(BB);
+
+  // Blocks which are not reachable may branch to the blocks to be merged.
+  removeUnreachableBlocks();
+  threadJumps();
+  removeUnreachableBlocks();
+  mergeBlocks();
+  removeUnreachableBlocks();
+
+  // Merging brings the source locations of several blocks together.
+  for (auto *BB : *F)
+    removeRedundantSourceLocs(BB);
+
+  Profiler::addToCounter("cfg.threaded-branches", Threaded);
+  Profiler::addToCounter("cfg.merged-blocks", Merged);
+}
+}
+
+void bugle::simplifyCFG(Module *M) {
+  for (auto i = M->function_begin(), e = M->function_end(); i != e; ++i) {
+    if ((*i)->begin() == (*i)->end())
+      continue;
+    SimplifyCFG CFG(*i);
+    CFG.run();
+  }
+}
@@ -2,6 +2,9 @@
 #include "bugle/Module.h"
 #include "bugle/Function.h"
 #include "bugle/BasicBlock.h"
+#include <algorithm>
+#include <map>
+#include <set>
 
 using namespace bugle;
 
@@ -22,45 +25,194 @@ bool isTemporal(Expr *e) {
          isa<AsyncWorkGroupCopyExpr>(e) || isa<BVCtlzExpr>(e);
 }
 
+// Whether the EvalStmt of E may be removed if E is unused.
+bool isRemovableIfUnused(Expr *E) {
+  if (hasSideEffects(E))
+    return false;
+  return !isTemporal(E) ||
+         (!isa<LoadExpr>(E) && !isa<AsyncWorkGroupCopyExpr>(E));
+}
+
+// Remove the EvalStmts of expressions which are unused, or which are used
+// once and may be written where they are used. The statements are visited
+// in reverse, so that removing a statement releases the expressions which
+// earlier statements may then be removed for, and the block is compacted
+// once at the end.
 void ProcessBasicBlock(BasicBlock *BB) {
   OwningPtrVector<Stmt> &V = BB->getStmtVector();
-  if (V.empty())
+  bool Changed = false;
+  for (auto i = V.rbegin(), e = V.rend(); i != e; ++i) {
+    auto *ES = dyn_cast<EvalStmt>(*i);
+    if (!ES)
+      continue;
+
+    Expr *E = ES->getExpr().get();
+    if (hasSideEffects(E))
+      continue;
+
+    if ((E->refCount == 1 && !dyn_cast<LoadExpr>(E) &&
+         !dyn_cast<AsyncWorkGroupCopyExpr>(E)) ||
+        (!isTemporal(E) && E->refCount <= 2)) {
+      delete *i;
+      *i = nullptr;
+      Changed = true;
+    }
+  }
+
+  if (Changed)
+    V.erase(std::remove(V.begin(), V.end(), nullptr), V.end());
+}
+
+// Remove the blocks which cannot be reached from the entry block.
+void RemoveUnreachableBlocks(Function *F) {
+  OwningPtrVector<BasicBlock> &Blocks = F->getBlockVector();
+  if (Blocks.empty())
     return;
-  auto i = V.end() - 1;
-  while (true) {
-    if (auto *ES = dyn_cast<EvalStmt>(*i)) {
-      Expr *E = ES->getExpr().get();
-      if (hasSideEffects(E)) {
-        if (i == V.begin())
-          break;
-        --i;
+
+  std::set<BasicBlock *> Reachable;
+  std::vector<BasicBlock *> Worklist;
+  Reachable.insert(Blocks.front());
+  Worklist.push_back(Blocks.front());
+  while (!Worklist.empty()) {
+    BasicBlock *BB = Worklist.back();
+    Worklist.pop_back();
+    if (BB->begin() == BB->end())
+      continue;
+    if (auto *GS = dyn_cast<GotoStmt>(*(BB->end() - 1))) {
+      for (auto *Succ : GS->getBlocks())
+        if (Reachable.insert(Succ).second)
+          Worklist.push_back(Succ);
+    }
+  }
+
+  if (Reachable.size() == Blocks.size())
+    return;
+
+  for (auto &BB : Blocks) {
+    if (!Reachable.count(BB)) {
+      delete BB;
+      BB = nullptr;
+    }
+  }
+  Blocks.erase(std::remove(Blocks.begin(), Blocks.end(), nullptr),
+               Blocks.end());
+}
+
+// Remove the local variables whose values are never needed, together with
+// their assignments, and the EvalStmts of the expressions which are never
+// needed. A value is needed if it is used by a statement other than an
+// assignment to a local variable or the evaluation of an expression which
+// may be removed, by a specification, or by a needed value. Chains of
+// assignments and evaluations are therefore removed in a single pass.
+void RemoveDeadVars(Function *F) {
+  std::set<Var *> Locals(F->local_begin(), F->local_end());
+  std::map<Var *, std::vector<Expr *>> AssignedValues;
+  std::vector<Expr *> Worklist;
+  for (auto *BB : *F) {
+    for (auto *S : *BB) {
+      if (auto *VAS = dyn_cast<VarAssignStmt>(S)) {
+        for (unsigned i = 0; i != VAS->getVars().size(); ++i) {
+          Var *V = VAS->getVars()[i];
+          Expr *Val = VAS->getValues()[i].get();
+          if (Locals.count(V))
+            AssignedValues[V].push_back(Val);
+          else
+            Worklist.push_back(Val);
+        }
+      } else if (auto *ES = dyn_cast<EvalStmt>(S)) {
+        if (!isRemovableIfUnused(ES->getExpr().get()))
+          Worklist.push_back(ES->getExpr().get());
+      } else {
+        S->getOperands(Worklist);
+      }
+    }
+  }
+
+  auto AddSpecs = [&](OwningPtrVector<SpecificationInfo>::const_iterator i,
+                      OwningPtrVector<SpecificationInfo>::const_iterator e) {
+    for (; i != e; ++i)
+      Worklist.push_back((*i)->getExpr().get());
+  };
+  AddSpecs(F->requires_begin(), F->requires_end());
+  AddSpecs(F->globalRequires_begin(), F->globalRequires_end());
+  AddSpecs(F->ensures_begin(), F->ensures_end());
+  AddSpecs(F->globalEnsures_begin(), F->globalEnsures_end());
+  AddSpecs(F->modifies_begin(), F->modifies_end());
+  AddSpecs(F->procedureWideInvariant_begin(), F->procedureWideInvariant_end());
+  AddSpecs(F->procedureWideCandidateInvariant_begin(),
+           F->procedureWideCandidateInvariant_end());
+
+  std::set<Var *> Live;
+  std::set<Expr *> Visited;
+  while (!Worklist.empty()) {
+    Expr *E = Worklist.back();
+    Worklist.pop_back();
+    if (!Visited.insert(E).second)
+      continue;
+    if (auto *VRE = dyn_cast<VarRefExpr>(E)) {
+      Var *V = VRE->getVar();
+      if (Locals.count(V) && Live.insert(V).second) {
+        auto &Vals = AssignedValues[V];
+        Worklist.insert(Worklist.end(), Vals.begin(), Vals.end());
+      }
+    }
+    E->getOperands(Worklist);
+  }
+
+  for (auto *BB : *F) {
+    OwningPtrVector<Stmt> &V = BB->getStmtVector();
+    bool Removed = false;
+    for (auto &S : V) {
+      if (auto *ES = dyn_cast<EvalStmt>(S)) {
+        if (!Visited.count(ES->getExpr().get())) {
+          delete S;
+          S = nullptr;
+          Removed = true;
+        }
         continue;
       }
 
-      if ((E->refCount == 1 && !dyn_cast<LoadExpr>(E) &&
-           !dyn_cast<AsyncWorkGroupCopyExpr>(E)) ||
-          (!isTemporal(E) && E->refCount <= 2)) {
-        auto ii = i;
-        bool begin = false;
-        if (i == V.begin())
-          begin = true;
-        else
-          --i;
-        delete *ii;
-        V.erase(ii);
-        if (begin)
-          break;
-        else
-          continue;
+      auto *VAS = dyn_cast<VarAssignStmt>(S);
+      if (!VAS)
+        continue;
+
+      std::vector<Var *> Vars;
+      std::vector<ref<Expr>> Values;
+      for (unsigned i = 0; i != VAS->getVars().size(); ++i) {
+        Var *Dest = VAS->getVars()[i];
+        if (!Locals.count(Dest) || Live.count(Dest)) {
+          Vars.push_back(Dest);
+          Values.push_back(VAS->getValues()[i]);
+        }
       }
+      if (Vars.size() == VAS->getVars().size())
+        continue;
+
+      delete S;
+      S = Vars.empty() ? nullptr : VarAssignStmt::create(Vars, Values);
+      Removed |= Vars.empty();
+    }
+    if (Removed)
+      V.erase(std::remove(V.begin(), V.end(), nullptr), V.end());
+  }
+
+  OwningPtrVector<Var> &LocalVars = F->getLocalVector();
+  for (auto &V : LocalVars) {
+    if (!Live.count(V)) {
+      delete V;
+      V = nullptr;
     }
-    if (i == V.begin())
-      break;
-    --i;
   }
+  LocalVars.erase(std::remove(LocalVars.begin(), LocalVars.end(), nullptr),
+                  LocalVars.end());
 }
 
+// Once the values which are never needed are removed, each remaining
+// EvalStmt is used, so compacting the blocks removes no more than the
+// statements written where they are used, which releases nothing else.
 void ProcessFunction(Function *F) {
+  RemoveUnreachableBlocks(F);
+  RemoveDeadVars(F);
   for (auto *BB : *F)
     ProcessBasicBlock(BB);
 }
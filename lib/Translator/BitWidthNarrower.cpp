@@ -0,0 +1,131 @@
+#include "bugle/Translator/BitWidthNarrower.h"
+#include "bugle/Casting.h"
+#include "bugle/Expr.h"
+#include "llvm/Support/MathExtras.h"
+#include <algorithm>
+
+using namespace bugle;
+
+namespace {
+
+// Bounds are only followed this far into an expression. Operands have
+// already been narrowed when their own instructions were translated, so
+// little is lost.
+const unsigned MaxDepth = 8;
+
+uint64_t getMaxValue(unsigned Width) {
+  return Width >= 64 ? UINT64_MAX : ((uint64_t)1 << Width) - 1;
+}
+
+unsigned getActiveBits(uint64_t Value) {
+  return Value == 0 ? 1 : llvm::Log2_64(Value) + 1;
+}
+}
+
+// An upper bound on the unsigned value of E.
+uint64_t BitWidthNarrower::getUpperBound(Expr *E, unsigned Depth) {
+  if (!E->getType().isKind(Type::BV) || E->getType().width > 64)
+    return UINT64_MAX;
+  unsigned Width = E->getType().width;
+  uint64_t Max = getMaxValue(Width);
+  if (Depth > MaxDepth)
+    return Max;
+
+  if (auto *CE = dyn_cast<BVConstExpr>(E))
+    return CE->getValue().getZExtValue();
+
+  if (auto *SVRE = dyn_cast<SpecialVarRefExpr>(E)) {
+    auto i = SpecialVarBounds.find(SVRE->getAttr());
+    return i == SpecialVarBounds.end() ? Max : std::min(i->second, Max);
+  }
+
+  if (isa<BVZExtExpr>(E) || isa<BVSExtExpr>(E) || isa<BVExtractExpr>(E)) {
+    Expr *Sub;
+    if (auto *EE = dyn_cast<BVExtractExpr>(E)) {
+      if (EE->getOffset() != 0)
+        return Max;
+      Sub = EE->getSubExpr().get();
+    } else {
+      Sub = cast<UnaryExpr>(E)->getSubExpr().get();
+    }
+    uint64_t Bound = getUpperBound(Sub, Depth + 1);
+    // A sign extension is a zero extension if the sign bit is clear.
+    if (isa<BVSExtExpr>(E) && Bound > getMaxValue(Sub->getType().width) >> 1)
+      return Max;
+    return std::min(Bound, Max);
+  }
+
+  if (auto *ITE = dyn_cast<IfThenElseExpr>(E))
+    return std::max(getUpperBound(ITE->getTrueExpr().get(), Depth + 1),
+                    getUpperBound(ITE->getFalseExpr().get(), Depth + 1));
+
+  auto *BE = dyn_cast<BinaryExpr>(E);
+  if (!BE)
+    return Max;
+  uint64_t LHS = getUpperBound(BE->getLHS().get(), Depth + 1),
+           RHS = getUpperBound(BE->getRHS().get(), Depth + 1);
+  switch (E->getKind()) {
+  case Expr::BVAdd:
+    return LHS > Max - RHS ? Max : LHS + RHS;
+  case Expr::BVMul:
+    return LHS != 0 && RHS > Max / LHS ? Max : LHS * RHS;
+  case Expr::BVShl:
+    if (!isa<BVConstExpr>(BE->getRHS()) || RHS >= Width ||
+        LHS > (Max >> RHS))
+      return Max;
+    return LHS << RHS;
+  case Expr::BVLShr:
+    if (!isa<BVConstExpr>(BE->getRHS()) || RHS >= Width)
+      return LHS;
+    return LHS >> RHS;
+  case Expr::BVUDiv:
+    if (!isa<BVConstExpr>(BE->getRHS()) || RHS == 0)
+      return LHS;
+    return LHS / RHS;
+  case Expr::BVURem:
+    return RHS == 0 ? LHS : std::min(LHS, RHS - 1);
+  case Expr::BVAnd:
+    return std::min(LHS, RHS);
+  default:
+    return Max;
+  }
+}
+
+// The value of E, which is known to be below 2^Width, as a bitvector of the
+// given width.
+ref<Expr> BitWidthNarrower::truncate(ref<Expr> E, unsigned Width) {
+  if (auto *CE = dyn_cast<BVConstExpr>(E))
+    return BVConstExpr::create(CE->getValue().trunc(Width));
+  if (auto *ZEE = dyn_cast<BVZExtExpr>(E))
+    return BVZExtExpr::create(Width, ZEE->getSubExpr(), ZEE->isNonNegative());
+  if (auto *SEE = dyn_cast<BVSExtExpr>(E))
+    return BVSExtExpr::create(Width, SEE->getSubExpr());
+  return BVExtractExpr::create(E, 0, Width);
+}
+
+ref<Expr> BitWidthNarrower::narrow(ref<Expr> E) {
+  if ((!isa<BVAddExpr>(E) && !isa<BVMulExpr>(E) && !isa<BVShlExpr>(E)) ||
+      E->getType().width > 64)
+    return E;
+
+  auto *BE = cast<BinaryExpr>(E);
+  uint64_t Bound = std::max({getUpperBound(E.get(), 0),
+                             getUpperBound(BE->getLHS().get(), 0),
+                             getUpperBound(BE->getRHS().get(), 0)});
+  // Keep the sign bit clear, so that the narrowed value is non-negative
+  // whether it is read as signed or unsigned.
+  unsigned Width = getActiveBits(Bound) + 1;
+  if (Width >= E->getType().width)
+    return E;
+
+  ref<Expr> LHS = truncate(BE->getLHS(), Width),
+            RHS = truncate(BE->getRHS(), Width), Narrowed;
+  if (isa<BVAddExpr>(E))
+    Narrowed = BVAddExpr::create(LHS, RHS);
+  else if (isa<BVMulExpr>(E))
+    Narrowed = BVMulExpr::create(LHS, RHS);
+  else
+    Narrowed = BVShlExpr::create(LHS, RHS);
+  return BVZExtExpr::create(E->getType().width, Narrowed,
+                            /*nonNegative=*/true);
+}
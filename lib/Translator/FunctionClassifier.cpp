@@ -0,0 +1,90 @@
+#include "bugle/Translator/FunctionClassifier.h"
+#include "bugle/Translator/TranslateFunction.h"
+#include "llvm/ADT/StringSwitch.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Metadata.h"
+#include "llvm/IR/Module.h"
+
+using namespace bugle;
+using namespace llvm;
+
+void FunctionClassifier::computeAnnotatedKernels() {
+  AnnotatedKernels.clear();
+  AnnotatedKernelsValid = true;
+
+  if (SL == TranslateModule::SL_OpenCL || SL == TranslateModule::SL_CUDA) {
+    if (auto *NMD = M->getNamedMetadata("nvvm.annotations")) {
+      for (auto *MD : NMD->operands()) {
+        auto *F = mdconst::dyn_extract_or_null<llvm::Function>(
+            MD->getOperand(0));
+        if (!F)
+          continue;
+        for (unsigned i = 1, e = MD->getNumOperands(); i != e; i += 2)
+          if (cast<MDString>(MD->getOperand(i))->getString() == "kernel")
+            AnnotatedKernels.insert(F);
+      }
+    }
+  }
+
+  if (SL == TranslateModule::SL_OpenCL) {
+    if (auto *NMD = M->getNamedMetadata("opencl.kernels")) {
+      for (auto *MD : NMD->operands()) {
+        if (auto *F = mdconst::dyn_extract_or_null<llvm::Function>(
+                MD->getOperand(0)))
+          AnnotatedKernels.insert(F);
+      }
+    }
+  }
+}
+
+FunctionClassifier::Kind FunctionClassifier::classify(llvm::Function *F) {
+  StringRef Name = F->getName();
+  if (F->isIntrinsic())
+    return FK_Intrinsic;
+  switch (TranslateFunction::getSpecialFunctionKind(SL, Name)) {
+  case SFK_Axiom:
+    return FK_Axiom;
+  case SFK_Uninterpreted:
+    return FK_Uninterpreted;
+  case SFK_Function:
+    return FK_Special;
+  case SFK_Specification:
+    return FK_Specification;
+  case SFK_None:
+  case SFK_FreshArray:
+    break;
+  }
+  if (TranslateFunction::isBarrierFunction(SL, Name))
+    return FK_Barrier;
+  if (TranslateFunction::isGridBarrierFunction(SL, Name))
+    return FK_GridBarrier;
+
+  if (!AnnotatedKernelsValid)
+    computeAnnotatedKernels();
+  if (AnnotatedKernels.count(F) || isExplicitEntryPoint(F))
+    return FK_Kernel;
+  if (TranslateFunction::isStandardEntryPoint(SL, Name))
+    return FK_StandardEntryPoint;
+  return FK_Normal;
+}
+
+bool FunctionClassifier::isExplicitEntryPoint(llvm::Function *F) {
+  return GPUEntryPoints.find(F->getName().str()) != GPUEntryPoints.end();
+}
+
+bool FunctionClassifier::isLoopInvariantFunction(llvm::Function *F) {
+  if (getKind(F) != FK_Special)
+    return false;
+  return StringSwitch<bool>(F->getName())
+      .Case("__invariant", true)
+      .Case("__global_invariant", true)
+      .Case("__candidate_invariant", true)
+      .Case("__candidate_global_invariant", true)
+      .Default(false);
+}
+
+void FunctionClassifier::invalidate() {
+  Kinds.clear();
+  AnnotatedKernelsValid = false;
+}
@@ -1,4 +1,5 @@
 #include "bugle/Translator/TranslateFunction.h"
+#include "bugle/Translator/FunctionClassifier.h"
 #include "bugle/Translator/TranslateModule.h"
 #include "bugle/BPLFunctionWriter.h"
 #include "bugle/BPLModuleWriter.h"
@@ -20,6 +21,8 @@
 #include "llvm/IR/Intrinsics.h"
 #include "llvm/IR/Metadata.h"
 #include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -28,8 +31,8 @@ using namespace llvm;
 
 typedef std::vector<ref<Expr>> ExprVec;
 
-TranslateFunction::SpecialFnMapTy
-    TranslateFunction::SpecialFunctionMaps[TranslateModule::SL_Count];
+// Defines SpecialFunctionTables and TranslateFunction::SpecialFnHandlers.
+#include "SpecialFunctions.inc"
 
 // Appends at least the given basic block to the given list BBList (if not
 // already present), so as to maintain the invariants that:
@@ -59,31 +62,26 @@ static void AddBasicBlockInOrder(std::set<llvm::BasicBlock *> &BBSet,
   BBList.push_back(BB);
 }
 
-bool TranslateFunction::isSpecialFunction(TranslateModule::SourceLanguage SL,
-                                          const std::string &fnName) {
-  SpecialFnMapTy &SpecialFunctionMap = initSpecialFunctionMap(SL);
-  return SpecialFunctionMap.Functions.find(fnName) !=
-         SpecialFunctionMap.Functions.end();
+const SpecialFnEntry *
+TranslateFunction::lookupSpecialFunction(TranslateModule::SourceLanguage SL,
+                                         StringRef fnName) {
+  return SpecialFunctionTables[SL].lookup(fnName.data(), fnName.size());
 }
 
-void
-TranslateFunction::addUninterpretedFunction(TranslateModule::SourceLanguage SL,
-                                            const std::string &fnName) {
-  SpecialFnMapTy &SpecialFunctionMap = initSpecialFunctionMap(SL);
-  SpecialFunctionMap.Functions[fnName] =
-      &TranslateFunction::handleUninterpretedFunction;
-}
-
-bool TranslateFunction::isAxiomFunction(StringRef fnName) {
-  return fnName.startswith("__axiom");
-}
-
-bool TranslateFunction::isUninterpretedFunction(StringRef fnName) {
-  return fnName.startswith("__uninterpreted_function_");
+SpecialFnKind
+TranslateFunction::getSpecialFunctionKind(TranslateModule::SourceLanguage SL,
+                                          StringRef fnName) {
+  auto *E = lookupSpecialFunction(SL, fnName);
+  return E ? (SpecialFnKind)E->Kind : SFK_None;
 }
 
-bool TranslateFunction::isSpecificationFunction(StringRef fnName) {
-  return fnName.startswith("__spec");
+TranslateFunction::SpecialFnHandler TranslateFunction::*
+TranslateFunction::getSpecialFunctionHandler(
+    TranslateModule::SourceLanguage SL, StringRef fnName) {
+  auto *E = lookupSpecialFunction(SL, fnName);
+  if (!E || E->Handler == NoSpecialFnHandler)
+    return nullptr;
+  return SpecialFnHandlers[E->Handler];
 }
 
 bool TranslateFunction::isPreOrPostCondition(StringRef fnName) {
@@ -113,25 +111,6 @@ bool TranslateFunction::isGridBarrierFunction(TranslateModule::SourceLanguage SL
   return SL == TranslateModule::SL_CUDA && fnName == "bugle_grid_barrier";
 }
 
-bool TranslateFunction::isNormalFunction(TranslateModule::SourceLanguage SL,
-                                         llvm::Function *F) {
-  if (F->isIntrinsic())
-    return false;
-  if (isAxiomFunction(F->getName()))
-    return false;
-  if (isUninterpretedFunction(F->getName()))
-    return false;
-  if (isSpecialFunction(SL, F->getName()))
-    return false;
-  if (isSpecificationFunction(F->getName()))
-    return false;
-  if (isBarrierFunction(SL, F->getName()))
-    return false;
-  if (isGridBarrierFunction(SL, F->getName()))
-    return false;
-  return true;
-}
-
 bool TranslateFunction::isStandardEntryPoint(TranslateModule::SourceLanguage SL,
                                              StringRef fnName) {
   return SL == TranslateModule::SL_C && fnName == "main";
@@ -147,327 +126,82 @@ TranslateFunction::trimForRequiresFreshArrayFunction(llvm::StringRef fnName) {
                                                       : fnName;
 }
 
-TranslateFunction::SpecialFnMapTy &
-TranslateFunction::initSpecialFunctionMap(TranslateModule::SourceLanguage SL) {
-  SpecialFnMapTy &SpecialFunctionMap = SpecialFunctionMaps[SL];
-  if (SpecialFunctionMap.Functions.empty()) {
-    auto &fns = SpecialFunctionMap.Functions;
-    fns["bugle_assert"] = &TranslateFunction::handleAssert;
-    fns["__assert"] = &TranslateFunction::handleAssert;
-    fns["__global_assert"] = &TranslateFunction::handleGlobalAssert;
-    fns["__candidate_assert"] = &TranslateFunction::handleCandidateAssert;
-    fns["__candidate_global_assert"] = &TranslateFunction::handleCandidateGlobalAssert;
-    fns["__invariant"] = &TranslateFunction::handleInvariant;
-    fns["__global_invariant"] = &TranslateFunction::handleGlobalInvariant;
-    fns["__candidate_invariant"] = &TranslateFunction::handleCandidateInvariant;
-    fns["__candidate_global_invariant"] = &TranslateFunction::handleCandidateGlobalInvariant;
-    fns["__non_temporal_loads_begin"] = &TranslateFunction::handleNonTemporalLoadsBegin;
-    fns["__non_temporal_loads_end"] = &TranslateFunction::handleNonTemporalLoadsEnd;
-    fns["bugle_assume"] = &TranslateFunction::handleAssume;
-    fns["__assert_fail"] = &TranslateFunction::handleAssertFail;
-    fns["bugle_requires"] = &TranslateFunction::handleRequires;
-    fns["__requires"] = &TranslateFunction::handleRequires;
-    fns["__global_requires"] = &TranslateFunction::handleGlobalRequires;
-    fns["__requires_fresh_array"] = &TranslateFunction::handleRequiresFreshArray;
-    fns["bugle_ensures"] = &TranslateFunction::handleEnsures;
-    fns["__ensures"] = &TranslateFunction::handleEnsures;
-    fns["__global_ensures"] = &TranslateFunction::handleGlobalEnsures;
-    fns["__function_wide_invariant"] = &TranslateFunction::handleFunctionWideInvariant;
-    fns["__function_wide_candidate_invariant"] = &TranslateFunction::handleFunctionWideCandidateInvariant;
-    fns["__reads_from"] = &TranslateFunction::handleReadsFrom;
-    fns["__reads_from_local"] = &TranslateFunction::handleReadsFrom;
-    fns["__reads_from_global"] = &TranslateFunction::handleReadsFrom;
-    fns["__writes_to"] = &TranslateFunction::handleWritesTo;
-    fns["__writes_to_local"] = &TranslateFunction::handleWritesTo;
-    fns["__writes_to_global"] = &TranslateFunction::handleWritesTo;
-    fns["bugle_frexp_exp"] = &TranslateFunction::handleFrexpExp;
-    fns["bugle_frexp_frac"] = &TranslateFunction::handleFrexpFrac;
-    fns["__add_noovfl_char"] = &TranslateFunction::handleAddNoovflSigned;
-    fns["__add_noovfl_short"] = &TranslateFunction::handleAddNoovflSigned;
-    fns["__add_noovfl_int"] = &TranslateFunction::handleAddNoovflSigned;
-    fns["__add_noovfl_long"] = &TranslateFunction::handleAddNoovflSigned;
-    fns["__add_noovfl_unsigned_char"] = &TranslateFunction::handleAddNoovflUnsigned;
-    fns["__add_noovfl_unsigned_short"] = &TranslateFunction::handleAddNoovflUnsigned;
-    fns["__add_noovfl_unsigned_int"] = &TranslateFunction::handleAddNoovflUnsigned;
-    fns["__add_noovfl_unsigned_long"] = &TranslateFunction::handleAddNoovflUnsigned;
-    fns["__atomic_has_taken_value_local"] = &TranslateFunction::handleAtomicHasTakenValue;
-    fns["__atomic_has_taken_value_global"] = &TranslateFunction::handleAtomicHasTakenValue;
-    fns["__atomic_has_taken_value"] = &TranslateFunction::handleAtomicHasTakenValue;
-    const unsigned NOOVFL_PREDICATE_MAX_ARITY = 20;
-    const std::string tys[] = {"char", "short", "int", "long"};
-    for (unsigned j = 0; j < 4; ++j) {
-      std::string t = tys[j];
-      for (unsigned i = 0; i <= NOOVFL_PREDICATE_MAX_ARITY; ++i) {
-        std::string S = "__add_noovfl_unsigned_";
-        llvm::raw_string_ostream SS(S);
-        SS << t << "_" << i;
-        fns[SS.str()] = &TranslateFunction::handleAddNoovflPredicate;
-      }
-    }
-    fns["__add_char"] = &TranslateFunction::handleAdd;
-    fns["__add_short"] = &TranslateFunction::handleAdd;
-    fns["__add_int"] = &TranslateFunction::handleAdd;
-    fns["__add_long"] = &TranslateFunction::handleAdd;
-    fns["__add_unsigned_char"] = &TranslateFunction::handleAdd;
-    fns["__add_unsigned_short"] = &TranslateFunction::handleAdd;
-    fns["__add_unsigned_int"] = &TranslateFunction::handleAdd;
-    fns["__add_unsigned_long"] = &TranslateFunction::handleAdd;
-    fns["__ite_char"] = &TranslateFunction::handleIte;
-    fns["__ite_short"] = &TranslateFunction::handleIte;
-    fns["__ite_int"] = &TranslateFunction::handleIte;
-    fns["__ite_long"] = &TranslateFunction::handleIte;
-    fns["__ite_unsigned_char"] = &TranslateFunction::handleIte;
-    fns["__ite_unsigned_short"] = &TranslateFunction::handleIte;
-    fns["__ite_unsigned_int"] = &TranslateFunction::handleIte;
-    fns["__ite_unsigned_long"] = &TranslateFunction::handleIte;
-    fns["__ite_size_t"] = &TranslateFunction::handleIte;
-    fns["__return_val_int"] = &TranslateFunction::handleReturnVal;
-    fns["__return_val_int4"] = &TranslateFunction::handleReturnVal;
-    fns["__return_val_bool"] = &TranslateFunction::handleReturnVal;
-    fns["__return_val_ptr"] = &TranslateFunction::handleReturnVal;
-    fns["__return_val_funptr"] = &TranslateFunction::handleReturnVal;
-    fns["__old_int"] = &TranslateFunction::handleOld;
-    fns["__old_bool"] = &TranslateFunction::handleOld;
-    fns["__other_int"] = &TranslateFunction::handleOtherInt;
-    fns["__other_bool"] = &TranslateFunction::handleOtherBool;
-    fns["__other_ptr_base"] = &TranslateFunction::handleOtherPtrBase;
-    fns["__implies"] = &TranslateFunction::handleImplies;
-    fns["__enabled"] = &TranslateFunction::handleEnabled;
-    fns["__dominator_enabled"] = &TranslateFunction::handleDominatorEnabled;
-    fns["__read_local"] = &TranslateFunction::handleReadHasOccurred;
-    fns["__read_global"] = &TranslateFunction::handleReadHasOccurred;
-    fns["__read"] = &TranslateFunction::handleReadHasOccurred;
-    fns["__write_local"] = &TranslateFunction::handleWriteHasOccurred;
-    fns["__write_global"] = &TranslateFunction::handleWriteHasOccurred;
-    fns["__write"] = &TranslateFunction::handleWriteHasOccurred;
-    fns["__read_offset_bytes_local"] = &TranslateFunction::handleReadOffset;
-    fns["__read_offset_bytes_global"] = &TranslateFunction::handleReadOffset;
-    fns["__read_offset_bytes"] = &TranslateFunction::handleReadOffset;
-    fns["__write_offset_bytes_local"] = &TranslateFunction::handleWriteOffset;
-    fns["__write_offset_bytes_global"] = &TranslateFunction::handleWriteOffset;
-    fns["__write_offset_bytes"] = &TranslateFunction::handleWriteOffset;
-    fns["__ptr_base_local"] = &TranslateFunction::handlePtrBase;
-    fns["__ptr_base_global"] = &TranslateFunction::handlePtrBase;
-    fns["__ptr_base"] = &TranslateFunction::handlePtrBase;
-    fns["__ptr_offset_bytes_local"] = &TranslateFunction::handlePtrOffset;
-    fns["__ptr_offset_bytes_global"] = &TranslateFunction::handlePtrOffset;
-    fns["__ptr_offset_bytes"] = &TranslateFunction::handlePtrOffset;
-    fns["__array_snapshot_local"] = &TranslateFunction::handleArraySnapshot;
-    fns["__array_snapshot_global"] = &TranslateFunction::handleArraySnapshot;
-    fns["__array_snapshot"] = &TranslateFunction::handleArraySnapshot;
-
-    if (SL == TranslateModule::SL_OpenCL || SL == TranslateModule::SL_CUDA) {
-      const std::string opencl[] = {"__bugle_atomic_add",
-                                      "_local_int", "_local_uint",
-                                      "_global_int", "_global_uint",
-                                      "_local_long", "_local_unsigned_long",
-                                      "_global_long", "_global_unsigned_long",
-                                      "" ,
-                                    "__bugle_atomic_sub",
-                                      "_local_int", "_local_uint",
-                                      "_global_int", "_global_uint",
-                                      "_local_long", "_local_unsigned_long",
-                                      "_global_long", "_global_unsigned_long",
-                                      "" ,
-                                    "__bugle_atomic_xchg",
-                                      "_local_int", "_local_uint",
-                                      "_global_int", "_global_uint",
-                                      "_local_float", "_global_float",
-                                      "_local_long", "_local_unsigned_long",
-                                      "_global_long", "_global_unsigned_long",
-                                      "" ,
-                                    "__bugle_atomic_min",
-                                      "_local_int", "_local_uint",
-                                      "_global_int", "_global_uint",
-                                      "_local_long", "_local_unsigned_long",
-                                      "_global_long", "_global_unsigned_long",
-                                      "" ,
-                                    "__bugle_atomic_max",
-                                      "_local_int", "_local_uint",
-                                      "_global_int", "_global_uint",
-                                      "_local_long", "_local_unsigned_long",
-                                      "_global_long", "_global_unsigned_long",
-                                      "" ,
-                                    "__bugle_atomic_and",
-                                      "_local_int", "_local_uint",
-                                      "_global_int", "_global_uint",
-                                      "_local_long", "_local_unsigned_long",
-                                      "_global_long", "_global_unsigned_long",
-                                      "" ,
-                                    "__bugle_atomic_or",
-                                      "_local_int", "_local_uint",
-                                      "_global_int", "_global_uint",
-                                      "_local_long", "_local_unsigned_long",
-                                      "_global_long", "_global_unsigned_long",
-                                      "" ,
-                                    "__bugle_atomic_xor",
-                                      "_local_int", "_local_uint",
-                                      "_global_int", "_global_uint",
-                                      "_local_long", "_local_unsigned_long",
-                                      "_global_long", "_global_unsigned_long",
-                                      "" ,
-                                    "__bugle_atomic_cmpxchg",
-                                      "_local_int", "_local_uint",
-                                      "_global_int", "_global_uint",
-                                      "_local_long", "_local_unsigned_long",
-                                      "_global_long", "_global_unsigned_long",
-                                      "" ,
-                                    "__bugle_atomic_inc",
-                                      "_local_int", "_local_uint",
-                                      "_global_int", "_global_uint",
-                                      "_local_long", "_local_unsigned_long",
-                                      "_global_long", "_global_unsigned_long",
-                                      "" ,
-                                    "__bugle_atomic_dec",
-                                      "_local_int", "_local_uint",
-                                      "_global_int", "_global_uint",
-                                      "_local_long", "_local_unsigned_long",
-                                      "_global_long", "_global_unsigned_long",
-                                      "" ,
-                                    ""};
-
-      const std::string cuda[] = {"__atomicAdd",
-                                    "_int", "_unsigned_int",
-                                    "_unsigned_long_long_int",
-                                    "_float", "",
-                                  "__atomicSub",
-                                    "_int", "_unsigned_int", "",
-                                  "__atomicExch",
-                                    "_int", "_unsigned_int",
-                                    "_unsigned_long_long_int",
-                                    "_float", "",
-                                  "__atomicMin",
-                                    "_int", "_unsigned_int",
-                                    "_unsigned_long_long_int", "",
-                                  "__atomicMax",
-                                    "_int", "_unsigned_int",
-                                    "_unsigned_long_long_int", "",
-                                  "__atomicAnd",
-                                    "_int", "_unsigned_int",
-                                    "_unsigned_long_long_int", "",
-                                  "__atomicOr",
-                                    "_int", "_unsigned_int",
-                                    "_unsigned_long_long_int", "",
-                                  "__atomicXor",
-                                    "_int", "_unsigned_int",
-                                    "_unsigned_long_long_int", "",
-                                  "__atomicInc",
-                                    "_unsigned_int", "",
-                                  "__atomicDec",
-                                    "_unsigned_int", "",
-                                  "__atomicCAS",
-                                    "_int", "_unsigned_int",
-                                    "_unsigned_long_long_int", "",
-                                  ""};
-
-      const std::string *atomics =
-          ((SL == TranslateModule::SL_OpenCL) ? opencl : cuda);
-
-      int i = 0;
-      while (atomics[i] != "") {
-        std::string t = atomics[i];
-        ++i;
-        while (atomics[i] != "") {
-          fns[t + atomics[i]] = &TranslateFunction::handleAtomic;
-          ++i;
-        }
-        ++i;
-      }
-    }
-
-    if (SL == TranslateModule::SL_OpenCL || SL == TranslateModule::SL_CUDA) {
-      const unsigned BARRIER_INVARIANT_MAX_ARITY = 20;
-      for (unsigned i = 0; i <= BARRIER_INVARIANT_MAX_ARITY; ++i) {
-        std::string S = "__barrier_invariant_";
-        llvm::raw_string_ostream SS(S);
-        SS << i;
-        fns[SS.str()] = &TranslateFunction::handleBarrierInvariant;
-      }
-      for (unsigned i = 0; i <= BARRIER_INVARIANT_MAX_ARITY; ++i) {
-        std::string S = "__barrier_invariant_binary_";
-        llvm::raw_string_ostream SS(S);
-        SS << i;
-        fns[SS.str()] = &TranslateFunction::handleBarrierInvariantBinary;
-      }
-    }
-
-    if (SL == TranslateModule::SL_OpenCL) {
-      fns["get_local_id"] = &TranslateFunction::handleGetLocalId;
-      fns["get_group_id"] = &TranslateFunction::handleGetGroupId;
-      fns["get_local_size"] = &TranslateFunction::handleGetLocalSize;
-      fns["get_num_groups"] = &TranslateFunction::handleGetNumGroups;
-      fns["get_global_offset"] = &TranslateFunction::handleGetGlobalOffset;
-      fns["get_work_dim"] = &TranslateFunction::handleGetWorkDim;
-      fns["get_image_width"] = &TranslateFunction::handleGetImageWidth;
-      fns["get_image_height"] = &TranslateFunction::handleGetImageHeight;
-      fns["__translate_sampler_initializer"] = &TranslateFunction::handleSamplerInitializer;
-      {
-        const std::string types[] = {"char", "uchar", "short", "ushort", "int",
-                                     "uint", "long", "ulong", "float", "double",
-                                     ""};
-        for (unsigned i = 0; types[i] != ""; ++i) {
-          for (unsigned width = 1; width <= 16; width *= 2) {
-            std::string S;
-            llvm::raw_string_ostream SS(S);
-            if (width > 1) {
-              SS << width;
-            }
-            fns["__bugle_async_work_group_copy_global_to_local_" + types[i] +
-                SS.str()] = &TranslateFunction::handleAsyncWorkGroupCopy;
-            fns["__bugle_async_work_group_copy_local_to_global_" + types[i] +
-                SS.str()] = &TranslateFunction::handleAsyncWorkGroupCopy;
-          }
-        }
-      }
-      fns["__bugle_wait_group_events"] = &TranslateFunction::handleWaitGroupEvents;
-    }
-
-    if (SL == TranslateModule::SL_CUDA) {
-      fns["cos"] = &TranslateFunction::handleCos;
-      fns["sin"] = &TranslateFunction::handleSin;
-      fns["sqrt"] = &TranslateFunction::handleSqrt;
-      fns["sqrtf"] = &TranslateFunction::handleSqrt;
-      fns["rsqrt"] = &TranslateFunction::handleRsqrt;
-      fns["log2"] = &TranslateFunction::handleLog2;
-      fns["exp2"] = &TranslateFunction::handleExp;
-      fns["__clz"] = &TranslateFunction::handleCtlz;
-    }
-
-    auto &ints = SpecialFunctionMap.Intrinsics;
-    ints[Intrinsic::ceil] = &TranslateFunction::handleCeil;
-    ints[Intrinsic::ctpop] = &TranslateFunction::handleCtpop;
-    ints[Intrinsic::cos] = &TranslateFunction::handleCos;
-    ints[Intrinsic::ctlz] = &TranslateFunction::handleCtlz;
-    ints[Intrinsic::exp] = &TranslateFunction::handleExp;
-    ints[Intrinsic::exp2] = &TranslateFunction::handleExp2;
-    ints[Intrinsic::fabs] = &TranslateFunction::handleFabs;
-    ints[Intrinsic::fma] = &TranslateFunction::handleFma;
-    ints[Intrinsic::fmuladd] = &TranslateFunction::handleFma;
-    ints[Intrinsic::floor] = &TranslateFunction::handleFloor;
-    ints[Intrinsic::log] = &TranslateFunction::handleLog;
-    ints[Intrinsic::log10] = &TranslateFunction::handleLog10;
-    ints[Intrinsic::log2] = &TranslateFunction::handleLog2;
-    ints[Intrinsic::maxnum] = &TranslateFunction::handleFmax;
-    ints[Intrinsic::minnum] = &TranslateFunction::handleFmin;
-    ints[Intrinsic::pow] = &TranslateFunction::handlePow;
-    ints[Intrinsic::powi] = &TranslateFunction::handlePowi;
-    ints[Intrinsic::rint] = &TranslateFunction::handleRint;
-    ints[Intrinsic::sin] = &TranslateFunction::handleSin;
-    ints[Intrinsic::sqrt] = &TranslateFunction::handleSqrt;
-    ints[Intrinsic::trunc] = &TranslateFunction::handleTrunc;
-    ints[Intrinsic::uadd_with_overflow] = &TranslateFunction::handleUaddOvl;
-    ints[Intrinsic::sadd_with_overflow] = &TranslateFunction::handleSaddOvl;
-    ints[Intrinsic::usub_with_overflow] = &TranslateFunction::handleUsubOvl;
-    ints[Intrinsic::ssub_with_overflow] = &TranslateFunction::handleSsubOvl;
-    ints[Intrinsic::dbg_value] = &TranslateFunction::handleNoop;
-    ints[Intrinsic::dbg_declare] = &TranslateFunction::handleNoop;
-    ints[Intrinsic::memset] = &TranslateFunction::handleMemset;
-    ints[Intrinsic::memcpy] = &TranslateFunction::handleMemcpy;
-    ints[Intrinsic::trap] = &TranslateFunction::handleTrap;
-    ints[Intrinsic::lifetime_start] = &TranslateFunction::handleNoop;
-    ints[Intrinsic::lifetime_end] = &TranslateFunction::handleNoop;
+TranslateFunction::SpecialFnHandler TranslateFunction::*
+TranslateFunction::getIntrinsicHandler(unsigned ID) {
+  switch (ID) {
+  case Intrinsic::bitreverse:
+    return &TranslateFunction::handleBitreverse;
+  case Intrinsic::bswap:
+    return &TranslateFunction::handleBswap;
+  case Intrinsic::ceil:
+    return &TranslateFunction::handleCeil;
+  case Intrinsic::ctpop:
+    return &TranslateFunction::handleCtpop;
+  case Intrinsic::cos:
+    return &TranslateFunction::handleCos;
+  case Intrinsic::ctlz:
+    return &TranslateFunction::handleCtlz;
+  case Intrinsic::exp:
+    return &TranslateFunction::handleExp;
+  case Intrinsic::exp2:
+    return &TranslateFunction::handleExp2;
+  case Intrinsic::fabs:
+    return &TranslateFunction::handleFabs;
+  case Intrinsic::fma:
+    return &TranslateFunction::handleFma;
+  case Intrinsic::fmuladd:
+    return &TranslateFunction::handleFma;
+  case Intrinsic::floor:
+    return &TranslateFunction::handleFloor;
+  case Intrinsic::log:
+    return &TranslateFunction::handleLog;
+  case Intrinsic::log10:
+    return &TranslateFunction::handleLog10;
+  case Intrinsic::log2:
+    return &TranslateFunction::handleLog2;
+  case Intrinsic::maxnum:
+    return &TranslateFunction::handleFmax;
+  case Intrinsic::minnum:
+    return &TranslateFunction::handleFmin;
+  case Intrinsic::pow:
+    return &TranslateFunction::handlePow;
+  case Intrinsic::powi:
+    return &TranslateFunction::handlePowi;
+  case Intrinsic::rint:
+    return &TranslateFunction::handleRint;
+  case Intrinsic::sin:
+    return &TranslateFunction::handleSin;
+  case Intrinsic::sqrt:
+    return &TranslateFunction::handleSqrt;
+  case Intrinsic::trunc:
+    return &TranslateFunction::handleTrunc;
+  case Intrinsic::uadd_with_overflow:
+    return &TranslateFunction::handleUaddOvl;
+  case Intrinsic::sadd_with_overflow:
+    return &TranslateFunction::handleSaddOvl;
+  case Intrinsic::usub_with_overflow:
+    return &TranslateFunction::handleUsubOvl;
+  case Intrinsic::umul_with_overflow:
+    return &TranslateFunction::handleUmulOvl;
+  case Intrinsic::ssub_with_overflow:
+    return &TranslateFunction::handleSsubOvl;
+  case Intrinsic::dbg_value:
+    return &TranslateFunction::handleNoop;
+  case Intrinsic::dbg_declare:
+    return &TranslateFunction::handleNoop;
+  case Intrinsic::memset:
+    return &TranslateFunction::handleMemset;
+  case Intrinsic::memcpy:
+    return &TranslateFunction::handleMemcpy;
+  case Intrinsic::trap:
+    return &TranslateFunction::handleTrap;
+  case Intrinsic::lifetime_start:
+    return &TranslateFunction::handleNoop;
+  case Intrinsic::lifetime_end:
+    return &TranslateFunction::handleNoop;
+  default:
+    return nullptr;
   }
-  return SpecialFunctionMap;
 }
 
 void TranslateFunction::specifyZeroDimensions(unsigned PtrArgs) {
@@ -546,21 +280,30 @@ void TranslateFunction::createStructArrays() {
 }
 
 void TranslateFunction::translate() {
-  if (isGPUEntryPoint || isStandardEntryPoint(TM->SL, F->getName()))
+  auto Kind = TM->FC.getKind(F);
+  if (isGPUEntryPoint || Kind == FunctionClassifier::FK_StandardEntryPoint)
     BF->setEntryPoint(true);
 
   if (isGPUEntryPoint)
     BF->addAttribute("kernel");
 
-  if (isBarrierFunction(TM->SL, F->getName()))
+  if (Kind == FunctionClassifier::FK_Barrier)
     BF->addAttribute("barrier");
 
-  if (isGridBarrierFunction(TM->SL, F->getName()))
+  if (Kind == FunctionClassifier::FK_GridBarrier)
     BF->addAttribute("grid_barrier");
 
-  if (isSpecificationFunction(F->getName()))
+  if (Kind == FunctionClassifier::FK_Specification)
     BF->setSpecification(true);
 
+  ArgValueSpec *ArgValues = nullptr;
+  if (isGPUEntryPoint) {
+    auto i = TM->GPUArgValues.find(F->getName().str());
+    if (i != TM->GPUArgValues.end())
+      ArgValues = &i->second;
+  }
+  std::set<std::string> BoundArgs;
+
   unsigned PtrSize = TM->TD.getPointerSizeInBits();
   unsigned PtrArgs = 0;
   for (auto &Arg : F->args()) {
@@ -573,12 +316,36 @@ void TranslateFunction::translate() {
       ValueExprMap[&Arg] = PointerExpr::create(
           GlobalArrayRefExpr::create(GA), BVConstExpr::createZero(PtrSize));
     } else {
-      Var *V = BF->addArgument(TM->getModelledType(&Arg),
-                               TranslateModule::getSourceName(&Arg, F));
+      std::string Name = TranslateModule::getSourceName(&Arg, F);
+      Var *V = BF->addArgument(TM->getModelledType(&Arg), Name);
       ValueExprMap[&Arg] = TM->unmodelValue(&Arg, VarRefExpr::create(V));
+
+      // A scalar argument bound to a value on the command line is translated
+      // as that constant. The parameter is kept, with a precondition, so
+      // that the procedure signature does not depend on the bindings.
+      if (ArgValues && ArgValues->count(Name)) {
+        if (!Arg.getType()->isIntegerTy())
+          ErrorReporter::reportParameterError(
+              "Cannot bind non-integer argument " + Name + " of " +
+              F->getName().str());
+        ref<Expr> Val =
+            BVConstExpr::create(Arg.getType()->getIntegerBitWidth(),
+                                (*ArgValues)[Name], /*isSigned=*/true);
+        BF->addRequires(EqExpr::create(ValueExprMap[&Arg], Val), nullptr);
+        ValueExprMap[&Arg] = Val;
+        BoundArgs.insert(Name);
+      }
     }
   }
 
+  if (ArgValues) {
+    for (auto &AV : *ArgValues)
+      if (BoundArgs.find(AV.first) == BoundArgs.end())
+        ErrorReporter::reportParameterError("No scalar argument named " +
+                                            AV.first + " in " +
+                                            F->getName().str());
+  }
+
   if (isGPUEntryPoint)
     createStructArrays();
 
@@ -597,12 +364,19 @@ void TranslateFunction::translate() {
     BasicBlockMap[&BB] = BF->addBasicBlock(BB.getName());
   }
 
+  if (!F->isDeclaration())
+    UA.reset(new UniformityAnalysis(F, TM->SL, isGPUEntryPoint,
+                                    TM->AddressSpaces.constant));
+
   for (auto *BBB : BBList) {
     Stmt *AS = AssertStmt::createBlockSourceLoc(extractSourceLocsForBlock(BBB));
     BasicBlockMap[BBB]->addStmt(AS);
     translateBasicBlock(BasicBlockMap[BBB], BBB);
   }
 
+  if (UA && isGPUEntryPoint)
+    addControlFlowUniformity();
+
   // If we're modelling everything as a byte array, don't bother to compute
   // value models.
   if (TM->ModelAllAsByteArray)
@@ -635,7 +409,8 @@ void TranslateFunction::computeClosure(std::vector<PhiPair> &currentAssigns,
     while (isa<GetElementPtrInst>(operand))
       operand = cast<GetElementPtrInst>(operand)->getPointerOperand();
 
-    if (auto PN = dyn_cast<PHINode>(operand)) {
+    auto PN = dyn_cast<PHINode>(operand);
+    if (PN && !PN->hasConstantValue()) {
       if (foundPhiNodes.find(PN) == foundPhiNodes.end()) {
         foundPhiNodes.insert(PN);
         computeClosure(PhiAssignsMap[PN], foundPhiNodes, assigns);
@@ -684,12 +459,51 @@ Var *TranslateFunction::getPhiVariable(llvm::PHINode *PN) {
   return V;
 }
 
+AssumeStmt *TranslateFunction::createPartition(ref<Expr> Pred,
+                                               llvm::Value *Cond) {
+  auto U = UA->getUniformity(Cond);
+  return AssumeStmt::createPartition(Pred,
+                                     U != UniformityAnalysis::Divergent,
+                                     U == UniformityAnalysis::Uniform);
+}
+
+// Mark kernels whose branches are all uniform, so that their control flow
+// need not be predicated. The branches of other procedures may depend on
+// arguments which differ between the threads calling them.
+void TranslateFunction::addControlFlowUniformity() {
+  bool HasBranches = false;
+  auto U = UniformityAnalysis::Uniform;
+  for (auto &BB : *F) {
+    llvm::Value *Cond = nullptr;
+    if (auto *BI = dyn_cast<BranchInst>(BB.getTerminator())) {
+      if (BI->isConditional())
+        Cond = BI->getCondition();
+    } else if (auto *SI = dyn_cast<SwitchInst>(BB.getTerminator())) {
+      Cond = SI->getCondition();
+    }
+    if (Cond) {
+      HasBranches = true;
+      U = std::max(U, UA->getUniformity(Cond));
+    }
+  }
+
+  if (!HasBranches || U == UniformityAnalysis::Divergent)
+    return;
+  BF->addAttribute(U == UniformityAnalysis::Uniform
+                       ? "uniform_control_flow"
+                       : "group_uniform_control_flow");
+}
+
 void TranslateFunction::addPhiAssigns(bugle::BasicBlock *BBB,
                                       llvm::BasicBlock *Pred,
                                       llvm::BasicBlock *Succ) {
   std::vector<Var *> Vars;
   ExprVec Exprs;
   for (auto &PN : Succ->phis()) {
+    // Phi nodes which merge a single value are translated as that value.
+    if (PN.hasConstantValue())
+      continue;
+
     int idx = PN.getBasicBlockIndex(Pred);
     assert(idx != -1 && "No phi index?");
 
@@ -1446,18 +1260,20 @@ ref<Expr> TranslateFunction::handleTrap(bugle::BasicBlock *BBB,
   return nullptr;
 }
 
-static std::string mkDimName(const std::string &prefix, ref<Expr> dim) {
+static unsigned mkDim(ref<Expr> dim) {
   auto CE = dyn_cast<BVConstExpr>(dim);
   if (!CE)
     ErrorReporter::reportImplementationLimitation(
         "Unsupported variable dimension");
-  switch (CE->getValue().getZExtValue()) {
-  case 0: return prefix + "_x";
-  case 1: return prefix + "_y";
-  case 2: return prefix + "_z";
-  default:
+  uint64_t d = CE->getValue().getZExtValue();
+  if (d > 2)
     ErrorReporter::reportImplementationLimitation("Unsupported dimension");
-  }
+  return d;
+}
+
+static std::string mkDimName(const std::string &prefix, ref<Expr> dim) {
+  static const char *const Suffixes[3] = {"_x", "_y", "_z"};
+  return prefix + Suffixes[mkDim(dim)];
 }
 
 static ref<Expr> mkLocalId(bugle::Type t, ref<Expr> dim) {
@@ -1468,18 +1284,6 @@ static ref<Expr> mkGroupId(bugle::Type t, ref<Expr> dim) {
   return SpecialVarRefExpr::create(t, mkDimName("group_id", dim));
 }
 
-static ref<Expr> mkLocalSize(bugle::Type t, ref<Expr> dim) {
-  return SpecialVarRefExpr::create(t, mkDimName("group_size", dim));
-}
-
-static ref<Expr> mkNumGroups(bugle::Type t, ref<Expr> dim) {
-  return SpecialVarRefExpr::create(t, mkDimName("num_groups", dim));
-}
-
-static ref<Expr> mkGlobalOffset(bugle::Type t, ref<Expr> dim) {
-  return SpecialVarRefExpr::create(t, mkDimName("global_offset", dim));
-}
-
 static ref<Expr> mkWorkDim(bugle::Type t) {
   return SpecialVarRefExpr::create(t, "work_dim");
 }
@@ -1502,27 +1306,32 @@ ref<Expr> TranslateFunction::handleGetLocalSize(bugle::BasicBlock *BBB,
                                                 llvm::CallInst *CI,
                                                 const ExprVec &Args) {
   Type t = TM->translateType(CI->getType());
-  return mkLocalSize(t, Args[0]);
+  return TM->translateLaunchDim(t, "group_size", TM->Launch.LocalSize,
+                                mkDim(Args[0]));
 }
 
 ref<Expr> TranslateFunction::handleGetNumGroups(bugle::BasicBlock *BBB,
                                                 llvm::CallInst *CI,
                                                 const ExprVec &Args) {
   Type t = TM->translateType(CI->getType());
-  return mkNumGroups(t, Args[0]);
+  return TM->translateLaunchDim(t, "num_groups", TM->Launch.NumGroups,
+                                mkDim(Args[0]));
 }
 
 ref<Expr> TranslateFunction::handleGetGlobalOffset(bugle::BasicBlock *BBB,
                                                    llvm::CallInst *CI,
                                                    const ExprVec &Args) {
   Type t = TM->translateType(CI->getType());
-  return mkGlobalOffset(t, Args[0]);
+  return TM->translateLaunchDim(t, "global_offset", TM->Launch.GlobalOffset,
+                                mkDim(Args[0]));
 }
 
 ref<Expr> TranslateFunction::handleGetWorkDim(bugle::BasicBlock *BBB,
                                               llvm::CallInst *CI,
                                               const ExprVec &Args) {
   Type t = TM->translateType(CI->getType());
+  if (TM->Launch.WorkDim.first)
+    return BVConstExpr::create(t.width, TM->Launch.WorkDim.second);
   return mkWorkDim(t);
 }
 
@@ -1664,6 +1473,34 @@ ref<Expr> TranslateFunction::handleWaitGroupEvents(bugle::BasicBlock *BBB,
   return nullptr;
 }
 
+// Reverse the order of the pieces of the given width of which E consists.
+static ref<Expr> reverseBVPieces(ref<Expr> E, unsigned PieceWidth) {
+  unsigned Width = E->getType().width;
+  ref<Expr> Result = BVExtractExpr::create(E, 0, PieceWidth);
+  for (unsigned i = PieceWidth; i < Width; i += PieceWidth)
+    Result = BVConcatExpr::create(Result,
+                                  BVExtractExpr::create(E, i, PieceWidth));
+  return Result;
+}
+
+ref<Expr> TranslateFunction::handleBitreverse(bugle::BasicBlock *BBB,
+                                              llvm::CallInst *CI,
+                                              const ExprVec &Args) {
+  llvm::Type *Ty = CI->getType();
+  return maybeTranslateSIMDInst(
+      BBB, Ty, Ty, Args[0],
+      [&](llvm::Type *T, ref<Expr> E) { return reverseBVPieces(E, 1); });
+}
+
+ref<Expr> TranslateFunction::handleBswap(bugle::BasicBlock *BBB,
+                                         llvm::CallInst *CI,
+                                         const ExprVec &Args) {
+  llvm::Type *Ty = CI->getType();
+  return maybeTranslateSIMDInst(
+      BBB, Ty, Ty, Args[0],
+      [&](llvm::Type *T, ref<Expr> E) { return reverseBVPieces(E, 8); });
+}
+
 ref<Expr> TranslateFunction::handleCeil(bugle::BasicBlock *BBB,
                                         llvm::CallInst *CI,
                                         const ExprVec &Args) {
@@ -1998,6 +1835,38 @@ ref<Expr> TranslateFunction::handleUsubOvl(bugle::BasicBlock *BBB,
   return BVConcatExpr::create(OvlResult, SubResult);
 }
 
+ref<Expr> TranslateFunction::handleUmulOvl(bugle::BasicBlock *BBB,
+                                           llvm::CallInst *CI,
+                                           const ExprVec &Args) {
+  llvm::StructType *STy = cast<StructType>(CI->getType());
+  llvm::Type *MulTy = STy->getElementType(0), *OvlTy = STy->getElementType(1);
+  unsigned BitWidth = cast<IntegerType>(MulTy)->getBitWidth();
+
+  ref<Expr> MulExpr =
+                BVMulExpr::create(BVZExtExpr::create(BitWidth * 2, Args[0]),
+                                  BVZExtExpr::create(BitWidth * 2, Args[1])),
+            MulResult = BVExtractExpr::create(MulExpr, 0, BitWidth);
+
+  // Overflow if any of the most significant half of the bits is non-zero.
+  ref<Expr> OvlResult = BoolToBVExpr::create(
+      NeExpr::create(BVExtractExpr::create(MulExpr, BitWidth, BitWidth),
+                     BVConstExpr::createZero(BitWidth)));
+
+  if (TM->TD.getTypeAllocSize(MulTy) * 8 != BitWidth) {
+    ref<Expr> Pad =
+        BVConstExpr::createZero(TM->TD.getTypeAllocSize(MulTy) * 8 - BitWidth);
+    MulResult = BVConcatExpr::create(Pad, MulResult);
+  }
+
+  assert(cast<IntegerType>(OvlTy)->getBitWidth() == 1);
+  assert(TM->TD.getTypeAllocSize(OvlTy) > 0);
+  ref<Expr> Pad =
+      BVConstExpr::createZero(TM->TD.getTypeAllocSize(OvlTy) * 8 - 1);
+  OvlResult = BVConcatExpr::create(Pad, OvlResult);
+
+  return BVConcatExpr::create(OvlResult, MulResult);
+}
+
 ref<Expr> TranslateFunction::handleAddNoovflUnsigned(bugle::BasicBlock *BBB,
                                                      llvm::CallInst *CI,
                                                      const ExprVec &Args) {
@@ -2107,6 +1976,83 @@ ref<Expr> TranslateFunction::maybeTranslateSIMDInst(
   return Expr::createBVConcatN(Elems);
 }
 
+typedef std::pair<APInt, APInt> CaseRange;
+
+// Group the case values into maximal ranges of contiguous values, in
+// ascending signed order. Signed order is used as the mathematical integer
+// representation prints constants and compares values as signed integers.
+static std::vector<CaseRange> getCaseRanges(std::vector<APInt> Values) {
+  std::sort(Values.begin(), Values.end(),
+            [](const APInt &A, const APInt &B) { return A.slt(B); });
+  std::vector<CaseRange> Ranges;
+  for (const auto &V : Values) {
+    if (!Ranges.empty() && !Ranges.back().second.isMaxSignedValue() &&
+        Ranges.back().second + 1 == V)
+      Ranges.back().second = V;
+    else
+      Ranges.push_back(std::make_pair(V, V));
+  }
+  return Ranges;
+}
+
+// The ranges of the values of the given width which are in none of the
+// given ranges, which must be as returned by getCaseRanges.
+static std::vector<CaseRange>
+getComplementRanges(const std::vector<CaseRange> &Ranges, unsigned Width) {
+  std::vector<CaseRange> Complement;
+  APInt Next = APInt::getSignedMinValue(Width);
+  bool Done = false;
+  for (const auto &R : Ranges) {
+    if (R.first != Next)
+      Complement.push_back(std::make_pair(Next, R.first - 1));
+    if (R.second.isMaxSignedValue()) {
+      Done = true;
+      break;
+    }
+    Next = R.second + 1;
+  }
+  if (!Done)
+    Complement.push_back(
+        std::make_pair(Next, APInt::getSignedMaxValue(Width)));
+  return Complement;
+}
+
+static ref<Expr> createBalancedOr(const std::vector<ref<Expr>> &Preds,
+                                  unsigned Begin, unsigned End) {
+  if (Begin == End)
+    return BoolConstExpr::create(false);
+  if (End - Begin == 1)
+    return Preds[Begin];
+  unsigned Mid = Begin + (End - Begin) / 2;
+  return OrExpr::create(createBalancedOr(Preds, Begin, Mid),
+                        createBalancedOr(Preds, Mid, End));
+}
+
+// Whether Val lies in one of the ranges. The disjunction is balanced, so that
+// switches with many cases do not give deeply nested guards. Ranges reaching
+// the smallest or largest signed value are left open at that end, so that the
+// checks also partition values outside the bit-vector range when integers
+// are represented mathematically.
+static ref<Expr> createRangesCheck(ref<Expr> Val,
+                                   const std::vector<CaseRange> &Ranges) {
+  std::vector<ref<Expr>> Preds;
+  for (const auto &R : Ranges) {
+    bool Open = R.first.isMinSignedValue() || R.second.isMaxSignedValue();
+    if (R.first == R.second && !Open) {
+      Preds.push_back(EqExpr::create(Val, BVConstExpr::create(R.first)));
+      continue;
+    }
+    ref<Expr> Pred = BoolConstExpr::create(true);
+    if (!R.first.isMinSignedValue())
+      Pred = BVSgeExpr::create(Val, BVConstExpr::create(R.first));
+    if (!R.second.isMaxSignedValue())
+      Pred = AndExpr::create(
+          Pred, BVSleExpr::create(Val, BVConstExpr::create(R.second)));
+    Preds.push_back(Pred);
+  }
+  return createBalancedOr(Preds, 0, Preds.size());
+}
+
 void TranslateFunction::translateInstruction(bugle::BasicBlock *BBB,
                                              Instruction *I) {
   SourceLocsRef SLI = extractSourceLocs(I);
@@ -2141,7 +2087,10 @@ void TranslateFunction::translateInstruction(bugle::BasicBlock *BBB,
       ErrorReporter::reportImplementationLimitation(
           "Unsupported binary operator");
     }
-    E = maybeTranslateSIMDInst(BBB, BO->getType(), BO->getType(), LHS, RHS, F);
+    E = maybeTranslateSIMDInst(BBB, BO->getType(), BO->getType(), LHS, RHS,
+                               [&](ref<Expr> LHS, ref<Expr> RHS) {
+      return TM->narrowBitWidth(F(LHS, RHS));
+    });
   } else if (auto *GEPI = dyn_cast<GetElementPtrInst>(I)) {
     ref<Expr> Ptr = translateValue(GEPI->getPointerOperand(), BBB);
     E = TM->translateGEP(Ptr, klee::gep_type_begin(GEPI),
@@ -2499,9 +2448,8 @@ void TranslateFunction::translateInstruction(bugle::BasicBlock *BBB,
 
     if (auto *II = dyn_cast<IntrinsicInst>(CI)) {
       auto ID = II->getIntrinsicID();
-      auto SFII = SpecialFunctionMap.Intrinsics.find(ID);
-      if (SFII != SpecialFunctionMap.Intrinsics.end()) {
-        E = (this->*SFII->second)(BBB, CI, Args);
+      if (auto Handler = getIntrinsicHandler(ID)) {
+        E = (this->*Handler)(BBB, CI, Args);
         assert(E.isNull() == CI->getType()->isVoidTy());
         if (E.isNull())
           return;
@@ -2512,13 +2460,11 @@ void TranslateFunction::translateInstruction(bugle::BasicBlock *BBB,
       }
     } else {
       auto *F = CI->getCalledFunction();
-      auto SFI = SpecialFunctionMap.Functions.end();
-      if (F) {
-        SFI = SpecialFunctionMap.Functions.find(
-            trimForRequiresFreshArrayFunction(F->getName()));
-      }
-      if (SFI != SpecialFunctionMap.Functions.end()) {
-        E = (this->*SFI->second)(BBB, CI, Args);
+      SpecialFnHandler TranslateFunction::*Handler = nullptr;
+      if (F)
+        Handler = getSpecialFunctionHandler(TM->SL, F->getName());
+      if (Handler) {
+        E = (this->*Handler)(BBB, CI, Args);
         assert(E.isNull() == CI->getType()->isVoidTy());
         if (E.isNull())
           return;
@@ -2555,13 +2501,14 @@ void TranslateFunction::translateInstruction(bugle::BasicBlock *BBB,
       BBB->addEvalStmt(Cond, currentSourceLocs);
 
       bugle::BasicBlock *TrueBB = BF->addBasicBlock("truebb");
-      TrueBB->addStmt(AssumeStmt::createPartition(Cond));
+      TrueBB->addStmt(createPartition(Cond, BI->getCondition()));
       TrueBB->addStmt(AssertStmt::createBlockSourceLoc(currentSourceLocs));
       addPhiAssigns(TrueBB, I->getParent(), BI->getSuccessor(0));
       TrueBB->addStmt(GotoStmt::create(BasicBlockMap[BI->getSuccessor(0)]));
 
       bugle::BasicBlock *FalseBB = BF->addBasicBlock("falsebb");
-      FalseBB->addStmt(AssumeStmt::createPartition(NotExpr::create(Cond)));
+      FalseBB->addStmt(
+          createPartition(NotExpr::create(Cond), BI->getCondition()));
       FalseBB->addStmt(AssertStmt::createBlockSourceLoc(currentSourceLocs));
       addPhiAssigns(FalseBB, I->getParent(), BI->getSuccessor(1));
       FalseBB->addStmt(GotoStmt::create(BasicBlockMap[BI->getSuccessor(1)]));
@@ -2577,34 +2524,62 @@ void TranslateFunction::translateInstruction(bugle::BasicBlock *BBB,
     return;
   } else if (auto *SI = dyn_cast<SwitchInst>(I)) {
     ref<Expr> Cond = translateValue(SI->getCondition(), BBB);
-    ref<Expr> DefaultExpr = BoolConstExpr::create(true);
-    std::vector<bugle::BasicBlock *> Succs;
-
+    llvm::BasicBlock *DefaultSucc = SI->case_default()->getCaseSuccessor();
+
+    // The cases which branch to the same block share a block, guarded by the
+    // ranges of contiguous values which lead there. The default block is
+    // guarded by the ranges of values which lead to no other block.
+    std::vector<llvm::BasicBlock *> CaseSuccs;
+    std::map<llvm::BasicBlock *, std::vector<APInt>> SuccValues;
+    std::vector<APInt> CaseValues;
     for (auto &Case : SI->cases()) {
-      ref<Expr> Val = TM->translateConstant(Case.getCaseValue());
-      bugle::BasicBlock *BB = BF->addBasicBlock("casebb");
+      llvm::BasicBlock *Succ = Case.getCaseSuccessor();
+      if (Succ == DefaultSucc)
+        continue;
+      const APInt &Val = Case.getCaseValue()->getValue();
+      auto &Values = SuccValues[Succ];
+      if (Values.empty())
+        CaseSuccs.push_back(Succ);
+      Values.push_back(Val);
+      CaseValues.push_back(Val);
+    }
+
+    if (CaseSuccs.empty()) {
+      addPhiAssigns(BBB, SI->getParent(), DefaultSucc);
+      BBB->addStmt(GotoStmt::create(BasicBlockMap[DefaultSucc]));
+      return;
+    }
+
+    std::vector<bugle::BasicBlock *> Succs;
+    auto AddCaseBlock = [&](const std::string &Name, ref<Expr> Guard,
+                            llvm::BasicBlock *Succ) {
+      bugle::BasicBlock *BB = BF->addBasicBlock(Name);
       Succs.push_back(BB);
-      BB->addStmt(AssumeStmt::createPartition(EqExpr::create(Cond, Val)));
+      BB->addStmt(createPartition(Guard, SI->getCondition()));
       BB->addStmt(AssertStmt::createBlockSourceLoc(currentSourceLocs));
-      addPhiAssigns(BB, SI->getParent(), Case.getCaseSuccessor());
-      BB->addStmt(GotoStmt::create(BasicBlockMap[Case.getCaseSuccessor()]));
-      DefaultExpr = AndExpr::create(DefaultExpr, NeExpr::create(Cond, Val));
-    }
+      addPhiAssigns(BB, SI->getParent(), Succ);
+      BB->addStmt(GotoStmt::create(BasicBlockMap[Succ]));
+    };
+
+    for (auto *Succ : CaseSuccs)
+      AddCaseBlock("casebb",
+                   createRangesCheck(Cond, getCaseRanges(SuccValues[Succ])),
+                   Succ);
 
-    bugle::BasicBlock *DefaultBB = BF->addBasicBlock("defaultbb");
-    Succs.push_back(DefaultBB);
-    DefaultBB->addStmt(AssertStmt::createBlockSourceLoc(currentSourceLocs));
-    DefaultBB->addStmt(AssumeStmt::createPartition(DefaultExpr));
-    addPhiAssigns(DefaultBB, SI->getParent(),
-                  SI->case_default()->getCaseSuccessor());
-    DefaultBB->addStmt(GotoStmt::create(
-        BasicBlockMap[SI->case_default()->getCaseSuccessor()]));
+    auto DefaultRanges = getComplementRanges(getCaseRanges(CaseValues),
+                                             Cond->getType().width);
+    if (!DefaultRanges.empty())
+      AddCaseBlock("defaultbb", createRangesCheck(Cond, DefaultRanges),
+                   DefaultSucc);
 
     BBB->addStmt(GotoStmt::create(Succs));
     return;
   } else if (auto *PN = dyn_cast<PHINode>(I)) {
-    ValueExprMap[I] =
-        TM->unmodelValue(PN, VarRefExpr::create(getPhiVariable(PN)));
+    if (auto *V = PN->hasConstantValue())
+      ValueExprMap[I] = translateValue(V, BBB);
+    else
+      ValueExprMap[I] =
+          TM->unmodelValue(PN, VarRefExpr::create(getPhiVariable(PN)));
     return;
   } else if (isa<UnreachableInst>(I)) {
     BBB->addStmt(
@@ -1,10 +1,13 @@
 #include "bugle/Translator/TranslateModule.h"
+#include "bugle/Translator/FunctionClassifier.h"
 #include "bugle/Translator/TranslateFunction.h"
 #include "bugle/Expr.h"
 #include "bugle/Function.h"
 #include "bugle/Module.h"
 #include "bugle/Stmt.h"
 #include "bugle/util/ErrorReporter.h"
+#include "bugle/util/Profiler.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/BinaryFormat/Dwarf.h"
 #include "llvm/IR/Constant.h"
 #include "llvm/IR/Constants.h"
@@ -108,15 +111,46 @@ ref<Expr> TranslateModule::translate1dCUDABuiltinGlobal(std::string Prefix,
   return ConstantArrayRefExpr::create(Arr);
 }
 
-ref<Expr> TranslateModule::translate3dCUDABuiltinGlobal(std::string Prefix,
-                                                        GlobalVariable *GV) {
+ref<Expr> TranslateModule::translate3dCUDABuiltinGlobal(
+    std::string Prefix, GlobalVariable *GV, const LaunchDims &Known) {
   Type ty = translateArrayRangeType(GV->getType()->getElementType());
-  ref<Expr> Arr[3] = {SpecialVarRefExpr::create(ty, Prefix + "_x"),
-                      SpecialVarRefExpr::create(ty, Prefix + "_y"),
-                      SpecialVarRefExpr::create(ty, Prefix + "_z")};
+  ref<Expr> Arr[3] = {translateLaunchDim(ty, Prefix, Known, 0),
+                      translateLaunchDim(ty, Prefix, Known, 1),
+                      translateLaunchDim(ty, Prefix, Known, 2)};
   return ConstantArrayRefExpr::create(Arr);
 }
 
+ref<Expr> TranslateModule::translateLaunchDim(Type T,
+                                              const std::string &Prefix,
+                                              const LaunchDims &Known,
+                                              unsigned Dim) {
+  static const char *const Suffixes[3] = {"_x", "_y", "_z"};
+  if (Dim < Known.size() && Known[Dim].first)
+    return BVConstExpr::create(T.width, Known[Dim].second);
+  return SpecialVarRefExpr::create(T, Prefix + Suffixes[Dim]);
+}
+
+// The ids of the threads and groups of a launch are below its known sizes.
+void TranslateModule::addLaunchBounds() {
+  static const char *const Suffixes[3] = {"_x", "_y", "_z"};
+  for (unsigned Dim = 0; Dim != 3; ++Dim) {
+    if (Dim < Launch.LocalSize.size() && Launch.LocalSize[Dim].first &&
+        Launch.LocalSize[Dim].second != 0)
+      Narrower.addSpecialVarBound(std::string("local_id") + Suffixes[Dim],
+                                  Launch.LocalSize[Dim].second - 1);
+    if (Dim < Launch.NumGroups.size() && Launch.NumGroups[Dim].first &&
+        Launch.NumGroups[Dim].second != 0)
+      Narrower.addSpecialVarBound(std::string("group_id") + Suffixes[Dim],
+                                  Launch.NumGroups[Dim].second - 1);
+  }
+}
+
+ref<Expr> TranslateModule::narrowBitWidth(ref<Expr> E) {
+  if (!NarrowBitWidths)
+    return E;
+  return Narrower.narrow(E);
+}
+
 bool TranslateModule::hasInitializer(GlobalVariable *GV) {
   if (!GV->hasInitializer())
     return false;
@@ -139,11 +173,11 @@ bool TranslateModule::hasInitializer(GlobalVariable *GV) {
 ref<Expr> TranslateModule::translateGlobalVariable(GlobalVariable *GV) {
   if (SL == SL_CUDA) {
     if (GV->getName() == "gridDim")
-      return translate3dCUDABuiltinGlobal("num_groups", GV);
+      return translate3dCUDABuiltinGlobal("num_groups", GV, Launch.NumGroups);
     else if (GV->getName() == "blockIdx")
       return translate3dCUDABuiltinGlobal("group_id", GV);
     else if (GV->getName() == "blockDim")
-      return translate3dCUDABuiltinGlobal("group_size", GV);
+      return translate3dCUDABuiltinGlobal("group_size", GV, Launch.LocalSize);
     else if (GV->getName() == "threadIdx")
       return translate3dCUDABuiltinGlobal("local_id", GV);
     else if (GV->getName() == "warpSize")
@@ -517,16 +551,16 @@ TranslateModule::translateGEP(ref<Expr> Ptr, klee::gep_type_iterator begin,
       Value *Operand = i.getOperand();
       ref<Expr> Index = xlate(Operand);
       Index = BVZExtExpr::create(BM->getPointerWidth(), Index);
-      ref<Expr> Addend = BVMulExpr::create(
-          Index, BVConstExpr::create(BM->getPointerWidth(), ElementSize));
+      ref<Expr> Addend = narrowBitWidth(BVMulExpr::create(
+          Index, BVConstExpr::create(BM->getPointerWidth(), ElementSize)));
       PtrOfs = BVAddExpr::create(PtrOfs, Addend);
     } else if (auto *PT = dyn_cast<PointerType>(*i)) {
       uint64_t ElementSize = TD.getTypeAllocSize(PT->getElementType());
       Value *Operand = i.getOperand();
       ref<Expr> Index = xlate(Operand);
       Index = BVZExtExpr::create(BM->getPointerWidth(), Index);
-      ref<Expr> Addend = BVMulExpr::create(
-          Index, BVConstExpr::create(BM->getPointerWidth(), ElementSize));
+      ref<Expr> Addend = narrowBitWidth(BVMulExpr::create(
+          Index, BVConstExpr::create(BM->getPointerWidth(), ElementSize)));
       PtrOfs = BVAddExpr::create(PtrOfs, Addend);
     } else {
       ErrorReporter::reportImplementationLimitation("Unhandled GEP type");
@@ -628,32 +662,6 @@ ref<Expr> TranslateModule::translateBitCast(llvm::Type *SrcTy,
   }
 }
 
-bool TranslateModule::isGPUEntryPoint(llvm::Function *F, llvm::Module *M,
-                                      SourceLanguage SL,
-                                      std::set<std::string> &EPS) {
-  if (SL == SL_OpenCL || SL == SL_CUDA) {
-    if (auto *NMD = M->getNamedMetadata("nvvm.annotations")) {
-      for (auto *MD : NMD->operands()) {
-        if (MD->getOperand(0) == ValueAsMetadata::get(F))
-          for (unsigned i = 1, e = MD->getNumOperands(); i != e; i += 2)
-            if (cast<MDString>(MD->getOperand(i))->getString() == "kernel")
-              return true;
-      }
-    }
-  }
-
-  if (SL == SL_OpenCL) {
-    if (auto *NMD = M->getNamedMetadata("opencl.kernels")) {
-      for (auto *MD : NMD->operands()) {
-        if (MD->getOperand(0) == ValueAsMetadata::get(F))
-          return true;
-      }
-    }
-  }
-
-  return EPS.find(F->getName()) != EPS.end();
-}
-
 std::string TranslateModule::getSourceFunctionName(llvm::Function *F) {
   for (auto *S : DIF.subprograms()) {
     if (S->describes(F)) {
@@ -1005,7 +1013,13 @@ ref<Expr> TranslateModule::modelCallExpr(llvm::Type *T, llvm::Function *F,
 }
 
 void TranslateModule::translate() {
+  unsigned Round = 0;
   do {
+    ScopedPhase RoundPhase("round " + llvm::utostr(Round++), "round");
+    Profiler::addToCounter("translate.rounds");
+    size_t ByteArrayModels = ModelAsByteArray.size();
+    bool WasModelAllAsByteArray = NextModelAllAsByteArray;
+
     NeedAdditionalByteArrayModels = false;
     NeedAdditionalGlobalOffsetModels = false;
 
@@ -1021,13 +1035,11 @@ void TranslateModule::translate() {
     BM->setPointerWidth(TD.getPointerSizeInBits());
 
     for (auto &F : *M) {
-      if (TranslateFunction::isUninterpretedFunction(F.getName())) {
-        TranslateFunction::addUninterpretedFunction(SL, F.getName());
-      }
-
-      if (F.isIntrinsic() ||
-          TranslateFunction::isAxiomFunction(F.getName()) ||
-          TranslateFunction::isSpecialFunction(SL, F.getName()))
+      auto Kind = FC.getKind(&F);
+      if (Kind == FunctionClassifier::FK_Intrinsic ||
+          Kind == FunctionClassifier::FK_Axiom ||
+          Kind == FunctionClassifier::FK_Uninterpreted ||
+          Kind == FunctionClassifier::FK_Special)
         continue;
 
       auto BF = FunctionMap[&F] =
@@ -1039,10 +1051,11 @@ void TranslateModule::translate() {
     }
 
     for (auto &F : *M) {
-      if (F.isIntrinsic())
+      auto Kind = FC.getKind(&F);
+      if (Kind == FunctionClassifier::FK_Intrinsic)
         continue;
 
-      if (TranslateFunction::isAxiomFunction(F.getName())) {
+      if (Kind == FunctionClassifier::FK_Axiom) {
         bugle::Function BF("", "");
         Type RT = translateType(F.getFunctionType()->getReturnType());
         Var *RV = BF.addReturn(RT, "ret");
@@ -1053,13 +1066,20 @@ void TranslateModule::translate() {
         VarAssignStmt *S = cast<VarAssignStmt>(*(BBB->end() - 2));
         assert(S->getVars()[0] == RV); (void)RV;
         BM->addAxiom(Expr::createNeZero(S->getValues()[0]));
-      } else if (!TranslateFunction::isSpecialFunction(SL, F.getName())) {
-        bool EP = isGPUEntryPoint(&F, M, SL, GPUEntryPoints);
-        TranslateFunction TF(this, FunctionMap[&F], &F, EP);
+      } else if (Kind != FunctionClassifier::FK_Uninterpreted &&
+                 Kind != FunctionClassifier::FK_Special) {
+        ScopedPhase FunctionPhase(F.getName(), "function");
+        TranslateFunction TF(this, FunctionMap[&F], &F,
+                             Kind == FunctionClassifier::FK_Kernel);
         TF.translate();
       }
     }
 
+    Profiler::addToCounter("translate.byte-array-demotions",
+                           ModelAsByteArray.size() - ByteArrayModels);
+    if (!WasModelAllAsByteArray && NextModelAllAsByteArray)
+      Profiler::addToCounter("translate.model-all-as-byte-array");
+
     // If this round gave us a case split, examine each pointer argument to
     // each call site for each function to see if the argument always refers to
     // the same global array, in which case we can model the parameter as an
@@ -0,0 +1,231 @@
+#include "bugle/Translator/UniformityAnalysis.h"
+#include "bugle/Translator/TranslateFunction.h"
+#include "llvm/Analysis/PostDominators.h"
+#include "llvm/IR/CFG.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/Operator.h"
+#include <algorithm>
+
+using namespace llvm;
+using namespace bugle;
+
+UniformityAnalysis::UniformityAnalysis(llvm::Function *F,
+                                       TranslateModule::SourceLanguage SL,
+                                       bool IsKernel,
+                                       unsigned ConstantAddrSpace)
+    : F(F), SL(SL), IsKernel(IsKernel), ConstantAddrSpace(ConstantAddrSpace) {
+  analyse();
+}
+
+UniformityAnalysis::Uniformity
+UniformityAnalysis::getUniformity(llvm::Value *V) const {
+  if (isa<Argument>(V))
+    return IsKernel ? Uniform : Divergent;
+  if (isa<Instruction>(V)) {
+    auto i = Values.find(V);
+    return i == Values.end() ? Uniform : i->second;
+  }
+  return Uniform;
+}
+
+bool UniformityAnalysis::raise(llvm::Value *V, Uniformity U) {
+  Uniformity &Current = Values[V];
+  if (U <= Current)
+    return false;
+  Current = U;
+  return true;
+}
+
+UniformityAnalysis::Uniformity
+UniformityAnalysis::getOperandUniformity(Instruction *I) {
+  Uniformity U = Uniform;
+  for (auto &Op : I->operands())
+    U = std::max(U, getUniformity(Op));
+  return U;
+}
+
+UniformityAnalysis::Uniformity
+UniformityAnalysis::getCallUniformity(Instruction *I) {
+  auto *CI = cast<CallInst>(I);
+  auto *Callee = CI->getCalledFunction();
+  if (!Callee)
+    return Divergent;
+
+  Uniformity Args = Uniform;
+  for (unsigned i = 0, e = CI->getNumArgOperands(); i != e; ++i)
+    Args = std::max(Args, getUniformity(CI->getArgOperand(i)));
+
+  StringRef Name = Callee->getName();
+  if (SL == TranslateModule::SL_OpenCL) {
+    if (Name == "get_local_id")
+      return Divergent;
+    if (Name == "get_group_id")
+      return std::max(Args, GroupUniform);
+    if (Name == "get_local_size" || Name == "get_num_groups" ||
+        Name == "get_global_offset" || Name == "get_work_dim")
+      return Args;
+  }
+
+  StringRef SReg("llvm.nvvm.read.ptx.sreg.");
+  if (Name.startswith(SReg)) {
+    Name = Name.drop_front(SReg.size());
+    if (Name.startswith("ctaid"))
+      return GroupUniform;
+    if (Name.startswith("ntid") || Name.startswith("nctaid") ||
+        Name == "warpsize")
+      return Uniform;
+    return Divergent;
+  }
+
+  // Other functions which are handled by the translator may depend on the
+  // thread, as do __other_int and the atomics. Target-independent intrinsics
+  // which do not access memory compute their result from their arguments
+  // alone. Other functions may be declared not to access memory, but their
+  // bodies are translated as procedures which may still depend on the thread.
+  if (TranslateFunction::isSpecialFunction(SL, Name))
+    return Divergent;
+  if (Callee->isIntrinsic() && !Callee->isTargetIntrinsic() &&
+      Callee->doesNotAccessMemory())
+    return Args;
+
+  return Divergent;
+}
+
+UniformityAnalysis::Uniformity
+UniformityAnalysis::getLoadUniformity(llvm::Value *Ptr) {
+  Uniformity Address = getUniformity(Ptr);
+
+  llvm::Value *Base = Ptr;
+  while (true) {
+    Base = Base->stripPointerCasts();
+    if (auto *GEP = dyn_cast<GEPOperator>(Base))
+      Base = GEP->getPointerOperand();
+    else
+      break;
+  }
+
+  if (SL == TranslateModule::SL_CUDA) {
+    if (auto *GV = dyn_cast<GlobalVariable>(Base)) {
+      StringRef Name = GV->getName();
+      if (Name == "blockIdx")
+        return std::max(Address, GroupUniform);
+      if (Name == "blockDim" || Name == "gridDim" || Name == "warpSize")
+        return Address;
+    }
+  }
+
+  // Constant memory is not written by the kernel, so all threads loading
+  // from the same address see the same value.
+  if (Ptr->getType()->getPointerAddressSpace() == ConstantAddrSpace)
+    return Address;
+
+  return Divergent;
+}
+
+UniformityAnalysis::Uniformity
+UniformityAnalysis::computeUniformity(Instruction *I) {
+  if (auto *PN = dyn_cast<PHINode>(I)) {
+    Uniformity U = getOperandUniformity(PN);
+    auto i = JoinUniformity.find(PN->getParent());
+    if (i != JoinUniformity.end())
+      U = std::max(U, i->second);
+    return U;
+  }
+
+  if (isa<CallInst>(I)) {
+    if (isa<DbgInfoIntrinsic>(I))
+      return Uniform;
+    return getCallUniformity(I);
+  }
+
+  if (auto *LI = dyn_cast<LoadInst>(I))
+    return getLoadUniformity(LI->getPointerOperand());
+
+  if (isa<AtomicRMWInst>(I) || isa<AtomicCmpXchgInst>(I))
+    return Divergent;
+
+  return getOperandUniformity(I);
+}
+
+// The blocks reached from a branch before its immediate post-dominator form
+// the region it influences. Threads which disagree on the branch may reach
+// the post-dominator, or leave the region, along different paths, so the phi
+// nodes at the join points are as divergent as the branch. A value defined in
+// the region and used outside it, past a divergent loop exit, may also have
+// been computed in a different iteration by each thread.
+bool UniformityAnalysis::propagateBranch(llvm::BasicBlock *BB, Uniformity U,
+                                         PostDominatorTree &PDT) {
+  llvm::BasicBlock *Join = nullptr;
+  if (auto *Node = PDT.getNode(BB))
+    if (auto *IDom = Node->getIDom())
+      Join = IDom->getBlock();
+
+  SmallPtrSet<llvm::BasicBlock *, 16> Region;
+  SmallVector<llvm::BasicBlock *, 16> Worklist(succ_begin(BB), succ_end(BB));
+  while (!Worklist.empty()) {
+    llvm::BasicBlock *Succ = Worklist.pop_back_val();
+    if (Succ == Join || !Region.insert(Succ).second)
+      continue;
+    Worklist.append(succ_begin(Succ), succ_end(Succ));
+  }
+
+  bool Changed = false;
+  auto raiseJoin = [&](llvm::BasicBlock *Block) {
+    Uniformity &Current = JoinUniformity[Block];
+    if (U > Current) {
+      Current = U;
+      Changed = true;
+    }
+  };
+  if (Join)
+    raiseJoin(Join);
+  for (auto *Block : Region) {
+    raiseJoin(Block);
+    for (auto &I : *Block) {
+      for (auto *User : I.users()) {
+        auto *UI = cast<Instruction>(User);
+        if (Region.count(UI->getParent()) ||
+            (isa<PHINode>(UI) && UI->getParent() == Join))
+          continue;
+        Changed |= raise(UI, U);
+      }
+    }
+  }
+
+  return Changed;
+}
+
+void UniformityAnalysis::analyse() {
+  PostDominatorTree PDT;
+  PDT.recalculate(*F);
+
+  // Uniformity only ever increases, so this reaches a fixed point.
+  bool Changed = true;
+  while (Changed) {
+    Changed = false;
+    for (auto &BB : *F) {
+      for (auto &I : BB)
+        Changed |= raise(&I, computeUniformity(&I));
+
+      llvm::Value *Cond = nullptr;
+      if (auto *BI = dyn_cast<BranchInst>(BB.getTerminator())) {
+        if (BI->isConditional())
+          Cond = BI->getCondition();
+      } else if (auto *SI = dyn_cast<SwitchInst>(BB.getTerminator())) {
+        Cond = SI->getCondition();
+      }
+      if (!Cond)
+        continue;
+
+      Uniformity U = getUniformity(Cond);
+      Uniformity &Propagated = BranchUniformity[&BB];
+      if (U > Propagated) {
+        Propagated = U;
+        Changed |= propagateBranch(&BB, U, PDT);
+      }
+    }
+  }
+}
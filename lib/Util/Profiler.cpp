@@ -0,0 +1,233 @@
+#include "bugle/util/Profiler.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/raw_ostream.h"
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#endif
+
+using namespace bugle;
+using namespace llvm;
+
+namespace {
+
+struct Phase {
+  std::string Name;
+  std::string Category;
+  uint64_t Start, End;
+  size_t StartHeap, EndHeap;
+  uint64_t MaxRSS;
+  std::vector<unsigned> Children;
+};
+
+std::chrono::steady_clock::time_point Epoch;
+std::vector<Phase> Phases;
+std::vector<unsigned> Roots, OpenPhases;
+std::map<std::string, uint64_t> Counters;
+
+uint64_t now() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - Epoch)
+      .count();
+}
+
+void writeJSONString(raw_ostream &OS, StringRef S) {
+  OS << '"';
+  for (char C : S) {
+    switch (C) {
+    case '"':  OS << "\\\""; break;
+    case '\\': OS << "\\\\"; break;
+    case '\n': OS << "\\n";  break;
+    case '\t': OS << "\\t";  break;
+    default:
+      if ((unsigned char)C < 0x20)
+        OS << format("\\u%04x", (unsigned)C);
+      else
+        OS << C;
+    }
+  }
+  OS << '"';
+}
+
+void writeIndent(raw_ostream &OS, unsigned Indent) {
+  OS << std::string(Indent, ' ');
+}
+
+void writePhase(raw_ostream &OS, unsigned Id, unsigned Indent) {
+  const Phase &P = Phases[Id];
+  writeIndent(OS, Indent);
+  OS << "{\"name\": ";
+  writeJSONString(OS, P.Name);
+  OS << ", \"category\": ";
+  writeJSONString(OS, P.Category);
+  OS << ", \"start_us\": " << P.Start
+     << ", \"duration_us\": " << (P.End - P.Start)
+     << ", \"heap_start_bytes\": " << P.StartHeap
+     << ", \"heap_end_bytes\": " << P.EndHeap
+     << ", \"max_rss_kb\": " << P.MaxRSS << ", \"children\": [";
+  if (!P.Children.empty()) {
+    OS << "\n";
+    for (unsigned i = 0; i < P.Children.size(); ++i) {
+      if (i > 0)
+        OS << ",\n";
+      writePhase(OS, P.Children[i], Indent + 2);
+    }
+    OS << "\n";
+    writeIndent(OS, Indent);
+  }
+  OS << "]}";
+}
+
+void closeOpenPhases() {
+  while (!OpenPhases.empty())
+    Profiler::endPhase();
+}
+
+class PhaseMarkerPass : public ModulePass {
+  std::string Name;
+  bool Begin;
+
+public:
+  static char ID;
+
+  PhaseMarkerPass(StringRef Name, bool Begin)
+      : ModulePass(ID), Name(Name.str()), Begin(Begin) {}
+
+  StringRef getPassName() const override { return "Profiler phase marker"; }
+
+  void getAnalysisUsage(AnalysisUsage &AU) const override {
+    AU.setPreservesAll();
+  }
+
+  bool runOnModule(Module &M) override {
+    if (Begin)
+      Profiler::beginPhase(Name, "pass");
+    else
+      Profiler::endPhase();
+    return false;
+  }
+};
+
+char PhaseMarkerPass::ID = 0;
+}
+
+bool Profiler::Enabled = false;
+
+void Profiler::enable() {
+  if (Enabled)
+    return;
+  Enabled = true;
+  Epoch = std::chrono::steady_clock::now();
+}
+
+void Profiler::beginPhase(StringRef Name, StringRef Category) {
+  if (!Enabled)
+    return;
+
+  unsigned Id = Phases.size();
+  Phases.push_back(Phase{Name.str(), Category.str(), now(), 0,
+                         sys::Process::GetMallocUsage(), 0, 0, {}});
+  if (OpenPhases.empty())
+    Roots.push_back(Id);
+  else
+    Phases[OpenPhases.back()].Children.push_back(Id);
+  OpenPhases.push_back(Id);
+}
+
+void Profiler::endPhase() {
+  if (!Enabled)
+    return;
+
+  assert(!OpenPhases.empty() && "Unbalanced phase end");
+  Phase &P = Phases[OpenPhases.back()];
+  P.End = now();
+  P.EndHeap = sys::Process::GetMallocUsage();
+  P.MaxRSS = Profiler::getMaxRSS();
+  OpenPhases.pop_back();
+}
+
+uint64_t Profiler::getMaxRSS() {
+#if defined(_WIN32)
+  return 0;
+#else
+  struct rusage RU;
+  if (getrusage(RUSAGE_SELF, &RU) != 0)
+    return 0;
+#if defined(__APPLE__)
+  return RU.ru_maxrss / 1024;
+#else
+  return RU.ru_maxrss;
+#endif
+#endif
+}
+
+void Profiler::addToCounter(StringRef Name, uint64_t Amount) {
+  if (!Enabled)
+    return;
+
+  Counters[Name.str()] += Amount;
+}
+
+void Profiler::writeJSON(raw_ostream &OS) {
+  closeOpenPhases();
+
+  OS << "{\n  \"phases\": [";
+  if (!Roots.empty()) {
+    OS << "\n";
+    for (unsigned i = 0; i < Roots.size(); ++i) {
+      if (i > 0)
+        OS << ",\n";
+      writePhase(OS, Roots[i], 4);
+    }
+    OS << "\n  ";
+  }
+  OS << "],\n  \"counters\": {";
+  for (auto i = Counters.begin(), e = Counters.end(); i != e; ++i) {
+    OS << (i == Counters.begin() ? "\n" : ",\n") << "    ";
+    writeJSONString(OS, i->first);
+    OS << ": " << i->second;
+  }
+  if (!Counters.empty())
+    OS << "\n  ";
+  OS << "}\n}\n";
+}
+
+void Profiler::printPhaseMemory(raw_ostream &OS) {
+  closeOpenPhases();
+
+  OS << "Phases (peak RSS at end / heap at start -> end)\n";
+  for (auto Id : Roots) {
+    const Phase &P = Phases[Id];
+    OS << "  " << P.Name << ": " << P.MaxRSS << " KB / " << P.StartHeap
+       << " -> " << P.EndHeap << " bytes\n";
+  }
+}
+
+void Profiler::writeTrace(raw_ostream &OS) {
+  closeOpenPhases();
+
+  OS << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+  for (unsigned i = 0; i < Phases.size(); ++i) {
+    const Phase &P = Phases[i];
+    OS << (i > 0 ? ",\n" : "\n") << "{\"name\": ";
+    writeJSONString(OS, P.Name);
+    OS << ", \"cat\": ";
+    writeJSONString(OS, P.Category);
+    OS << ", \"ph\": \"X\", \"ts\": " << P.Start
+       << ", \"dur\": " << (P.End - P.Start) << ", \"pid\": 1, \"tid\": 1}";
+  }
+  OS << "\n]}\n";
+}
+
+ModulePass *bugle::createBeginPhasePass(StringRef Name) {
+  return new PhaseMarkerPass(Name, true);
+}
+
+ModulePass *bugle::createEndPhasePass() {
+  return new PhaseMarkerPass("", false);
+}
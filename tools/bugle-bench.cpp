@@ -0,0 +1,261 @@
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IRReader/IRReader.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/PrettyStackTrace.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/Signals.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/ToolOutputFile.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "bugle/Driver/Pipeline.h"
+#include "bugle/IntegerRepresentation.h"
+#include "bugle/SourceLocWriter.h"
+#include "bugle/util/ErrorReporter.h"
+#include "bugle/util/Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+using namespace llvm;
+
+static cl::list<std::string> InputFilenames(
+    cl::Positional, cl::OneOrMore,
+    cl::desc("<input IR or bitcode files>"));
+
+static cl::opt<std::string> OutputFilename(
+    "o", cl::desc("File for saving results (default stdout)"), cl::init("-"),
+    cl::value_desc("filename"));
+
+static cl::opt<unsigned> Iterations(
+    "iterations",
+    cl::desc("Number of times to translate each input (default 5)"),
+    cl::value_desc("int"), cl::init(5));
+
+static cl::opt<bugle::TranslateModule::SourceLanguage> SourceLanguage(
+    "l", cl::desc("Module source language"),
+    cl::init(bugle::TranslateModule::SL_OpenCL),
+    cl::values(clEnumValN(bugle::TranslateModule::SL_C, "c", "C"),
+               clEnumValN(bugle::TranslateModule::SL_CUDA, "cu", "CUDA"),
+               clEnumValN(bugle::TranslateModule::SL_OpenCL, "cl",
+                          "OpenCL (default)")));
+
+static cl::opt<bool> Inlining(
+    "inline", cl::ValueDisallowed, cl::desc("Inline all function calls"));
+
+// The options of the bugle driver which select the stages of the pipeline.
+static cl::opt<std::string> PreOpt(
+    "preopt", cl::desc("Optimize the module before translation"),
+    cl::init(""), cl::value_desc("level|passes"));
+
+static cl::opt<unsigned> UnrollThreshold(
+    "unroll-threshold",
+    cl::desc("Fully unroll loops with a constant trip count of at most this"),
+    cl::value_desc("int"), cl::init(0));
+
+static cl::opt<unsigned> BoundedUnroll(
+    "bounded-unroll", cl::desc("Unroll every loop this many times"),
+    cl::value_desc("int"), cl::init(0));
+
+static cl::opt<bool> NarrowBitWidths(
+    "narrow-bit-widths", cl::ValueDisallowed,
+    cl::desc("Narrow arithmetic to the widths at which it cannot overflow"));
+
+static cl::opt<bool> PropagateConstants(
+    "propagate-constants", cl::ValueDisallowed,
+    cl::desc("Propagate constants through phi variables"));
+
+static cl::opt<bool> SimplifyCFG(
+    "simplify-cfg", cl::ValueDisallowed,
+    cl::desc("Thread branches through empty blocks and merge blocks"));
+
+static cl::opt<bool> GlobalValueNumbering(
+    "global-value-numbering", cl::ValueDisallowed,
+    cl::desc("Compute each pure expression once"));
+
+static cl::opt<bool> AffineAccessSummaries(
+    "affine-access-summaries", cl::ValueDisallowed,
+    cl::desc("Annotate procedures with their affine access functions"));
+
+static cl::opt<bool> PruneRaceInstrumentation(
+    "prune-race-instrumentation", cl::ValueDisallowed,
+    cl::desc("Only declare the race instrumentation which is used"));
+
+static cl::opt<bool> SplitPointers(
+    "split-pointers", cl::ValueDisallowed,
+    cl::desc("Hold pointers in variables as separate array ids and offsets"));
+
+static cl::opt<bool> CoalesceVars(
+    "coalesce-vars", cl::ValueDisallowed,
+    cl::desc("Reuse the variables of temporaries"));
+
+namespace {
+
+enum Phase { Parse, Preprocess, Translate, Transform, Write, NumPhases };
+
+const char *const PhaseNames[NumPhases] = {"parse", "preprocess", "translate",
+                                           "transform", "write"};
+
+struct Sample {
+  double PhaseMs[NumPhases];
+  double WallMs;
+  uint64_t OutputBytes;
+};
+
+// Discards everything written to it, keeping only a count of the bytes.
+class CountingOStream : public raw_ostream {
+  uint64_t Count;
+
+  void write_impl(const char *Ptr, size_t Size) override { Count += Size; }
+  uint64_t current_pos() const override { return Count; }
+
+public:
+  CountingOStream() : Count(0) {}
+  ~CountingOStream() override { flush(); }
+};
+
+class PhaseTimer {
+  std::chrono::steady_clock::time_point Start;
+
+public:
+  PhaseTimer() : Start(std::chrono::steady_clock::now()) {}
+
+  double lap() {
+    auto Now = std::chrono::steady_clock::now();
+    double Ms =
+        std::chrono::duration<double, std::milli>(Now - Start).count();
+    Start = Now;
+    return Ms;
+  }
+};
+}
+
+// Run the pipeline of the bugle driver on the given file.
+static Sample RunPipeline(const std::string &FileName,
+                          const bugle::PipelineOptions &Opts,
+                          size_t &PeakHeap) {
+  Sample S;
+  PhaseTimer Total, T;
+
+  LLVMContext Context;
+  SMDiagnostic Err;
+  std::unique_ptr<Module> M = parseIRFile(FileName, Err, Context);
+  if (!M)
+    bugle::ErrorReporter::reportFatalError(Err.getMessage().str());
+  S.PhaseMs[Parse] = T.lap();
+
+  bugle::Pipeline Pipe(M.get(), Opts);
+  Pipe.preprocess();
+  S.PhaseMs[Preprocess] = T.lap();
+
+  Pipe.translate();
+  S.PhaseMs[Translate] = T.lap();
+  PeakHeap = std::max(PeakHeap, sys::Process::GetMallocUsage());
+
+  Pipe.transform();
+  S.PhaseMs[Transform] = T.lap();
+  PeakHeap = std::max(PeakHeap, sys::Process::GetMallocUsage());
+
+  bugle::BVIntegerRepresentation IntRep;
+  bugle::SourceLocWriter SLW(nullptr);
+  CountingOStream OS;
+  Pipe.write(OS, &IntRep, &SLW);
+  S.OutputBytes = OS.tell();
+  S.PhaseMs[Write] = T.lap();
+  PeakHeap = std::max(PeakHeap, sys::Process::GetMallocUsage());
+
+  S.WallMs = Total.lap();
+  return S;
+}
+
+static void WriteStat(raw_ostream &OS, std::vector<double> Values) {
+  std::sort(Values.begin(), Values.end());
+  OS << "{\"min\": " << Values.front()
+     << ", \"median\": " << Values[Values.size() / 2]
+     << ", \"max\": " << Values.back() << "}";
+}
+
+static void WriteJSONString(raw_ostream &OS, StringRef S) {
+  OS << '"';
+  for (char C : S) {
+    if (C == '"' || C == '\\')
+      OS << '\\';
+    OS << C;
+  }
+  OS << '"';
+}
+
+int main(int argc, char **argv) {
+  sys::PrintStackTraceOnErrorSignal(argv[0]);
+  llvm::PrettyStackTraceProgram X(argc, argv);
+
+  llvm_shutdown_obj Y; // Call llvm_shutdown() on exit.
+
+  cl::ParseCommandLineOptions(argc, argv, "Bugle translation benchmark\n");
+
+  if (Iterations == 0)
+    bugle::ErrorReporter::reportParameterError(
+        "Number of iterations must be positive");
+
+  std::error_code ErrorCode;
+  ToolOutputFile F(OutputFilename, ErrorCode, sys::fs::F_Text);
+  if (ErrorCode)
+    bugle::ErrorReporter::reportFatalError(ErrorCode.message());
+  raw_ostream &OS = F.os();
+
+  bugle::PipelineOptions Opts(SourceLanguage,
+                              bugle::TranslateModule::AddressSpaceMap(1, 3, 4));
+  Opts.Inlining = Inlining;
+  Opts.PreOpt = PreOpt;
+  Opts.UnrollThreshold = UnrollThreshold;
+  Opts.BoundedUnroll = BoundedUnroll;
+  Opts.NarrowBitWidths = NarrowBitWidths;
+  Opts.PropagateConstants = PropagateConstants;
+  Opts.SimplifyCFG = SimplifyCFG;
+  Opts.GlobalValueNumbering = GlobalValueNumbering;
+  Opts.AffineAccessSummaries = AffineAccessSummaries;
+  Opts.PruneRaceInstrumentation = PruneRaceInstrumentation;
+  Opts.SplitPointers = SplitPointers;
+  Opts.CoalesceVars = CoalesceVars;
+
+  OS << "{\n  \"iterations\": " << Iterations << ",\n  \"inputs\": [";
+  for (unsigned i = 0; i < InputFilenames.size(); ++i) {
+    const std::string &FileName = InputFilenames[i];
+    bugle::ErrorReporter::setFileName(FileName);
+
+    std::vector<Sample> Samples;
+    size_t PeakHeap = 0;
+    for (unsigned n = 0; n < Iterations; ++n)
+      Samples.push_back(RunPipeline(FileName, Opts, PeakHeap));
+
+    OS << (i > 0 ? ",\n" : "\n") << "    {\"name\": ";
+    WriteJSONString(OS, sys::path::filename(FileName));
+    OS << ",\n     \"wall_ms\": ";
+    std::vector<double> Values;
+    for (auto &S : Samples)
+      Values.push_back(S.WallMs);
+    WriteStat(OS, Values);
+    OS << ",\n     \"phases_ms\": {";
+    for (unsigned p = 0; p < NumPhases; ++p) {
+      Values.clear();
+      for (auto &S : Samples)
+        Values.push_back(S.PhaseMs[p]);
+      OS << (p > 0 ? ",\n" : "\n") << "       \"" << PhaseNames[p] << "\": ";
+      WriteStat(OS, Values);
+    }
+    // Peak RSS is a process-wide high-water mark, so it covers this input
+    // and all those before it.
+    OS << "},\n     \"peak_heap_bytes\": " << PeakHeap
+       << ",\n     \"max_rss_kb\": " << bugle::Profiler::getMaxRSS()
+       << ",\n     \"output_bytes\": " << Samples.front().OutputBytes << "}";
+  }
+  OS << "\n  ]\n}\n";
+
+  F.keep();
+  return 0;
+}
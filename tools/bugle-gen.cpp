@@ -0,0 +1,316 @@
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/DerivedTypes.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Intrinsics.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Metadata.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/PrettyStackTrace.h"
+#include "llvm/Support/Signals.h"
+#include "llvm/Support/ToolOutputFile.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "bugle/util/ErrorReporter.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+static cl::opt<std::string> OutputFilename(
+    "o", cl::desc("Output filename (default stdout)"), cl::init("-"),
+    cl::value_desc("filename"));
+
+static cl::opt<bool> EmitAssembly(
+    "S", cl::ValueDisallowed, cl::desc("Write textual IR instead of bitcode"));
+
+static cl::opt<unsigned> NumGlobals(
+    "globals", cl::desc("Number of __local arrays (default 2)"),
+    cl::value_desc("int"), cl::init(2));
+
+static cl::opt<unsigned> NumKernels(
+    "kernels", cl::desc("Number of kernels (default 1)"),
+    cl::value_desc("int"), cl::init(1));
+
+static cl::opt<unsigned> PhiDepth(
+    "phi-depth",
+    cl::desc("Depth of the chain of pointer phis in each kernel (default 0)"),
+    cl::value_desc("int"), cl::init(0));
+
+static cl::opt<unsigned> SwitchCases(
+    "switch-cases", cl::desc("Number of cases of the switch in each kernel "
+                             "(default 0, for no switch)"),
+    cl::value_desc("int"), cl::init(0));
+
+static cl::opt<unsigned> MemcpyLength(
+    "memcpy-length", cl::desc("Length in bytes of the memcpy between arrays "
+                              "in each kernel (default 0, for no memcpy)"),
+    cl::value_desc("int"), cl::init(0));
+
+static cl::opt<unsigned> VectorWidth(
+    "vector-width", cl::desc("Width of the vector access in each kernel "
+                             "(default 0, for no vector access)"),
+    cl::value_desc("int"), cl::init(0));
+
+static cl::opt<unsigned> StructDepth(
+    "struct-depth", cl::desc("Nesting depth of the structure accessed by "
+                             "each kernel (default 0, for no structure)"),
+    cl::value_desc("int"), cl::init(0));
+
+static cl::opt<unsigned> NumFunctions(
+    "functions", cl::desc("Number of non-kernel functions, called in a chain "
+                          "from each kernel (default 0)"),
+    cl::value_desc("int"), cl::init(0));
+
+namespace {
+
+const unsigned GlobalAddrSpace = 1;
+const unsigned GroupSharedAddrSpace = 3;
+
+class KernelGenerator {
+  LLVMContext &Ctx;
+  Module *M;
+  IntegerType *I32Ty;
+  ArrayType *ArrayTy;
+  std::vector<GlobalVariable *> Globals;
+  StructType *NestedTy;
+  Function *GetLocalId;
+  Function *FirstHelper;
+
+  Function *getOrCreateFunction(StringRef Name, FunctionType *FTy) {
+    if (auto *F = M->getFunction(Name))
+      return F;
+    return Function::Create(FTy, GlobalValue::ExternalLinkage, Name, M);
+  }
+
+  Value *getGlobalElement(IRBuilder<> &B, unsigned Global, Value *Index) {
+    Value *Indices[] = {B.getInt32(0), Index};
+    return B.CreateInBoundsGEP(ArrayTy, Globals[Global % Globals.size()],
+                               Indices);
+  }
+
+  void createGlobals();
+  void createNestedStruct();
+  void createHelpers();
+  Value *createPointerPhis(IRBuilder<> &B, Function *K, Value *X, Value *Lid);
+  void createSwitch(IRBuilder<> &B, Function *K, Value *X, Value *Ptr);
+  void createMemcpy(IRBuilder<> &B);
+  void createKernel(unsigned Id);
+
+public:
+  KernelGenerator(LLVMContext &Ctx, Module *M)
+      : Ctx(Ctx), M(M), I32Ty(Type::getInt32Ty(Ctx)), ArrayTy(nullptr),
+        NestedTy(nullptr), GetLocalId(nullptr), FirstHelper(nullptr) {}
+
+  void generate();
+};
+}
+
+void KernelGenerator::createGlobals() {
+  // Make the arrays large enough for the memcpy.
+  uint64_t Elements = std::max<uint64_t>(256, (MemcpyLength + 3) / 4);
+  ArrayTy = ArrayType::get(I32Ty, Elements);
+  for (unsigned i = 0; i < std::max(1u, (unsigned)NumGlobals); ++i) {
+    Globals.push_back(new GlobalVariable(
+        *M, ArrayTy, false, GlobalValue::InternalLinkage,
+        ConstantAggregateZero::get(ArrayTy), "A" + std::to_string(i), nullptr,
+        GlobalValue::NotThreadLocal, GroupSharedAddrSpace));
+  }
+}
+
+void KernelGenerator::createNestedStruct() {
+  Type *Ty = I32Ty;
+  for (unsigned i = 0; i < StructDepth; ++i) {
+    Type *Elements[] = {I32Ty, Ty};
+    Ty = StructType::create(Ctx, Elements, "struct.S" + std::to_string(i));
+  }
+  NestedTy = cast<StructType>(Ty);
+}
+
+void KernelGenerator::createHelpers() {
+  Type *Params[] = {I32Ty};
+  auto *FTy = FunctionType::get(I32Ty, Params, false);
+  Function *Next = nullptr;
+  for (unsigned i = NumFunctions; i > 0; --i) {
+    auto *F = Function::Create(FTy, GlobalValue::InternalLinkage,
+                               "helper" + std::to_string(i - 1), M);
+    IRBuilder<> B(BasicBlock::Create(Ctx, "entry", F));
+    Value *V = B.CreateAdd(&*F->arg_begin(), B.getInt32(i));
+    if (Next)
+      V = B.CreateCall(Next, V);
+    B.CreateRet(V);
+    Next = F;
+  }
+  FirstHelper = Next;
+}
+
+// Create a chain of diamonds, each of which selects between a new array and
+// the pointer selected by the previous diamond.
+Value *KernelGenerator::createPointerPhis(IRBuilder<> &B, Function *K,
+                                          Value *X, Value *Lid) {
+  Value *Ptr = getGlobalElement(B, 0, Lid);
+  for (unsigned i = 0; i < PhiDepth; ++i) {
+    BasicBlock *Pred = B.GetInsertBlock();
+    BasicBlock *Then = BasicBlock::Create(Ctx, "phi.then", K);
+    BasicBlock *Join = BasicBlock::Create(Ctx, "phi.join", K);
+    Value *Bit = B.CreateAnd(B.CreateLShr(X, i % 32), 1);
+    B.CreateCondBr(B.CreateICmpNE(Bit, B.getInt32(0)), Then, Join);
+
+    B.SetInsertPoint(Then);
+    Value *Other = getGlobalElement(B, i + 1, Lid);
+    B.CreateBr(Join);
+
+    B.SetInsertPoint(Join);
+    PHINode *Phi = B.CreatePHI(Ptr->getType(), 2);
+    Phi->addIncoming(Ptr, Pred);
+    Phi->addIncoming(Other, Then);
+    Ptr = Phi;
+  }
+  return Ptr;
+}
+
+void KernelGenerator::createSwitch(IRBuilder<> &B, Function *K, Value *X,
+                                   Value *Ptr) {
+  BasicBlock *Exit = BasicBlock::Create(Ctx, "switch.exit", K);
+  BasicBlock *Default = BasicBlock::Create(Ctx, "switch.default", K);
+  SwitchInst *SI = B.CreateSwitch(X, Default, SwitchCases);
+
+  B.SetInsertPoint(Default);
+  B.CreateBr(Exit);
+
+  B.SetInsertPoint(Exit);
+  PHINode *Phi = B.CreatePHI(I32Ty, SwitchCases + 1);
+  Phi->addIncoming(B.getInt32(-1), Default);
+
+  for (unsigned i = 0; i < SwitchCases; ++i) {
+    BasicBlock *Case = BasicBlock::Create(Ctx, "switch.case", K, Exit);
+    SI->addCase(B.getInt32(i), Case);
+    IRBuilder<> CB(Case);
+    CB.CreateBr(Exit);
+    Phi->addIncoming(B.getInt32(i * 3), Case);
+  }
+
+  B.CreateStore(Phi, Ptr);
+}
+
+void KernelGenerator::createMemcpy(IRBuilder<> &B) {
+  auto *I8PtrTy = Type::getInt8PtrTy(Ctx, GroupSharedAddrSpace);
+  Type *Tys[] = {I8PtrTy, I8PtrTy, I32Ty};
+  Function *Memcpy = Intrinsic::getDeclaration(M, Intrinsic::memcpy, Tys);
+  Value *Dst = B.CreateBitCast(getGlobalElement(B, 1, B.getInt32(0)), I8PtrTy);
+  Value *Src = B.CreateBitCast(getGlobalElement(B, 0, B.getInt32(0)), I8PtrTy);
+  Value *Args[] = {Dst, Src, B.getInt32(MemcpyLength), B.getFalse()};
+  B.CreateCall(Memcpy, Args);
+}
+
+void KernelGenerator::createKernel(unsigned Id) {
+  std::vector<Type *> Params;
+  Params.push_back(PointerType::get(I32Ty, GlobalAddrSpace));
+  Params.push_back(I32Ty);
+  VectorType *VecTy = nullptr;
+  if (VectorWidth > 0) {
+    VecTy = VectorType::get(I32Ty, (unsigned)VectorWidth);
+    Params.push_back(PointerType::get(VecTy, GlobalAddrSpace));
+  }
+  if (NestedTy)
+    Params.push_back(PointerType::get(NestedTy, GlobalAddrSpace));
+
+  auto *FTy = FunctionType::get(Type::getVoidTy(Ctx), Params, false);
+  auto *K = Function::Create(FTy, GlobalValue::ExternalLinkage,
+                             "kernel" + std::to_string(Id), M);
+  auto AI = K->arg_begin();
+  Value *Out = &*AI++;
+  Value *X = &*AI++;
+
+  IRBuilder<> B(BasicBlock::Create(Ctx, "entry", K));
+  Value *Lid = B.CreateCall(GetLocalId, B.getInt32(0));
+
+  Value *Ptr = createPointerPhis(B, K, X, Lid);
+  B.CreateStore(Lid, Ptr);
+
+  if (SwitchCases > 0)
+    createSwitch(B, K, X, Ptr);
+
+  if (MemcpyLength > 0)
+    createMemcpy(B);
+
+  if (VecTy) {
+    Value *VecPtr = B.CreateInBoundsGEP(VecTy, &*AI++, Lid);
+    Value *V = B.CreateLoad(VecTy, VecPtr);
+    B.CreateStore(B.CreateAdd(V, V), VecPtr);
+  }
+
+  if (NestedTy) {
+    std::vector<Value *> Indices(1, Lid);
+    for (unsigned i = 0; i < StructDepth; ++i)
+      Indices.push_back(B.getInt32(1));
+    B.CreateStore(Lid, B.CreateInBoundsGEP(NestedTy, &*AI++, Indices));
+  }
+
+  Value *Result = B.CreateLoad(I32Ty, Ptr);
+  if (FirstHelper)
+    Result = B.CreateCall(FirstHelper, Result);
+  B.CreateStore(Result, B.CreateInBoundsGEP(I32Ty, Out, Lid));
+  B.CreateRetVoid();
+
+  M->getOrInsertNamedMetadata("opencl.kernels")
+      ->addOperand(MDNode::get(Ctx, ValueAsMetadata::get(K)));
+}
+
+void KernelGenerator::generate() {
+  M->setDataLayout("e-p:32:32-i64:64-v16:16-v32:32-n16:32:64");
+  M->setTargetTriple("spir-unknown-unknown");
+
+  Type *Params[] = {I32Ty};
+  GetLocalId = getOrCreateFunction(
+      "get_local_id", FunctionType::get(I32Ty, Params, false));
+
+  createGlobals();
+  if (StructDepth > 0)
+    createNestedStruct();
+  createHelpers();
+  for (unsigned i = 0; i < std::max(1u, (unsigned)NumKernels); ++i)
+    createKernel(i);
+}
+
+int main(int argc, char **argv) {
+  sys::PrintStackTraceOnErrorSignal(argv[0]);
+  llvm::PrettyStackTraceProgram X(argc, argv);
+
+  llvm_shutdown_obj Y; // Call llvm_shutdown() on exit.
+  LLVMContext Context;
+
+  cl::ParseCommandLineOptions(argc, argv,
+                              "Generator of parameterized OpenCL kernels\n");
+
+  if (MemcpyLength > 0 && NumGlobals < 2)
+    bugle::ErrorReporter::reportParameterError(
+        "A memcpy requires at least two global arrays");
+
+  std::unique_ptr<Module> M(new Module("generated", Context));
+  KernelGenerator(Context, M.get()).generate();
+
+  if (verifyModule(*M, &errs()))
+    bugle::ErrorReporter::reportImplementationLimitation(
+        "Generated module is invalid");
+
+  std::error_code ErrorCode;
+  ToolOutputFile F(OutputFilename, ErrorCode,
+                   EmitAssembly ? sys::fs::F_Text : sys::fs::F_None);
+  if (ErrorCode)
+    bugle::ErrorReporter::reportFatalError(ErrorCode.message());
+
+  if (EmitAssembly)
+    M->print(F.os(), nullptr);
+  else
+    WriteBitcodeToFile(*M, F.os());
+
+  F.keep();
+  return 0;
+}
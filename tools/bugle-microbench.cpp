@@ -0,0 +1,234 @@
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/PrettyStackTrace.h"
+#include "llvm/Support/Regex.h"
+#include "llvm/Support/Signals.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "bugle/BPLExprWriter.h"
+#include "bugle/BPLModuleWriter.h"
+#include "bugle/Expr.h"
+#include "bugle/GlobalArray.h"
+#include "bugle/IntegerRepresentation.h"
+#include "bugle/Module.h"
+#include "bugle/RaceInstrumenter.h"
+#include "bugle/SourceLocWriter.h"
+#include "bugle/Var.h"
+#include "bugle/util/ErrorReporter.h"
+#include "bugle/util/UniqueNameSet.h"
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <set>
+#include <vector>
+
+using namespace llvm;
+using namespace bugle;
+
+static cl::opt<std::string> Filter(
+    "filter", cl::desc("Only run benchmarks whose name matches this regex"),
+    cl::init(""), cl::value_desc("regex"));
+
+static cl::opt<unsigned> MinTime(
+    "min-time", cl::desc("Minimum time to run each benchmark for, in "
+                         "milliseconds (default 200)"),
+    cl::value_desc("int"), cl::init(200));
+
+static cl::opt<bool> JSON("json", cl::ValueDisallowed,
+                          cl::desc("Report results as JSON"));
+
+namespace {
+
+// Holds the result of each benchmark iteration so that the work producing it
+// cannot be optimized away.
+ref<Expr> Sink;
+
+// A benchmark runs its body the given number of times. Set-up which should
+// not be measured is done once, before the returned body is called.
+struct Benchmark {
+  const char *Name;
+  std::function<std::function<void(unsigned)>()> SetUp;
+};
+
+const Type BV32(Type::BV, 32);
+
+ref<Expr> makeVar(std::vector<std::unique_ptr<Var>> &Vars, Type T) {
+  Vars.emplace_back(new Var(T, "v" + std::to_string(Vars.size())));
+  return VarRefExpr::create(Vars.back().get());
+}
+
+std::vector<Benchmark> getBenchmarks() {
+  std::vector<Benchmark> Benchmarks;
+
+  Benchmarks.push_back({"BVAddExpr::create/fold", [] {
+    return [](unsigned N) {
+      for (unsigned i = 0; i < N; ++i)
+        Sink = BVAddExpr::create(BVConstExpr::create(32, i),
+                                 BVConstExpr::create(32, 42));
+    };
+  }});
+
+  Benchmarks.push_back({"BVAddExpr::create/reassociate", [] {
+    auto Vars = std::make_shared<std::vector<std::unique_ptr<Var>>>();
+    ref<Expr> X = makeVar(*Vars, BV32);
+    return [Vars, X](unsigned N) {
+      for (unsigned i = 0; i < N; ++i) {
+        ref<Expr> E = X;
+        for (unsigned j = 0; j < 16; ++j)
+          E = BVAddExpr::create(E, BVConstExpr::create(32, j + 1));
+        Sink = E;
+      }
+    };
+  }});
+
+  Benchmarks.push_back({"BVConcatExpr::create/fold", [] {
+    return [](unsigned N) {
+      for (unsigned i = 0; i < N; ++i)
+        Sink = BVConcatExpr::create(BVConstExpr::create(16, i),
+                                    BVConstExpr::create(16, i + 1));
+    };
+  }});
+
+  Benchmarks.push_back({"Expr::createExactBVSDiv", [] {
+    auto Vars = std::make_shared<std::vector<std::unique_ptr<Var>>>();
+    ref<Expr> E = BVConstExpr::create(32, 16);
+    for (unsigned j = 0; j < 8; ++j)
+      E = BVAddExpr::create(
+          E, BVMulExpr::create(makeVar(*Vars, BV32),
+                               BVConstExpr::create(32, 4 << (j % 3))));
+    return [Vars, E](unsigned N) {
+      for (unsigned i = 0; i < N; ++i)
+        Sink = Expr::createExactBVSDiv(E, 4);
+    };
+  }});
+
+  Benchmarks.push_back({"BVExtractExpr::create/concat-tower", [] {
+    // A byte-by-byte concatenation, as produced by byte-array loads.
+    auto Vars = std::make_shared<std::vector<std::unique_ptr<Var>>>();
+    std::vector<ref<Expr>> Bytes;
+    for (unsigned j = 0; j < 64; ++j)
+      Bytes.push_back(makeVar(*Vars, Type(Type::BV, 8)));
+    ref<Expr> Tower = Expr::createBVConcatN(Bytes);
+    return [Vars, Tower](unsigned N) {
+      for (unsigned i = 0; i < N; ++i)
+        Sink = BVExtractExpr::create(Tower, (i % 60) * 8, 32);
+    };
+  }});
+
+  Benchmarks.push_back({"Expr::computeArrayCandidates/ite-tree", [] {
+    auto Vars = std::make_shared<std::vector<std::unique_ptr<Var>>>();
+    auto Arrays =
+        std::make_shared<std::vector<std::unique_ptr<GlobalArray>>>();
+    std::function<ref<Expr>(unsigned)> Build = [&](unsigned Depth) {
+      if (Depth == 0) {
+        Arrays->emplace_back(new GlobalArray(
+            "A" + std::to_string(Arrays->size()), BV32, "", BV32,
+            std::vector<uint64_t>(1, 0), false));
+        return GlobalArrayRefExpr::create(Arrays->back().get());
+      }
+      return IfThenElseExpr::create(makeVar(*Vars, Type(Type::Bool)),
+                                    Build(Depth - 1), Build(Depth - 1));
+    };
+    ref<Expr> Tree = Build(8);
+    return [Vars, Arrays, Tree](unsigned N) {
+      for (unsigned i = 0; i < N; ++i) {
+        std::set<GlobalArray *> Globals;
+        Tree->computeArrayCandidates(Globals);
+      }
+    };
+  }});
+
+  Benchmarks.push_back({"UniqueNameSet::makeName/collisions", [] {
+    return [](unsigned N) {
+      for (unsigned i = 0; i < N; ++i) {
+        UniqueNameSet Names;
+        for (unsigned j = 0; j < 256; ++j)
+          Names.makeName("v");
+      }
+    };
+  }});
+
+  Benchmarks.push_back({"BPLExprWriter::writeExpr/dag", [] {
+    auto Vars = std::make_shared<std::vector<std::unique_ptr<Var>>>();
+    ref<Expr> E = makeVar(*Vars, BV32);
+    for (unsigned j = 0; j < 10; ++j)
+      E = BVAddExpr::create(BVMulExpr::create(E, makeVar(*Vars, BV32)), E);
+    return [Vars, E](unsigned N) {
+      Module M;
+      BVIntegerRepresentation IntRep;
+      SourceLocWriter SLW(nullptr);
+      std::string S;
+      raw_string_ostream OS(S);
+      BPLModuleWriter MW(OS, &M, &IntRep, RaceInstrumenter::WatchdogSingle,
+                         &SLW);
+      BPLExprWriter W(&MW);
+      for (unsigned i = 0; i < N; ++i) {
+        S.clear();
+        W.writeExpr(OS, E.get());
+        OS.flush();
+      }
+    };
+  }});
+
+  return Benchmarks;
+}
+
+// Run the benchmark with an increasing number of iterations until it takes at
+// least MinTime, and return the time per iteration in nanoseconds.
+double runBenchmark(const Benchmark &B, unsigned &Iterations) {
+  auto Body = B.SetUp();
+  Iterations = 1;
+  while (true) {
+    auto Start = std::chrono::steady_clock::now();
+    Body(Iterations);
+    double Ns = std::chrono::duration<double, std::nano>(
+                    std::chrono::steady_clock::now() - Start)
+                    .count();
+    if (Ns >= MinTime * 1e6 || Iterations >= (1u << 30))
+      return Ns / Iterations;
+    Iterations *= Ns < MinTime * 1e5 ? 10 : 2;
+  }
+}
+}
+
+int main(int argc, char **argv) {
+  sys::PrintStackTraceOnErrorSignal(argv[0]);
+  llvm::PrettyStackTraceProgram X(argc, argv);
+
+  llvm_shutdown_obj Y; // Call llvm_shutdown() on exit.
+
+  cl::ParseCommandLineOptions(argc, argv, "Bugle micro-benchmarks\n");
+
+  Regex FilterRegex(Filter);
+  std::string Error;
+  if (!Filter.empty() && !FilterRegex.isValid(Error))
+    ErrorReporter::reportParameterError("Invalid filter: " + Error);
+
+  bool First = true;
+  if (JSON)
+    outs() << "{\"benchmarks\": [";
+  for (const auto &B : getBenchmarks()) {
+    if (!Filter.empty() && !FilterRegex.match(B.Name))
+      continue;
+
+    unsigned Iterations;
+    double Ns = runBenchmark(B, Iterations);
+    Sink = ref<Expr>();
+
+    if (JSON) {
+      outs() << (First ? "\n" : ",\n") << "  {\"name\": \"" << B.Name
+             << "\", \"iterations\": " << Iterations
+             << ", \"ns_per_iteration\": " << Ns << "}";
+    } else {
+      outs() << B.Name << ": " << format("%.1f", Ns) << " ns ("
+             << Iterations << " iterations)\n";
+    }
+    First = false;
+  }
+  if (JSON)
+    outs() << "\n]}\n";
+
+  return 0;
+}
@@ -1,9 +1,8 @@
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/Bitcode/BitcodeReader.h"
-#include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
-#include "llvm/IR/Verifier.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/FileSystem.h"
@@ -14,26 +13,17 @@
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/ToolOutputFile.h"
-#include "llvm/Transforms/IPO.h"
-#include "llvm/Transforms/Scalar.h"
 
-#include "bugle/BPLModuleWriter.h"
+#include "bugle/Driver/Pipeline.h"
+#include "bugle/Expr.h"
 #include "bugle/IntegerRepresentation.h"
+#include "bugle/MemoryStats.h"
 #include "bugle/Module.h"
 #include "bugle/SourceLocWriter.h"
-#include "bugle/Preprocessing/ArgumentPromotionPass.h"
-#include "bugle/Preprocessing/ArgumentRenamePass.h"
-#include "bugle/Preprocessing/CycleDetectPass.h"
-#include "bugle/Preprocessing/FreshArrayPass.h"
-#include "bugle/Preprocessing/InlinePass.h"
-#include "bugle/Preprocessing/RestrictDetectPass.h"
-#include "bugle/Preprocessing/SimpleInternalizePass.h"
-#include "bugle/Preprocessing/StructSimplificationPass.h"
-#include "bugle/Preprocessing/Vector3SimplificationPass.h"
 #include "bugle/RaceInstrumenter.h"
-#include "bugle/Transform/SimplifyStmt.h"
 #include "bugle/Translator/TranslateModule.h"
 #include "bugle/util/ErrorReporter.h"
+#include "bugle/util/Profiler.h"
 
 #include <map>
 #include <set>
@@ -64,14 +54,17 @@ static cl::opt<bugle::TranslateModule::SourceLanguage> SourceLanguage(
                clEnumValN(bugle::TranslateModule::SL_CUDA, "cu", "CUDA"),
                clEnumValN(bugle::TranslateModule::SL_OpenCL, "cl", "OpenCL")));
 
-enum IntRep { BVIntRep, MathIntRep };
+enum IntRep { BVIntRep, MathIntRep, HybridIntRep };
 
 static cl::opt<IntRep> IntegerRepresentation(
     "i", cl::desc("Integer representation"), cl::init(BVIntRep),
     cl::values(clEnumValN(BVIntRep, "bv",
                           "Bitvector integer representation (default)"),
                clEnumValN(MathIntRep, "math",
-                          "Mathematical integer representation")));
+                          "Mathematical integer representation"),
+               clEnumValN(HybridIntRep, "hybrid",
+                          "Mathematical integers for the values which range "
+                          "analysis proves cannot wrap, bitvectors otherwise")));
 
 static cl::opt<bool> Inlining(
     "inline", cl::ValueDisallowed, cl::desc("Inline all function calls"));
@@ -81,6 +74,10 @@ static cl::opt<bool> DumpIR("dump-ir", cl::ValueDisallowed, cl::Hidden,
                             cl::desc("Dump the preprocessed IR"));
 #endif
 
+static cl::opt<bool> DumpMemoryStats(
+    "dump-memory-stats", cl::ValueDisallowed, cl::Hidden,
+    cl::desc("Dump expression, statement and per-phase memory statistics"));
+
 static cl::opt<bugle::RaceInstrumenter> RaceInstrumentation(
     "race-instrumentation", cl::desc("Race instrumentation method to use"),
     cl::init(bugle::RaceInstrumenter::WatchdogSingle),
@@ -91,11 +88,73 @@ static cl::opt<bugle::RaceInstrumenter> RaceInstrumentation(
                clEnumValN(bugle::RaceInstrumenter::WatchdogMultiple,
                           "watchdog-multiple", "Watchdog multiple")));
 
+static cl::opt<bool> PruneRaceInstrumentation(
+    "prune-race-instrumentation", cl::ValueDisallowed,
+    cl::desc("Only declare race instrumentation for the kinds of access which "
+             "occur to each array, and omit arrays which are not used"));
+
+static cl::opt<bool> SplitPointers(
+    "split-pointers", cl::ValueDisallowed,
+    cl::desc("Hold pointers in variables as separate array ids and offsets, "
+             "packing them only when they are stored to memory"));
+
+static cl::opt<bool> CoalesceVars(
+    "coalesce-vars", cl::ValueDisallowed,
+    cl::desc("Reuse the variables of temporaries whose lifetimes do not "
+             "overlap"));
+
+static cl::opt<bool> PropagateConstants(
+    "propagate-constants", cl::ValueDisallowed,
+    cl::desc("Propagate constants through phi variables and remove the "
+             "branches which they show cannot be taken"));
+
+static cl::opt<bool> SimplifyCFG(
+    "simplify-cfg", cl::ValueDisallowed,
+    cl::desc("Thread branches through empty blocks and merge blocks with "
+             "their only predecessor"));
+
+static cl::opt<bool> GlobalValueNumbering(
+    "global-value-numbering", cl::ValueDisallowed,
+    cl::desc("Compute each pure expression once and reuse its value in the "
+             "blocks which it dominates"));
+
+static cl::opt<bool> AffineAccessSummaries(
+    "affine-access-summaries", cl::ValueDisallowed,
+    cl::desc("Annotate procedures with the affine access functions in the "
+             "thread and group ids with which they access each array"));
+
+static cl::opt<bool> NarrowBitWidths(
+    "narrow-bit-widths", cl::ValueDisallowed,
+    cl::desc("Perform additions, multiplications and shifts at the narrowest "
+             "width at which they cannot overflow, given the launch sizes"));
+
 static cl::list<std::string>
     GPUArraySizes("kernel-array-sizes", cl::ZeroOrMore,
                   cl::desc("Specify GPU entry point array sizes in bytes"),
                   cl::value_desc("function(,int)*"));
 
+static cl::list<std::string> GPUArgValues(
+    "kernel-arg-values", cl::ZeroOrMore,
+    cl::desc("Bind GPU entry point scalar arguments to constant values"),
+    cl::value_desc("function(,name=int)*"));
+
+static cl::opt<std::string> LocalSize(
+    "local-size", cl::desc("Fix the work-group size, or CUDA block size"),
+    cl::value_desc("int(,int|*)*"));
+
+static cl::opt<std::string> NumGroups(
+    "num-groups",
+    cl::desc("Fix the number of work-groups, or CUDA grid size"),
+    cl::value_desc("int(,int|*)*"));
+
+static cl::opt<std::string> GlobalOffset(
+    "global-offset", cl::desc("Fix the OpenCL global work offset"),
+    cl::value_desc("int(,int|*)*"));
+
+static cl::opt<unsigned> WorkDim(
+    "work-dim", cl::desc("Fix the number of OpenCL work dimensions"),
+    cl::value_desc("int"), cl::init(0));
+
 static cl::opt<bool> OnlyExplicitGPUEntryPoints(
     "only-explicit-entry-points", cl::ValueDisallowed,
     cl::desc("Only translate GPU entry points specified with k option"));
@@ -115,6 +174,35 @@ static cl::opt<unsigned> ConstantAddrSpace(
     "constant-space", cl::desc("Constant address space (default 4)"),
     cl::value_desc("int"), cl::init(4));
 
+static cl::opt<std::string> PreOpt(
+    "preopt",
+    cl::desc("Optimize the module before translation, either at level O1 or "
+             "with a comma-separated list of passes from sroa, early-cse, "
+             "gvn, instcombine and adce (default none)"),
+    cl::init(""), cl::value_desc("level|passes"));
+
+static cl::opt<unsigned> UnrollThreshold(
+    "unroll-threshold",
+    cl::desc("Fully unroll loops with a constant trip count of at most this, "
+             "unless they contain barriers or invariants (default 0, no "
+             "unrolling)"),
+    cl::value_desc("int"), cl::init(0));
+
+static cl::opt<unsigned> BoundedUnroll(
+    "bounded-unroll",
+    cl::desc("Produce loop-free output for quick bug finding: unroll every "
+             "loop this many times, cut paths with more iterations using "
+             "'assume false' and drop loop invariants (default 0, off)"),
+    cl::value_desc("int"), cl::init(0));
+
+static cl::opt<std::string> ProfileOutput(
+    "profile-output", cl::desc("File for saving phase timings and counters"),
+    cl::init(""), cl::value_desc("filename"));
+
+static cl::opt<std::string> ProfileTrace(
+    "profile-trace",
+    cl::desc("File for saving phase timings in trace-event format"),
+    cl::init(""), cl::value_desc("filename"));
 
 static void CheckAddressSpaces() {
   if (GlobalAddrSpace == 0 || GlobalAddrSpace == GroupSharedAddrSpace ||
@@ -139,6 +227,19 @@ static void CheckAddressSpaces() {
   }
 }
 
+static void WriteProfile(const std::string &FileName,
+                         void (*Write)(raw_ostream &)) {
+  if (FileName.empty())
+    return;
+
+  std::error_code ErrorCode;
+  ToolOutputFile F(FileName, ErrorCode, sys::fs::F_Text);
+  if (ErrorCode)
+    bugle::ErrorReporter::reportFatalError(ErrorCode.message());
+  Write(F.os());
+  F.keep();
+}
+
 static void GetArraySizes(std::map<std::string, bugle::ArraySpec> &KAS) {
   Regex RegEx = Regex("([a-zA-Z_][a-zA-Z_0-9]*)((,[0-9\\*]+)*)");
   for (auto i = GPUArraySizes.begin(), e = GPUArraySizes.end(); i != e; ++i) {
@@ -169,6 +270,88 @@ static void GetArraySizes(std::map<std::string, bugle::ArraySpec> &KAS) {
   }
 }
 
+static void GetArgValues(std::map<std::string, bugle::ArgValueSpec> &KAV) {
+  Regex RegEx = Regex("([a-zA-Z_][a-zA-Z_0-9]*)"
+                      "((,[a-zA-Z_][a-zA-Z_0-9]*=-?[0-9a-fA-FxX]+)*)");
+  for (auto i = GPUArgValues.begin(), e = GPUArgValues.end(); i != e; ++i) {
+    SmallVector<StringRef, 1> Matches;
+    if (!RegEx.match(*i, &Matches) || Matches[0] != *i) {
+      std::string msg = "Invalid GPU argument value specifier: " + *i;
+      bugle::ErrorReporter::reportParameterError(msg);
+    }
+    if (KAV.find(Matches[1].str()) != KAV.end()) {
+      std::string msg = "Argument values for " + Matches[1].str() +
+                        " specified multiple times";
+      bugle::ErrorReporter::reportParameterError(msg);
+    }
+    SmallVector<StringRef, 1> MatchValues;
+    bugle::ArgValueSpec ArgValues;
+    Matches[2].split(MatchValues, ",");
+    for (auto vi = MatchValues.begin() + 1, ve = MatchValues.end(); vi != ve;
+         ++vi) {
+      std::pair<StringRef, StringRef> NameValue = vi->split('=');
+      int64_t value = 0;
+      if (NameValue.second.getAsInteger(0, value)) {
+        std::string msg = "Invalid argument value: " + vi->str();
+        bugle::ErrorReporter::reportParameterError(msg);
+      }
+      if (!ArgValues.insert(std::make_pair(NameValue.first.str(), value))
+               .second) {
+        std::string msg = "Value for argument " + NameValue.first.str() +
+                          " specified multiple times";
+        bugle::ErrorReporter::reportParameterError(msg);
+      }
+    }
+    KAV[Matches[1].str()] = ArgValues;
+  }
+}
+
+static void GetLaunchDims(const std::string &Option, const std::string &Value,
+                          uint64_t Default,
+                          bugle::TranslateModule::LaunchDims &Dims) {
+  if (!Value.empty()) {
+    SmallVector<StringRef, 3> MatchDims;
+    StringRef(Value).split(MatchDims, ",");
+    if (MatchDims.size() > 3)
+      bugle::ErrorReporter::reportParameterError(
+          "Too many dimensions for " + Option + ": " + Value);
+    for (auto D : MatchDims) {
+      uint64_t Size = 0;
+      bool IsKnown = !D.equals("*");
+      if (IsKnown && D.getAsInteger(0, Size))
+        bugle::ErrorReporter::reportParameterError(
+            "Invalid " + Option + " dimension: " + D.str());
+      Dims.push_back(std::make_pair(IsKnown, Size));
+    }
+  }
+
+  // Dimensions beyond the number of work dimensions have their default value.
+  for (unsigned i = Dims.size(); i < WorkDim; ++i)
+    Dims.push_back(std::make_pair(false, 0));
+  if (WorkDim != 0)
+    for (unsigned i = Dims.size(); i < 3; ++i)
+      Dims.push_back(std::make_pair(true, Default));
+}
+
+static void
+GetLaunchConfiguration(bugle::TranslateModule::LaunchConfiguration &LC) {
+  if (WorkDim > 3)
+    bugle::ErrorReporter::reportParameterError(
+        "Number of work dimensions must be at most 3");
+  if (WorkDim != 0)
+    LC.WorkDim = std::make_pair(true, WorkDim);
+  GetLaunchDims("local size", LocalSize, 1, LC.LocalSize);
+  GetLaunchDims("number of groups", NumGroups, 1, LC.NumGroups);
+  GetLaunchDims("global offset", GlobalOffset, 0, LC.GlobalOffset);
+  for (auto &D : LC.LocalSize)
+    if (D.first && D.second == 0)
+      bugle::ErrorReporter::reportParameterError("Local size must be positive");
+  for (auto &D : LC.NumGroups)
+    if (D.first && D.second == 0)
+      bugle::ErrorReporter::reportParameterError(
+          "Number of groups must be positive");
+}
+
 int main(int argc, char **argv) {
   sys::PrintStackTraceOnErrorSignal(argv[0]);
   llvm::PrettyStackTraceProgram X(argc, argv);
@@ -188,10 +371,16 @@ int main(int argc, char **argv) {
     DisplayFilename = InputFilename;
   bugle::ErrorReporter::setFileName(DisplayFilename);
 
+  if (!ProfileOutput.empty() || !ProfileTrace.empty() || DumpMemoryStats) {
+    bugle::Profiler::enable();
+    bugle::Expr::TrackAllocation = true;
+  }
+
   std::string ErrorMessage;
   std::unique_ptr<Module> M;
 
   // Read module
+  bugle::Profiler::beginPhase("parse", "phase");
   ErrorOr<std::unique_ptr<MemoryBuffer>> BufferOrErr =
       MemoryBuffer::getFile(InputFilename);
 
@@ -208,6 +397,7 @@ int main(int argc, char **argv) {
     else
       M = std::move(ModuleOrErr.get());
   }
+  bugle::Profiler::endPhase();
 
   if (!M) {
     if (ErrorMessage.size())
@@ -217,6 +407,7 @@ int main(int argc, char **argv) {
   }
 
   std::unique_ptr<bugle::IntegerRepresentation> IntRep;
+  bugle::HybridIntegerRepresentation *HybridRep = nullptr;
   switch (IntegerRepresentation) {
   case BVIntRep:
     IntRep.reset(new bugle::BVIntegerRepresentation());
@@ -224,53 +415,61 @@ int main(int argc, char **argv) {
   case MathIntRep:
     IntRep.reset(new bugle::MathIntegerRepresentation());
     break;
+  case HybridIntRep:
+    HybridRep = new bugle::HybridIntegerRepresentation();
+    IntRep.reset(HybridRep);
+    break;
   }
 
   CheckAddressSpaces();
   bugle::TranslateModule::AddressSpaceMap AddressSpaces(
       GlobalAddrSpace, GroupSharedAddrSpace, ConstantAddrSpace);
 
-  std::set<std::string> EP;
+  bugle::PipelineOptions Opts(SourceLanguage, AddressSpaces);
   for (auto &E : GPUEntryPoints)
-    EP.insert(E);
-
-  std::map<std::string, bugle::ArraySpec> KAS;
-  GetArraySizes(KAS);
-
-  legacy::PassManager PM;
-  PM.add(new bugle::FreshArrayPass());
-  PM.add(new bugle::Vector3SimplificationPass());
-  PM.add(new bugle::ArgumentPromotionPass(SourceLanguage, EP));
-  PM.add(new bugle::StructSimplificationPass(M.get()));
-  if (Inlining) {
-    PM.add(new bugle::CycleDetectPass());
-    PM.add(new bugle::InlinePass(SourceLanguage, EP));
-    PM.add(new bugle::StructSimplificationPass(M.get()));
-  }
-  if (Inlining || OnlyExplicitGPUEntryPoints) {
-    PM.add(new bugle::SimpleInternalizePass(SourceLanguage, EP,
-                                            OnlyExplicitGPUEntryPoints));
-  }
-  PM.add(createPromoteMemoryToRegisterPass());
-  PM.add(createGlobalDCEPass());
-  PM.add(new bugle::RestrictDetectPass(SourceLanguage, EP, AddressSpaces));
-  PM.add(new bugle::ArgumentRenamePass());
-#ifndef NDEBUG
-  PM.add(createVerifierPass());
-#endif
-  PM.run(*M);
+    Opts.EntryPoints.insert(E);
+  Opts.OnlyExplicitEntryPoints = OnlyExplicitGPUEntryPoints;
+  Opts.Inlining = Inlining;
+  Opts.PreOpt = PreOpt;
+  Opts.UnrollThreshold = UnrollThreshold;
+  Opts.BoundedUnroll = BoundedUnroll;
+  Opts.RaceInstrumentation = RaceInstrumentation;
+  GetArraySizes(Opts.ArraySizes);
+  GetArgValues(Opts.ArgValues);
+  GetLaunchConfiguration(Opts.Launch);
+  Opts.NarrowBitWidths = NarrowBitWidths;
+  Opts.PropagateConstants = PropagateConstants;
+  Opts.SimplifyCFG = SimplifyCFG;
+  Opts.GlobalValueNumbering = GlobalValueNumbering;
+  Opts.AffineAccessSummaries = AffineAccessSummaries;
+  Opts.PruneRaceInstrumentation = PruneRaceInstrumentation;
+  Opts.SplitPointers = SplitPointers;
+  Opts.CoalesceVars = CoalesceVars;
+
+  bugle::Pipeline Pipe(M.get(), Opts);
+  Pipe.preprocess();
 
 #ifndef NDEBUG
   if (DumpIR)
     M->dump();
 #endif
 
-  bugle::TranslateModule TM(M.get(), SourceLanguage, EP, RaceInstrumentation,
-                            AddressSpaces, KAS);
-  TM.translate();
-  std::unique_ptr<bugle::Module> BM(TM.takeModule());
+  Pipe.translate();
+  bugle::Module *BM = Pipe.getModule();
+
+  std::unique_ptr<bugle::ModuleMemoryStats> TranslatedStats, SimplifiedStats;
+  if (bugle::Profiler::isEnabled())
+    TranslatedStats.reset(new bugle::ModuleMemoryStats(BM));
+
+  Pipe.transform();
 
-  bugle::simplifyStmt(BM.get());
+  if (HybridRep) {
+    bugle::ScopedPhase P("analyseIntegerRanges");
+    HybridRep->analyse(BM);
+  }
+
+  if (bugle::Profiler::isEnabled())
+    SimplifiedStats.reset(new bugle::ModuleMemoryStats(BM));
 
   std::string OutFile = OutputFilename;
   if (OutFile.empty()) {
@@ -292,9 +491,7 @@ int main(int argc, char **argv) {
   }
   std::unique_ptr<bugle::SourceLocWriter> SLW(new bugle::SourceLocWriter(L));
 
-  bugle::BPLModuleWriter MW(F.os(), BM.get(), IntRep.get(), RaceInstrumentation,
-                            SLW.get());
-  MW.write();
+  Pipe.write(F.os(), IntRep.get(), SLW.get());
 
   F.os().flush();
   F.keep();
@@ -304,5 +501,22 @@ int main(int argc, char **argv) {
     L->keep();
   }
 
+  if (bugle::Profiler::isEnabled()) {
+    bugle::Expr::reportAllocationCounts();
+    TranslatedStats->reportCounters("translate");
+    SimplifiedStats->reportCounters("simplifyStmt");
+    WriteProfile(ProfileOutput, bugle::Profiler::writeJSON);
+    WriteProfile(ProfileTrace, bugle::Profiler::writeTrace);
+  }
+
+  if (DumpMemoryStats) {
+    bugle::Expr::printAllocationStats(errs());
+    errs() << "Module after translation\n";
+    TranslatedStats->print(errs());
+    errs() << "Module after simplification\n";
+    SimplifiedStats->print(errs());
+    bugle::Profiler::printPhaseMemory(errs());
+  }
+
   return 0;
 }
@@ -0,0 +1,444 @@
+// Generates the special function tables included by TranslateFunction.cpp.
+//
+// For each source language the special functions are collected here, and a
+// perfect hash of their names is computed using the hash-and-displace method:
+// the names are divided into buckets by a first hash, and for each bucket,
+// largest first, a seed for a second hash is searched for which places all of
+// the names in the bucket into free slots of the table.
+
+#include "bugle/Translator/SpecialFunctionTable.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace bugle;
+
+namespace {
+
+// In the order of TranslateModule::SourceLanguage.
+enum Language { C, CUDA, OpenCL, NumLanguages };
+
+const char *const LanguageNames[NumLanguages] = {"C", "CUDA", "OpenCL"};
+
+struct Entry {
+  std::string Name;
+  SpecialFnKind Kind;
+  bool IsPrefix;
+  std::string Handler;
+};
+
+std::vector<std::string> Handlers;
+std::map<std::string, unsigned> HandlerIds;
+
+unsigned getHandlerId(const std::string &Handler) {
+  if (Handler.empty())
+    return NoSpecialFnHandler;
+  auto i = HandlerIds.find(Handler);
+  if (i != HandlerIds.end())
+    return i->second;
+  Handlers.push_back(Handler);
+  return HandlerIds[Handler] = Handlers.size() - 1;
+}
+
+class SpecialFunctionSet {
+  std::vector<Entry> Entries;
+  std::map<std::string, unsigned> Index;
+
+public:
+  const std::vector<Entry> &getEntries() const { return Entries; }
+
+  void add(const std::string &Name, const std::string &Handler) {
+    addEntry({Name, SFK_Function, false, Handler});
+  }
+
+  void addPrefix(const std::string &Prefix, SpecialFnKind Kind,
+                 const std::string &Handler = "") {
+    addEntry({Prefix, Kind, true, Handler});
+  }
+
+  void addEntry(const Entry &E) {
+    // As with a map, a later definition replaces an earlier one.
+    auto i = Index.find(E.Name);
+    if (i != Index.end()) {
+      Entries[i->second] = E;
+      return;
+    }
+    Index[E.Name] = Entries.size();
+    Entries.push_back(E);
+  }
+};
+
+void addCommonFunctions(SpecialFunctionSet &S) {
+  S.addPrefix("__axiom", SFK_Axiom);
+  S.addPrefix("__uninterpreted_function_", SFK_Uninterpreted,
+              "handleUninterpretedFunction");
+  S.addPrefix("__spec", SFK_Specification);
+  S.addPrefix("__requires_fresh_array.", SFK_FreshArray,
+              "handleRequiresFreshArray");
+
+  S.add("bugle_assert", "handleAssert");
+  S.add("__assert", "handleAssert");
+  S.add("__global_assert", "handleGlobalAssert");
+  S.add("__candidate_assert", "handleCandidateAssert");
+  S.add("__candidate_global_assert", "handleCandidateGlobalAssert");
+  S.add("__invariant", "handleInvariant");
+  S.add("__global_invariant", "handleGlobalInvariant");
+  S.add("__candidate_invariant", "handleCandidateInvariant");
+  S.add("__candidate_global_invariant", "handleCandidateGlobalInvariant");
+  S.add("__non_temporal_loads_begin", "handleNonTemporalLoadsBegin");
+  S.add("__non_temporal_loads_end", "handleNonTemporalLoadsEnd");
+  S.add("bugle_assume", "handleAssume");
+  S.add("__assert_fail", "handleAssertFail");
+  S.add("bugle_requires", "handleRequires");
+  S.add("__requires", "handleRequires");
+  S.add("__global_requires", "handleGlobalRequires");
+  S.add("__requires_fresh_array", "handleRequiresFreshArray");
+  S.add("bugle_ensures", "handleEnsures");
+  S.add("__ensures", "handleEnsures");
+  S.add("__global_ensures", "handleGlobalEnsures");
+  S.add("__function_wide_invariant", "handleFunctionWideInvariant");
+  S.add("__function_wide_candidate_invariant",
+        "handleFunctionWideCandidateInvariant");
+  S.add("__reads_from", "handleReadsFrom");
+  S.add("__reads_from_local", "handleReadsFrom");
+  S.add("__reads_from_global", "handleReadsFrom");
+  S.add("__writes_to", "handleWritesTo");
+  S.add("__writes_to_local", "handleWritesTo");
+  S.add("__writes_to_global", "handleWritesTo");
+  S.add("bugle_frexp_exp", "handleFrexpExp");
+  S.add("bugle_frexp_frac", "handleFrexpFrac");
+
+  const char *const Types[] = {"char", "short", "int", "long"};
+  for (auto *T : Types) {
+    S.add(std::string("__add_noovfl_") + T, "handleAddNoovflSigned");
+    S.add(std::string("__add_noovfl_unsigned_") + T,
+          "handleAddNoovflUnsigned");
+  }
+  S.add("__atomic_has_taken_value_local", "handleAtomicHasTakenValue");
+  S.add("__atomic_has_taken_value_global", "handleAtomicHasTakenValue");
+  S.add("__atomic_has_taken_value", "handleAtomicHasTakenValue");
+
+  const unsigned NOOVFL_PREDICATE_MAX_ARITY = 20;
+  for (auto *T : Types)
+    for (unsigned i = 0; i <= NOOVFL_PREDICATE_MAX_ARITY; ++i)
+      S.add(std::string("__add_noovfl_unsigned_") + T + "_" +
+                std::to_string(i),
+            "handleAddNoovflPredicate");
+
+  for (auto *T : Types) {
+    S.add(std::string("__add_") + T, "handleAdd");
+    S.add(std::string("__add_unsigned_") + T, "handleAdd");
+    S.add(std::string("__ite_") + T, "handleIte");
+    S.add(std::string("__ite_unsigned_") + T, "handleIte");
+  }
+  S.add("__ite_size_t", "handleIte");
+
+  S.add("__return_val_int", "handleReturnVal");
+  S.add("__return_val_int4", "handleReturnVal");
+  S.add("__return_val_bool", "handleReturnVal");
+  S.add("__return_val_ptr", "handleReturnVal");
+  S.add("__return_val_funptr", "handleReturnVal");
+  S.add("__old_int", "handleOld");
+  S.add("__old_bool", "handleOld");
+  S.add("__other_int", "handleOtherInt");
+  S.add("__other_bool", "handleOtherBool");
+  S.add("__other_ptr_base", "handleOtherPtrBase");
+  S.add("__implies", "handleImplies");
+  S.add("__enabled", "handleEnabled");
+  S.add("__dominator_enabled", "handleDominatorEnabled");
+
+  // Functions with local, global and unqualified variants.
+  const char *const Qualified[][2] = {
+      {"__read", "handleReadHasOccurred"},
+      {"__write", "handleWriteHasOccurred"},
+      {"__read_offset_bytes", "handleReadOffset"},
+      {"__write_offset_bytes", "handleWriteOffset"},
+      {"__ptr_base", "handlePtrBase"},
+      {"__ptr_offset_bytes", "handlePtrOffset"},
+      {"__array_snapshot", "handleArraySnapshot"}};
+  for (auto &Q : Qualified) {
+    S.add(std::string(Q[0]) + "_local", Q[1]);
+    S.add(std::string(Q[0]) + "_global", Q[1]);
+    S.add(Q[0], Q[1]);
+  }
+}
+
+void addAtomics(SpecialFunctionSet &S, const std::string &Name,
+                const std::vector<std::string> &Suffixes) {
+  for (auto &Suffix : Suffixes)
+    S.add(Name + Suffix, "handleAtomic");
+}
+
+void addOpenCLAtomics(SpecialFunctionSet &S) {
+  const std::vector<std::string> Integers = {
+      "_local_int",  "_local_uint",          "_global_int",
+      "_global_uint", "_local_long",         "_local_unsigned_long",
+      "_global_long", "_global_unsigned_long"};
+  std::vector<std::string> Xchg = Integers;
+  Xchg.insert(Xchg.begin() + 4, {"_local_float", "_global_float"});
+
+  const char *const Ops[] = {"add", "sub", "xchg", "min", "max", "and",
+                             "or",  "xor", "cmpxchg", "inc", "dec"};
+  for (auto *Op : Ops)
+    addAtomics(S, std::string("__bugle_atomic_") + Op,
+               std::string(Op) == "xchg" ? Xchg : Integers);
+}
+
+void addCUDAAtomics(SpecialFunctionSet &S) {
+  const std::vector<std::string> Integers = {"_int", "_unsigned_int",
+                                             "_unsigned_long_long_int"};
+  std::vector<std::string> WithFloat = Integers;
+  WithFloat.push_back("_float");
+
+  addAtomics(S, "__atomicAdd", WithFloat);
+  addAtomics(S, "__atomicSub", {"_int", "_unsigned_int"});
+  addAtomics(S, "__atomicExch", WithFloat);
+  addAtomics(S, "__atomicMin", Integers);
+  addAtomics(S, "__atomicMax", Integers);
+  addAtomics(S, "__atomicAnd", Integers);
+  addAtomics(S, "__atomicOr", Integers);
+  addAtomics(S, "__atomicXor", Integers);
+  addAtomics(S, "__atomicInc", {"_unsigned_int"});
+  addAtomics(S, "__atomicDec", {"_unsigned_int"});
+  addAtomics(S, "__atomicCAS", Integers);
+}
+
+void addBarrierInvariants(SpecialFunctionSet &S) {
+  const unsigned BARRIER_INVARIANT_MAX_ARITY = 20;
+  for (unsigned i = 0; i <= BARRIER_INVARIANT_MAX_ARITY; ++i)
+    S.add("__barrier_invariant_" + std::to_string(i),
+          "handleBarrierInvariant");
+  for (unsigned i = 0; i <= BARRIER_INVARIANT_MAX_ARITY; ++i)
+    S.add("__barrier_invariant_binary_" + std::to_string(i),
+          "handleBarrierInvariantBinary");
+}
+
+void addOpenCLFunctions(SpecialFunctionSet &S) {
+  S.add("get_local_id", "handleGetLocalId");
+  S.add("get_group_id", "handleGetGroupId");
+  S.add("get_local_size", "handleGetLocalSize");
+  S.add("get_num_groups", "handleGetNumGroups");
+  S.add("get_global_offset", "handleGetGlobalOffset");
+  S.add("get_work_dim", "handleGetWorkDim");
+  S.add("get_image_width", "handleGetImageWidth");
+  S.add("get_image_height", "handleGetImageHeight");
+  S.add("__translate_sampler_initializer", "handleSamplerInitializer");
+
+  const char *const Types[] = {"char", "uchar", "short", "ushort", "int",
+                               "uint", "long",  "ulong", "float",  "double"};
+  for (auto *T : Types) {
+    for (unsigned Width = 1; Width <= 16; Width *= 2) {
+      std::string Suffix = T;
+      if (Width > 1)
+        Suffix += std::to_string(Width);
+      S.add("__bugle_async_work_group_copy_global_to_local_" + Suffix,
+            "handleAsyncWorkGroupCopy");
+      S.add("__bugle_async_work_group_copy_local_to_global_" + Suffix,
+            "handleAsyncWorkGroupCopy");
+    }
+  }
+  S.add("__bugle_wait_group_events", "handleWaitGroupEvents");
+}
+
+void addCUDAFunctions(SpecialFunctionSet &S) {
+  S.add("cos", "handleCos");
+  S.add("sin", "handleSin");
+  S.add("sqrt", "handleSqrt");
+  S.add("sqrtf", "handleSqrt");
+  S.add("rsqrt", "handleRsqrt");
+  S.add("log2", "handleLog2");
+  S.add("exp2", "handleExp");
+  S.add("__clz", "handleCtlz");
+}
+
+SpecialFunctionSet getSpecialFunctions(Language L) {
+  SpecialFunctionSet S;
+  addCommonFunctions(S);
+  if (L == OpenCL || L == CUDA) {
+    if (L == OpenCL)
+      addOpenCLAtomics(S);
+    else
+      addCUDAAtomics(S);
+    addBarrierInvariants(S);
+  }
+  if (L == OpenCL)
+    addOpenCLFunctions(S);
+  if (L == CUDA)
+    addCUDAFunctions(S);
+  return S;
+}
+
+uint32_t nextPowerOf2(uint32_t N) {
+  uint32_t P = 1;
+  while (P < N)
+    P *= 2;
+  return P;
+}
+
+struct PerfectHash {
+  std::vector<int> Slots; // Index into the entries, or -1 if free.
+  std::vector<uint32_t> Displacements;
+};
+
+bool computePerfectHash(const std::vector<Entry> &Entries, PerfectHash &PH) {
+  uint32_t NumSlots = nextPowerOf2(Entries.size());
+  uint32_t NumBuckets = nextPowerOf2((Entries.size() + 1) / 2);
+
+  std::vector<std::vector<unsigned>> Buckets(NumBuckets);
+  for (unsigned i = 0; i != Entries.size(); ++i) {
+    const std::string &N = Entries[i].Name;
+    Buckets[hashSpecialFnName(N.data(), N.size(), 0) & (NumBuckets - 1)]
+        .push_back(i);
+  }
+
+  std::vector<unsigned> Order(NumBuckets);
+  for (unsigned i = 0; i != NumBuckets; ++i)
+    Order[i] = i;
+  std::stable_sort(Order.begin(), Order.end(), [&](unsigned A, unsigned B) {
+    return Buckets[A].size() > Buckets[B].size();
+  });
+
+  PH.Slots.assign(NumSlots, -1);
+  PH.Displacements.assign(NumBuckets, 0);
+  for (unsigned b : Order) {
+    if (Buckets[b].empty())
+      break;
+
+    bool Placed = false;
+    for (uint32_t D = 1; D != (1u << 24) && !Placed; ++D) {
+      std::vector<uint32_t> Chosen;
+      for (unsigned i : Buckets[b]) {
+        const std::string &N = Entries[i].Name;
+        uint32_t Slot =
+            hashSpecialFnName(N.data(), N.size(), D) & (NumSlots - 1);
+        if (PH.Slots[Slot] != -1 ||
+            std::find(Chosen.begin(), Chosen.end(), Slot) != Chosen.end())
+          break;
+        Chosen.push_back(Slot);
+      }
+      if (Chosen.size() != Buckets[b].size())
+        continue;
+
+      for (unsigned i = 0; i != Chosen.size(); ++i)
+        PH.Slots[Chosen[i]] = Buckets[b][i];
+      PH.Displacements[b] = D;
+      Placed = true;
+    }
+    if (!Placed)
+      return false;
+  }
+
+  return true;
+}
+
+const char *getKindName(SpecialFnKind K) {
+  switch (K) {
+  case SFK_None:          return "SFK_None";
+  case SFK_Function:      return "SFK_Function";
+  case SFK_Axiom:         return "SFK_Axiom";
+  case SFK_Uninterpreted: return "SFK_Uninterpreted";
+  case SFK_Specification: return "SFK_Specification";
+  case SFK_FreshArray:    return "SFK_FreshArray";
+  }
+  return "SFK_None";
+}
+
+bool emitTable(std::ostream &OS, Language L) {
+  SpecialFunctionSet S = getSpecialFunctions(L);
+  const std::vector<Entry> &Entries = S.getEntries();
+  PerfectHash PH;
+  if (!computePerfectHash(Entries, PH)) {
+    std::cerr << "Could not compute a perfect hash for the "
+              << LanguageNames[L] << " special functions\n";
+    return false;
+  }
+
+  std::string Prefix = LanguageNames[L];
+  OS << "static const SpecialFnEntry " << Prefix << "SpecialFnEntries[] = {\n";
+  for (int i : PH.Slots) {
+    if (i == -1) {
+      OS << "  {nullptr, 0, SFK_None, 0, NoSpecialFnHandler},\n";
+      continue;
+    }
+    const Entry &E = Entries[i];
+    OS << "  {\"" << E.Name << "\", " << E.Name.size() << ", "
+       << getKindName(E.Kind) << ", " << E.IsPrefix << ", "
+       << getHandlerId(E.Handler) << "},\n";
+  }
+  OS << "};\n\n";
+
+  OS << "static const uint32_t " << Prefix << "SpecialFnDisplacements[] = {";
+  for (unsigned i = 0; i != PH.Displacements.size(); ++i)
+    OS << (i % 8 == 0 ? "\n  " : " ") << PH.Displacements[i] << ",";
+  OS << "\n};\n\n";
+
+  std::set<unsigned, std::greater<unsigned>> PrefixLengths;
+  for (auto &E : Entries)
+    if (E.IsPrefix)
+      PrefixLengths.insert(E.Name.size());
+  OS << "static const uint8_t " << Prefix << "SpecialFnPrefixLengths[] = {";
+  for (auto i = PrefixLengths.begin(), e = PrefixLengths.end(); i != e; ++i)
+    OS << (i == PrefixLengths.begin() ? "" : ", ") << *i;
+  OS << "};\n\n";
+
+  return true;
+}
+}
+
+int main(int argc, char **argv) {
+  if (argc != 2) {
+    std::cerr << "Usage: " << argv[0] << " <output file>\n";
+    return 1;
+  }
+
+  std::ostringstream OS;
+  OS << "// Special function tables for TranslateFunction, generated by "
+        "bugle-specialfn-gen.\n// Do not edit.\n\n";
+  for (unsigned L = 0; L != NumLanguages; ++L)
+    if (!emitTable(OS, (Language)L))
+      return 1;
+
+  OS << "static const SpecialFnTable "
+        "SpecialFunctionTables[TranslateModule::SL_Count] = {\n";
+  for (unsigned L = 0; L != NumLanguages; ++L) {
+    std::string Prefix = LanguageNames[L];
+    OS << "  {" << Prefix << "SpecialFnEntries,\n"
+       << "   sizeof(" << Prefix << "SpecialFnEntries) / sizeof(SpecialFnEntry)"
+       << " - 1,\n"
+       << "   " << Prefix << "SpecialFnDisplacements,\n"
+       << "   sizeof(" << Prefix << "SpecialFnDisplacements) / sizeof(uint32_t)"
+       << " - 1,\n"
+       << "   " << Prefix << "SpecialFnPrefixLengths,\n"
+       << "   sizeof(" << Prefix << "SpecialFnPrefixLengths)},\n";
+  }
+  OS << "};\n\n";
+
+  OS << "TranslateFunction::SpecialFnHandler TranslateFunction::*const\n"
+        "    TranslateFunction::SpecialFnHandlers[] = {\n";
+  for (auto &H : Handlers)
+    OS << "  &TranslateFunction::" << H << ",\n";
+  OS << "};\n";
+
+  // Only replace the output if it has changed, to avoid needless rebuilds.
+  std::ifstream In(argv[1]);
+  std::stringstream Old;
+  Old << In.rdbuf();
+  if (In && Old.str() == OS.str())
+    return 0;
+  In.close();
+
+  std::ofstream Out(argv[1]);
+  Out << OS.str();
+  if (!Out) {
+    std::cerr << "Could not write " << argv[1] << "\n";
+    return 1;
+  }
+  return 0;
+}